@@ -0,0 +1,523 @@
+//-----------------------------------------------------------------------------
+//
+//	Main.cpp
+//
+//	Throughput and latency benchmark for OpenZWave.
+//
+//	Runs a simulated PC controller in a child process on a pseudo-terminal,
+//	points a Manager at the slave side, and measures how long it takes
+//	from Manager::SetValue to the matching ValueChanged notification.
+//
+//	SOFTWARE NOTICE AND LICENSE
+//
+//	This file is part of OpenZWave.
+//
+//	OpenZWave is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU Lesser General Public License as published
+//	by the Free Software Foundation, either version 3 of the License,
+//	or (at your option) any later version.
+//
+//	OpenZWave is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//	GNU Lesser General Public License for more details.
+//
+//	You should have received a copy of the GNU Lesser General Public License
+//	along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+
+#include <unistd.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <signal.h>
+#include <time.h>
+#include <pthread.h>
+#include <sys/wait.h>
+#include <algorithm>
+#include <map>
+#include <vector>
+#include "Options.h"
+#include "Manager.h"
+#include "Driver.h"
+#include "Notification.h"
+#include "value_classes/ValueID.h"
+#include "platform/Log.h"
+#include "Simulator.h"
+
+using namespace OpenZWave;
+
+// Each switch has at most one SetValue in flight.  Latency is measured
+// from just before Manager::SetValue to the ValueChanged notification.
+typedef struct
+{
+	ValueID*		m_valueId;
+	bool			m_state;
+	bool			m_busy;
+	uint64			m_start;
+	bool			m_reported;		// State in the last ValueChanged notification
+	uint32			m_changes;		// ValueChanged notifications seen by CheckBursts
+}SwitchInfo;
+
+static map<uint8,SwitchInfo> g_switches;
+static vector<uint32> g_latencies;
+static uint32 g_homeId = 0;
+static bool g_initDone = false;
+static bool g_initFailed = false;
+
+static pthread_mutex_t g_criticalSection = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t  g_cond = PTHREAD_COND_INITIALIZER;
+
+// COMMAND_CLASS_SWITCH_BINARY
+static uint8 const c_switchBinaryClass = 0x25;
+
+//-----------------------------------------------------------------------------
+// <NowMicroseconds>
+// Monotonic clock for latency measurement
+//-----------------------------------------------------------------------------
+static uint64 NowMicroseconds
+(
+)
+{
+	struct timespec ts;
+	clock_gettime( CLOCK_MONOTONIC, &ts );
+	return ( (uint64)ts.tv_sec * 1000000 ) + ( ts.tv_nsec / 1000 );
+}
+
+//-----------------------------------------------------------------------------
+// <OnNotification>
+// Track the switch values and time their changes
+//-----------------------------------------------------------------------------
+void OnNotification
+(
+	Notification const* _notification,
+	void* _context
+)
+{
+	pthread_mutex_lock( &g_criticalSection );
+
+	switch( _notification->GetType() )
+	{
+		case Notification::Type_ValueAdded:
+		{
+			ValueID const& valueId = _notification->GetValueID();
+			if( valueId.GetCommandClassId() == c_switchBinaryClass && valueId.GetInstance() == 1 && valueId.GetIndex() == 0 )
+			{
+				SwitchInfo& info = g_switches[valueId.GetNodeId()];
+				delete info.m_valueId;
+				info.m_valueId = new ValueID( valueId );
+				info.m_state = false;
+				info.m_busy = false;
+				info.m_start = 0;
+				info.m_reported = false;
+				info.m_changes = 0;
+			}
+			break;
+		}
+
+		case Notification::Type_ValueChanged:
+		{
+			ValueID const& valueId = _notification->GetValueID();
+			map<uint8,SwitchInfo>::iterator it = g_switches.find( valueId.GetNodeId() );
+			if( it != g_switches.end() && valueId.GetCommandClassId() == c_switchBinaryClass )
+			{
+				Manager::Get()->GetValueAsBool( valueId, &it->second.m_reported );
+				++it->second.m_changes;
+				if( it->second.m_busy )
+				{
+					g_latencies.push_back( (uint32)( NowMicroseconds() - it->second.m_start ) );
+					it->second.m_busy = false;
+				}
+				pthread_cond_broadcast( &g_cond );
+			}
+			break;
+		}
+
+		case Notification::Type_DriverReady:
+		{
+			g_homeId = _notification->GetHomeId();
+			break;
+		}
+
+		case Notification::Type_DriverFailed:
+		{
+			g_initFailed = true;
+			pthread_cond_broadcast( &g_cond );
+			break;
+		}
+
+		case Notification::Type_AwakeNodesQueried:
+		case Notification::Type_AllNodesQueried:
+		case Notification::Type_AllNodesQueriedSomeDead:
+		{
+			g_initDone = true;
+			pthread_cond_broadcast( &g_cond );
+			break;
+		}
+
+		default:
+		{
+		}
+	}
+
+	pthread_mutex_unlock( &g_criticalSection );
+}
+
+//-----------------------------------------------------------------------------
+// <WaitOnCondition>
+// Wait on g_cond for at most _ms milliseconds.  Caller holds the mutex.
+//-----------------------------------------------------------------------------
+static void WaitOnCondition
+(
+	uint32 _ms
+)
+{
+	struct timespec ts;
+	clock_gettime( CLOCK_REALTIME, &ts );
+	ts.tv_sec += _ms / 1000;
+	ts.tv_nsec += ( _ms % 1000 ) * 1000000;
+	if( ts.tv_nsec >= 1000000000 )
+	{
+		ts.tv_sec++;
+		ts.tv_nsec -= 1000000000;
+	}
+	pthread_cond_timedwait( &g_cond, &g_criticalSection, &ts );
+}
+
+//-----------------------------------------------------------------------------
+// <Percentile>
+// Value at _p percent through a sorted sample
+//-----------------------------------------------------------------------------
+static double Percentile
+(
+	vector<uint32> const& _sorted,
+	uint32 _p
+)
+{
+	if( _sorted.empty() )
+	{
+		return 0.0;
+	}
+	size_t index = ( ( _sorted.size() - 1 ) * _p + 50 ) / 100;
+	return _sorted[index] / 1000.0;
+}
+
+//-----------------------------------------------------------------------------
+// <CheckBursts>
+// Change each switch in turn, then while that Set is on its way send _count
+// more changes at once, as a slider drag would, ending in the starting
+// state.  Coalescing must keep a Get behind the last queued Set, or the only
+// report is the one for the first Set.  Returns true if every switch reports
+// the first change and then the return to its starting state.
+//-----------------------------------------------------------------------------
+static bool CheckBursts
+(
+	uint32 _count,
+	uint32 _timeout
+)
+{
+	vector<ValueID> ids;
+	pthread_mutex_lock( &g_criticalSection );
+	for( map<uint8,SwitchInfo>::iterator it = g_switches.begin(); it != g_switches.end(); ++it )
+	{
+		ids.push_back( *it->second.m_valueId );
+	}
+	pthread_mutex_unlock( &g_criticalSection );
+
+	uint32 matched = 0;
+	for( size_t i=0; i<ids.size(); ++i )
+	{
+		pthread_mutex_lock( &g_criticalSection );
+		SwitchInfo& info = g_switches[ids[i].GetNodeId()];
+		bool state = info.m_reported;
+		info.m_changes = 0;
+		pthread_mutex_unlock( &g_criticalSection );
+
+		// The driver is otherwise idle, so the first Set goes straight out
+		// and the rest queue up behind it
+		Manager::Get()->SetValue( ids[i], !state );
+		usleep( 5000 );
+		for( uint32 j=0; j<_count; ++j )
+		{
+			Manager::Get()->SetValue( ids[i], ( ( _count - j ) % 2 ) == 1 ? state : !state );
+		}
+
+		uint64 begin = NowMicroseconds();
+		pthread_mutex_lock( &g_criticalSection );
+		while( !( info.m_changes >= 2 && info.m_reported == state ) && ( NowMicroseconds() - begin ) <= (uint64)_timeout * 1000 )
+		{
+			WaitOnCondition( 100 );
+		}
+		if( info.m_changes >= 2 && info.m_reported == state )
+		{
+			++matched;
+		}
+		pthread_mutex_unlock( &g_criticalSection );
+	}
+
+	printf( "Bursts of %d SetValue calls: %d of %d switches reported the last state\n", _count + 1, matched, (int)ids.size() );
+	return( matched == ids.size() );
+}
+
+//-----------------------------------------------------------------------------
+// <Usage>
+// Print the command line options
+//-----------------------------------------------------------------------------
+static void Usage
+(
+	char const* _name
+)
+{
+	printf( "Usage: %s [options]\n", _name );
+	printf( "  -n <count>    virtual binary switches (default 10)\n" );
+	printf( "  -s <count>    sleeping binary sensors (default 0)\n" );
+	printf( "  -l <ms>       radio latency per transmission (default 20)\n" );
+	printf( "  -j <ms>       extra random latency up to this much (default 0)\n" );
+	printf( "  -p <percent>  transmissions lost (default 0)\n" );
+	printf( "  -w <ms>       sleeping node wake-up interval (default 10000)\n" );
+	printf( "  -c <count>    SetValue operations to time (default 1000)\n" );
+	printf( "  -t <ms>       give up on an operation after this long (default 10000)\n" );
+	printf( "  -r <ms>       OpenZWave RetryTimeout, for runs with loss (default library's)\n" );
+	printf( "  -C <path>     OpenZWave config directory (default ../../../config/)\n" );
+	printf( "  -m            send each batch of switch changes with SetValueMulticast\n" );
+	printf( "  -k            enable the CoalesceSetCommands option\n" );
+	printf( "  -b <count>    afterwards, send each switch this many SetValue calls at once\n" );
+	printf( "                and check it reports the last state (default 0, no check)\n" );
+	printf( "  -S            only run the simulator, and print its port\n" );
+	printf( "  -v            enable OpenZWave logging\n" );
+}
+
+//-----------------------------------------------------------------------------
+// <main>
+// Start the simulator, bring up a driver on it and time SetValue calls
+//-----------------------------------------------------------------------------
+int main( int argc, char* argv[] )
+{
+	SimulatorOptions options;
+	uint32 count = 1000;
+	uint32 opTimeout = 10000;
+	uint32 retryTimeout = 0;
+	string configPath = "../../../config/";
+	bool simulatorOnly = false;
+	bool multicast = false;
+	bool coalesce = false;
+	uint32 burst = 0;
+	bool verbose = false;
+
+	int opt;
+	while( ( opt = getopt( argc, argv, "n:s:l:j:p:w:c:t:r:C:mkb:Svh" ) ) != -1 )
+	{
+		switch( opt )
+		{
+			case 'n':	options.m_numNodes = atoi( optarg );		break;
+			case 's':	options.m_numSleeping = atoi( optarg );		break;
+			case 'l':	options.m_latency = atoi( optarg );			break;
+			case 'j':	options.m_jitter = atoi( optarg );			break;
+			case 'p':	options.m_lossPercent = atoi( optarg );		break;
+			case 'w':	options.m_wakeInterval = atoi( optarg );	break;
+			case 'c':	count = atoi( optarg );						break;
+			case 't':	opTimeout = atoi( optarg );					break;
+			case 'r':	retryTimeout = atoi( optarg );				break;
+			case 'C':	configPath = optarg;						break;
+			case 'm':	multicast = true;							break;
+			case 'k':	coalesce = true;							break;
+			case 'b':	burst = atoi( optarg );						break;
+			case 'S':	simulatorOnly = true;						break;
+			case 'v':	verbose = true;								break;
+			default:	Usage( argv[0] );							return 1;
+		}
+	}
+
+	Simulator simulator( options );
+	char const* port = simulator.Open();
+	if( port == NULL )
+	{
+		perror( "Unable to create a pseudo-terminal" );
+		return 1;
+	}
+
+	if( simulatorOnly )
+	{
+		printf( "Simulated controller on %s\n", port );
+		fflush( stdout );
+		simulator.Run( -1 );
+		return 0;
+	}
+
+	// The simulator runs in its own process so its work doesn't skew the
+	// timings.  It stops when the write end of exitPipe closes, which also
+	// happens if we die.
+	int exitPipe[2];
+	if( pipe( exitPipe ) != 0 )
+	{
+		perror( "pipe" );
+		return 1;
+	}
+
+	pid_t child = fork();
+	if( child < 0 )
+	{
+		perror( "fork" );
+		return 1;
+	}
+	if( child == 0 )
+	{
+		close( exitPipe[1] );
+		simulator.Run( exitPipe[0] );
+		_exit( 0 );
+	}
+	close( exitPipe[0] );
+	string portName = port;
+	simulator.Detach();
+
+	printf( "Benchmarking OpenZWave %s: %d switches, %d sleeping, %dms latency (+%dms jitter), %d%% loss\n",
+		Manager::getVersionAsString().c_str(), options.m_numNodes, options.m_numSleeping, options.m_latency, options.m_jitter, options.m_lossPercent );
+
+	// Passed as a command line so they win over the config's options.xml.
+	// Nothing is saved, so every run queries the network from scratch.
+	string commandLine = "--SaveConfiguration false --Logging ";
+	commandLine += verbose ? "true" : "false";
+	if( coalesce )
+	{
+		commandLine += " --CoalesceSetCommands true";
+	}
+	if( retryTimeout )
+	{
+		char str[32];
+		snprintf( str, sizeof(str), " --RetryTimeout %d", retryTimeout );
+		commandLine += str;
+	}
+	Options::Create( configPath, "", commandLine );
+	Options::Get()->Lock();
+
+	Manager::Create();
+	Manager::Get()->AddWatcher( OnNotification, NULL );
+
+	uint64 initStart = NowMicroseconds();
+	Manager::Get()->AddDriver( portName );
+
+	pthread_mutex_lock( &g_criticalSection );
+	while( !g_initDone && !g_initFailed )
+	{
+		WaitOnCondition( 1000 );
+	}
+	bool failed = g_initFailed;
+	pthread_mutex_unlock( &g_criticalSection );
+
+	if( failed )
+	{
+		printf( "Driver failed to start\n" );
+	}
+	else
+	{
+		printf( "Network queried in %.1fms, %d switch values found\n", ( NowMicroseconds() - initStart ) / 1000.0, (int)g_switches.size() );
+
+		Driver::DriverData before;
+		Manager::Get()->GetDriverStatistics( g_homeId, &before );
+
+		uint32 issued = 0;
+		uint32 timeouts = 0;
+		uint64 start = NowMicroseconds();
+		vector<pair<ValueID,bool> > toSend;
+
+		pthread_mutex_lock( &g_criticalSection );
+		while( !g_switches.empty() )
+		{
+			// Give every idle switch its next operation, and write off any
+			// that have been outstanding too long
+			uint64 now = NowMicroseconds();
+			uint32 busy = 0;
+			for( map<uint8,SwitchInfo>::iterator it = g_switches.begin(); it != g_switches.end(); ++it )
+			{
+				SwitchInfo& info = it->second;
+				if( info.m_busy && ( now - info.m_start ) > (uint64)opTimeout * 1000 )
+				{
+					info.m_busy = false;
+					++timeouts;
+				}
+				if( !info.m_busy && issued < count )
+				{
+					info.m_state = !info.m_state;
+					info.m_busy = true;
+					info.m_start = now;
+					toSend.push_back( pair<ValueID,bool>( *info.m_valueId, info.m_state ) );
+					++issued;
+				}
+				if( info.m_busy )
+				{
+					++busy;
+				}
+			}
+
+			if( busy == 0 && issued >= count )
+			{
+				break;
+			}
+
+			// SetValue takes the driver's node locks, so it must not be
+			// called while we hold the lock our notification handler needs.
+			if( !toSend.empty() )
+			{
+				pthread_mutex_unlock( &g_criticalSection );
+				if( multicast )
+				{
+					vector<ValueID> ids[2];
+					for( size_t i=0; i<toSend.size(); ++i )
+					{
+						ids[toSend[i].second ? 1 : 0].push_back( toSend[i].first );
+					}
+					Manager::Get()->SetValueMulticast( ids[0], false );
+					Manager::Get()->SetValueMulticast( ids[1], true );
+				}
+				else
+				{
+					for( size_t i=0; i<toSend.size(); ++i )
+					{
+						Manager::Get()->SetValue( toSend[i].first, toSend[i].second );
+					}
+				}
+				toSend.clear();
+				pthread_mutex_lock( &g_criticalSection );
+				continue;
+			}
+
+			WaitOnCondition( 100 );
+		}
+		uint64 elapsed = NowMicroseconds() - start;
+		vector<uint32> latencies = g_latencies;
+		pthread_mutex_unlock( &g_criticalSection );
+
+		Driver::DriverData after;
+		Manager::Get()->GetDriverStatistics( g_homeId, &after );
+
+		sort( latencies.begin(), latencies.end() );
+		double seconds = elapsed / 1000000.0;
+		uint32 frames = ( after.m_readCnt - before.m_readCnt ) + ( after.m_writeCnt - before.m_writeCnt );
+
+		printf( "Completed %d of %d SetValue calls in %.2fs (%d timed out)\n", (int)latencies.size(), issued, seconds, timeouts );
+		printf( "  Latency p50 %.2fms  p99 %.2fms  max %.2fms\n", Percentile( latencies, 50 ), Percentile( latencies, 99 ), latencies.empty() ? 0.0 : latencies.back() / 1000.0 );
+		printf( "  Throughput %.1f SetValue/s, %.1f msgs/s (%d frames)\n", latencies.size() / seconds, frames / seconds, frames );
+		printf( "  Retries %d  Dropped %d  NAK %d  CAN %d  Bad checksums %d\n",
+			after.m_retries - before.m_retries, after.m_dropped - before.m_dropped, after.m_NAKCnt - before.m_NAKCnt, after.m_CANCnt - before.m_CANCnt, after.m_badChecksum - before.m_badChecksum );
+
+		if( burst && !CheckBursts( burst, opTimeout ) )
+		{
+			failed = true;
+		}
+	}
+
+	Manager::Get()->RemoveDriver( portName );
+	Manager::Get()->RemoveWatcher( OnNotification, NULL );
+	Manager::Destroy();
+	Options::Destroy();
+
+	for( map<uint8,SwitchInfo>::iterator it = g_switches.begin(); it != g_switches.end(); ++it )
+	{
+		delete it->second.m_valueId;
+	}
+
+	close( exitPipe[1] );
+	waitpid( child, NULL, 0 );
+	return failed ? 1 : 0;
+}
@@ -0,0 +1,842 @@
+//-----------------------------------------------------------------------------
+//
+//	Simulator.cpp
+//
+//	Simulated Z-Wave Serial API controller for benchmarking OpenZWave
+//
+//	SOFTWARE NOTICE AND LICENSE
+//
+//	This file is part of OpenZWave.
+//
+//	OpenZWave is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU Lesser General Public License as published
+//	by the Free Software Foundation, either version 3 of the License,
+//	or (at your option) any later version.
+//
+//	OpenZWave is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//	GNU Lesser General Public License for more details.
+//
+//	You should have received a copy of the GNU Lesser General Public License
+//	along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+
+#include <fcntl.h>
+#include <poll.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+#include <errno.h>
+#include "Simulator.h"
+
+using namespace std;
+
+// Command classes the virtual nodes implement
+static uint8 const c_basicClass			= 0x20;
+static uint8 const c_switchBinaryClass	= 0x25;
+static uint8 const c_switchAllClass		= 0x27;
+static uint8 const c_sensorBinaryClass	= 0x30;
+static uint8 const c_wakeUpClass		= 0x84;
+
+// How long a sleeping node stays awake if the controller never sends it
+// WakeUp No More Information
+static uint32 const c_awakeTimeout		= 10000;
+
+// Serial API functions we answer, advertised in the capabilities mask
+static uint8 const c_supported[] =
+{
+	FUNC_ID_SERIAL_API_GET_INIT_DATA,
+	FUNC_ID_SERIAL_API_APPL_NODE_INFORMATION,
+	FUNC_ID_APPLICATION_COMMAND_HANDLER,
+	FUNC_ID_ZW_GET_CONTROLLER_CAPABILITIES,
+	FUNC_ID_SERIAL_API_SET_TIMEOUTS,
+	FUNC_ID_SERIAL_API_GET_CAPABILITIES,
+	FUNC_ID_ZW_SEND_DATA,
+	FUNC_ID_ZW_SEND_DATA_MULTI,
+	FUNC_ID_ZW_GET_VERSION,
+	FUNC_ID_ZW_MEMORY_GET_ID,
+	FUNC_ID_ZW_GET_NODE_PROTOCOL_INFO,
+	FUNC_ID_ZW_APPLICATION_UPDATE,
+	FUNC_ID_ZW_GET_SUC_NODE_ID,
+	FUNC_ID_ZW_REQUEST_NODE_INFO,
+	FUNC_ID_ZW_GET_ROUTING_INFO
+};
+
+//-----------------------------------------------------------------------------
+// <Simulator::Simulator>
+// Constructor
+//-----------------------------------------------------------------------------
+Simulator::Simulator
+(
+	SimulatorOptions const& _options
+):
+	m_options( _options ),
+	m_master( -1 ),
+	m_slave( -1 ),
+	m_rxLength( 0 )
+{
+	m_slaveName[0] = 0;
+
+	// Node 1 is ourselves.  Everything else is 2 upwards, switches first.
+	uint32 count = m_options.m_numNodes + m_options.m_numSleeping;
+	if( count > 231 )
+	{
+		count = 231;
+	}
+
+	for( uint32 i=0; i<count; ++i )
+	{
+		VirtualNode& node = m_nodes[(uint8)(i+2)];
+		node.m_listening = ( i < m_options.m_numNodes );
+		node.m_awake = node.m_listening;
+		node.m_wakeInterval = m_options.m_wakeInterval / 1000;
+		node.m_nextWake = 0;
+		node.m_sleepAt = 0;
+		if( node.m_listening )
+		{
+			node.m_generic = 0x10;		// Binary Switch
+			node.m_specific = 0x01;		// Binary Power Switch
+			node.m_commandClasses.push_back( c_switchBinaryClass );
+			node.m_commandClasses.push_back( c_switchAllClass );
+			node.m_values[c_switchBinaryClass] = 0x00;
+			node.m_values[c_switchAllClass] = 0xff;
+		}
+		else
+		{
+			node.m_generic = 0x20;		// Binary Sensor
+			node.m_specific = 0x01;		// Routing Binary Sensor
+			node.m_commandClasses.push_back( c_sensorBinaryClass );
+			node.m_commandClasses.push_back( c_wakeUpClass );
+			node.m_values[c_sensorBinaryClass] = 0x00;
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------
+// <Simulator::~Simulator>
+// Destructor
+//-----------------------------------------------------------------------------
+Simulator::~Simulator
+(
+)
+{
+	Detach();
+}
+
+//-----------------------------------------------------------------------------
+// <Simulator::Open>
+// Create the pseudo-terminal
+//-----------------------------------------------------------------------------
+char const* Simulator::Open
+(
+)
+{
+	m_master = posix_openpt( O_RDWR | O_NOCTTY );
+	if( m_master < 0 || grantpt( m_master ) != 0 || unlockpt( m_master ) != 0 )
+	{
+		return NULL;
+	}
+
+	char const* name = ptsname( m_master );
+	if( name == NULL )
+	{
+		return NULL;
+	}
+	snprintf( m_slaveName, sizeof(m_slaveName), "%s", name );
+
+	m_slave = open( m_slaveName, O_RDWR | O_NOCTTY );
+	if( m_slave < 0 )
+	{
+		return NULL;
+	}
+
+	// OpenZWave sets the same modes when it opens the port, but the line
+	// discipline must not touch anything written before it gets there.
+	struct termios tios;
+	tcgetattr( m_slave, &tios );
+	cfmakeraw( &tios );
+	tcsetattr( m_slave, TCSANOW, &tios );
+
+	uint64 now = Now();
+	for( map<uint8,VirtualNode>::iterator it = m_nodes.begin(); it != m_nodes.end(); ++it )
+	{
+		it->second.m_nextWake = now + m_options.m_wakeInterval;
+	}
+	return m_slaveName;
+}
+
+//-----------------------------------------------------------------------------
+// <Simulator::Detach>
+// Close our ends of the pseudo-terminal
+//-----------------------------------------------------------------------------
+void Simulator::Detach
+(
+)
+{
+	if( m_slave >= 0 )
+	{
+		close( m_slave );
+		m_slave = -1;
+	}
+	if( m_master >= 0 )
+	{
+		close( m_master );
+		m_master = -1;
+	}
+}
+
+//-----------------------------------------------------------------------------
+// <Simulator::Run>
+// Serve frames until told to stop
+//-----------------------------------------------------------------------------
+void Simulator::Run
+(
+	int _exitFd
+)
+{
+	while( true )
+	{
+		// Sleep until the next queued frame is due, or the next node wakes
+		uint64 now = Now();
+		uint64 next = now + 1000;
+		if( !m_pending.empty() && m_pending.begin()->first < next )
+		{
+			next = m_pending.begin()->first;
+		}
+		for( map<uint8,VirtualNode>::iterator it = m_nodes.begin(); it != m_nodes.end(); ++it )
+		{
+			VirtualNode const& node = it->second;
+			if( !node.m_listening )
+			{
+				uint64 due = node.m_awake ? node.m_sleepAt : node.m_nextWake;
+				if( due < next )
+				{
+					next = due;
+				}
+			}
+		}
+
+		struct pollfd fds[2];
+		fds[0].fd = m_master;
+		fds[0].events = POLLIN;
+		fds[0].revents = 0;
+		fds[1].fd = _exitFd;
+		fds[1].events = POLLIN;
+		fds[1].revents = 0;
+
+		int timeout = ( next > now ) ? (int)( next - now ) : 0;
+		if( poll( fds, 2, timeout ) < 0 && errno != EINTR )
+		{
+			perror( "poll" );
+			return;
+		}
+
+		if( fds[1].revents )
+		{
+			// Data or hangup on the exit descriptor
+			return;
+		}
+
+		if( fds[0].revents & POLLIN )
+		{
+			ReadFromHost();
+		}
+		else if( fds[0].revents & ( POLLERR | POLLHUP ) )
+		{
+			// Nobody has the slave open.  Should not happen while we hold
+			// it ourselves, but don't spin if it does.
+			usleep( 10000 );
+		}
+
+		WakeNodes();
+		Flush();
+	}
+}
+
+//-----------------------------------------------------------------------------
+// <Simulator::Now>
+// Monotonic milliseconds
+//-----------------------------------------------------------------------------
+uint64 Simulator::Now
+(
+)const
+{
+	struct timespec ts;
+	clock_gettime( CLOCK_MONOTONIC, &ts );
+	return ( (uint64)ts.tv_sec * 1000 ) + ( ts.tv_nsec / 1000000 );
+}
+
+//-----------------------------------------------------------------------------
+// <Simulator::Delay>
+// Radio latency for one transmission
+//-----------------------------------------------------------------------------
+uint32 Simulator::Delay
+(
+)
+{
+	uint32 delay = m_options.m_latency;
+	if( m_options.m_jitter )
+	{
+		delay += (uint32)rand() % ( m_options.m_jitter + 1 );
+	}
+	return delay;
+}
+
+//-----------------------------------------------------------------------------
+// <Simulator::ReadFromHost>
+// Pull bytes from the pty and split them into frames
+//-----------------------------------------------------------------------------
+void Simulator::ReadFromHost
+(
+)
+{
+	ssize_t count = read( m_master, &m_rxBuffer[m_rxLength], sizeof(m_rxBuffer) - m_rxLength );
+	if( count <= 0 )
+	{
+		return;
+	}
+	m_rxLength += (uint32)count;
+
+	uint32 pos = 0;
+	while( pos < m_rxLength )
+	{
+		uint8 const* frame = &m_rxBuffer[pos];
+		uint32 available = m_rxLength - pos;
+
+		if( frame[0] != SOF )
+		{
+			// ACK, NAK and CAN from the host need nothing from us, and
+			// anything else is noise between frames.
+			++pos;
+			continue;
+		}
+
+		if( available < 2 || available < (uint32)frame[1] + 2 )
+		{
+			// Wait for the rest of the frame
+			break;
+		}
+
+		uint8 length = frame[1];
+		uint8 checksum = 0xff;
+		for( uint32 i=1; i<=length; ++i )
+		{
+			checksum ^= frame[i];
+		}
+
+		uint8 const reply = ( checksum == frame[length+1] && length >= 3 ) ? ACK : NAK;
+		WriteBytes( &reply, 1 );
+		if( reply == ACK )
+		{
+			HandleFrame( &frame[2], length - 1 );
+		}
+		pos += length + 2;
+	}
+
+	// Keep any partial frame for the next read
+	memmove( m_rxBuffer, &m_rxBuffer[pos], m_rxLength - pos );
+	m_rxLength -= pos;
+	if( m_rxLength == sizeof(m_rxBuffer) )
+	{
+		m_rxLength = 0;
+	}
+}
+
+//-----------------------------------------------------------------------------
+// <Simulator::HandleFrame>
+// Answer one request from the host.  _frame starts at the type byte and
+// excludes the checksum.
+//-----------------------------------------------------------------------------
+void Simulator::HandleFrame
+(
+	uint8 const* _frame,
+	uint32 _length
+)
+{
+	if( _frame[0] != REQUEST )
+	{
+		return;
+	}
+
+	uint8 const function = _frame[1];
+	uint8 const* data = &_frame[2];
+	uint32 const length = _length - 2;
+	uint8 reply[64];
+
+	switch( function )
+	{
+		case FUNC_ID_ZW_GET_VERSION:
+		{
+			char const version[] = "Z-Wave 3.28";
+			memcpy( reply, version, sizeof(version) );
+			reply[sizeof(version)] = 0x01;				// Static controller library
+			SendResponse( function, reply, sizeof(version) + 1 );
+			break;
+		}
+		case FUNC_ID_ZW_MEMORY_GET_ID:
+		{
+			reply[0] = (uint8)( m_options.m_homeId >> 24 );
+			reply[1] = (uint8)( m_options.m_homeId >> 16 );
+			reply[2] = (uint8)( m_options.m_homeId >> 8 );
+			reply[3] = (uint8)( m_options.m_homeId );
+			reply[4] = 0x01;
+			SendResponse( function, reply, 5 );
+			break;
+		}
+		case FUNC_ID_ZW_GET_CONTROLLER_CAPABILITIES:
+		{
+			reply[0] = 0x1c;							// SIS, real primary, SUC
+			SendResponse( function, reply, 1 );
+			break;
+		}
+		case FUNC_ID_SERIAL_API_GET_CAPABILITIES:
+		{
+			uint8 const ident[] = { 0x01, 0x00, 0x00, 0x86, 0x00, 0x01, 0x00, 0x5a };
+			memcpy( reply, ident, sizeof(ident) );
+			memset( &reply[8], 0, 32 );
+			for( uint32 i=0; i<sizeof(c_supported); ++i )
+			{
+				uint8 bit = c_supported[i] - 1;
+				reply[8 + (bit>>3)] |= (uint8)( 1 << ( bit & 7 ) );
+			}
+			SendResponse( function, reply, 40 );
+			break;
+		}
+		case FUNC_ID_ZW_GET_SUC_NODE_ID:
+		{
+			reply[0] = 0x01;
+			SendResponse( function, reply, 1 );
+			break;
+		}
+		case FUNC_ID_SERIAL_API_SET_TIMEOUTS:
+		{
+			reply[0] = ( length > 0 ) ? data[0] : 0;
+			reply[1] = ( length > 1 ) ? data[1] : 0;
+			SendResponse( function, reply, 2 );
+			break;
+		}
+		case FUNC_ID_SERIAL_API_GET_INIT_DATA:
+		{
+			reply[0] = 0x05;							// Serial API version
+			reply[1] = 0x08;							// SIS
+			reply[2] = NUM_NODE_BITFIELD_BYTES;
+			memset( &reply[3], 0, NUM_NODE_BITFIELD_BYTES );
+			reply[3] = 0x01;
+			for( map<uint8,VirtualNode>::iterator it = m_nodes.begin(); it != m_nodes.end(); ++it )
+			{
+				uint8 bit = it->first - 1;
+				reply[3 + (bit>>3)] |= (uint8)( 1 << ( bit & 7 ) );
+			}
+			reply[3+NUM_NODE_BITFIELD_BYTES] = 0x03;	// Chip type and version
+			reply[4+NUM_NODE_BITFIELD_BYTES] = 0x01;
+			SendResponse( function, reply, 5 + NUM_NODE_BITFIELD_BYTES );
+			break;
+		}
+		case FUNC_ID_ZW_GET_NODE_PROTOCOL_INFO:
+		{
+			memset( reply, 0, 6 );
+			uint8 nodeId = ( length > 0 ) ? data[0] : 0;
+			if( nodeId == 1 )
+			{
+				uint8 const info[] = { 0xd3, 0x16, 0x00, 0x02, 0x02, 0x01 };
+				memcpy( reply, info, sizeof(info) );
+			}
+			else
+			{
+				map<uint8,VirtualNode>::iterator it = m_nodes.find( nodeId );
+				if( it != m_nodes.end() )
+				{
+					VirtualNode const& node = it->second;
+					reply[0] = node.m_listening ? 0xd3 : 0x53;
+					reply[1] = node.m_listening ? 0x1c : 0x0c;
+					reply[3] = 0x04;					// Routing slave
+					reply[4] = node.m_generic;
+					reply[5] = node.m_specific;
+				}
+			}
+			SendResponse( function, reply, 6 );
+			break;
+		}
+		case FUNC_ID_ZW_REQUEST_NODE_INFO:
+		{
+			reply[0] = 0x01;
+			SendResponse( function, reply, 1 );
+
+			uint8 nodeId = ( length > 0 ) ? data[0] : 0;
+			map<uint8,VirtualNode>::iterator it = m_nodes.find( nodeId );
+			if( it != m_nodes.end() && it->second.m_awake )
+			{
+				VirtualNode const& node = it->second;
+				uint32 count = (uint32)node.m_commandClasses.size();
+				reply[0] = UPDATE_STATE_NODE_INFO_RECEIVED;
+				reply[1] = nodeId;
+				reply[2] = (uint8)( 3 + count );
+				reply[3] = 0x04;
+				reply[4] = node.m_generic;
+				reply[5] = node.m_specific;
+				memcpy( &reply[6], &node.m_commandClasses[0], count );
+				Queue( Now() + Delay(), REQUEST, FUNC_ID_ZW_APPLICATION_UPDATE, reply, 6 + count );
+			}
+			else
+			{
+				reply[0] = UPDATE_STATE_NODE_INFO_REQ_FAILED;
+				reply[1] = 0;
+				reply[2] = 0;
+				Queue( Now() + Delay(), REQUEST, FUNC_ID_ZW_APPLICATION_UPDATE, reply, 3 );
+			}
+			break;
+		}
+		case FUNC_ID_ZW_GET_ROUTING_INFO:
+		{
+			// Everybody can hear everybody else
+			uint8 nodeId = ( length > 0 ) ? data[0] : 0;
+			memset( reply, 0, NUM_NODE_BITFIELD_BYTES );
+			reply[0] = 0x01;
+			for( map<uint8,VirtualNode>::iterator it = m_nodes.begin(); it != m_nodes.end(); ++it )
+			{
+				uint8 bit = it->first - 1;
+				reply[bit>>3] |= (uint8)( 1 << ( bit & 7 ) );
+			}
+			if( nodeId > 0 )
+			{
+				uint8 bit = nodeId - 1;
+				reply[bit>>3] &= (uint8)~( 1 << ( bit & 7 ) );
+			}
+			SendResponse( function, reply, NUM_NODE_BITFIELD_BYTES );
+			break;
+		}
+		case FUNC_ID_ZW_SEND_DATA:
+		{
+			HandleSendData( data, length );
+			break;
+		}
+		case FUNC_ID_ZW_SEND_DATA_MULTI:
+		{
+			HandleSendDataMulti( data, length );
+			break;
+		}
+		default:
+		{
+			// Including FUNC_ID_SERIAL_API_APPL_NODE_INFORMATION, which
+			// has no response
+			break;
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------
+// <Simulator::HandleSendData>
+// Transmit a command to one of the virtual nodes
+//-----------------------------------------------------------------------------
+void Simulator::HandleSendData
+(
+	uint8 const* _data,
+	uint32 _length
+)
+{
+	// nodeId, length, command..., transmit options, callback id
+	if( _length < 2 || _length < (uint32)_data[1] + 4 )
+	{
+		return;
+	}
+
+	uint8 const nodeId = _data[0];
+	uint8 const cmdLength = _data[1];
+	uint8 const* cmd = &_data[2];
+	uint8 const callbackId = _data[cmdLength + 3];
+
+	uint8 accepted = 0x01;
+	SendResponse( FUNC_ID_ZW_SEND_DATA, &accepted, 1 );
+
+	map<uint8,VirtualNode>::iterator it = m_nodes.find( nodeId );
+	bool delivered = ( it != m_nodes.end() ) && it->second.m_awake;
+	if( delivered && m_options.m_lossPercent && ( (uint32)rand() % 100 ) < m_options.m_lossPercent )
+	{
+		delivered = false;
+	}
+
+	uint64 at = Now() + Delay();
+	if( callbackId )
+	{
+		uint8 callback[4] = { callbackId, (uint8)( delivered ? TRANSMIT_COMPLETE_OK : TRANSMIT_COMPLETE_NO_ACK ), 0x00, 0x00 };
+		Queue( at, REQUEST, FUNC_ID_ZW_SEND_DATA, callback, sizeof(callback) );
+	}
+
+	if( delivered && cmdLength > 0 )
+	{
+		HandleCommand( nodeId, cmd, cmdLength, at );
+	}
+}
+
+//-----------------------------------------------------------------------------
+// <Simulator::HandleSendDataMulti>
+// A multicast frame reaches every awake node in the list, but nobody acks it
+//-----------------------------------------------------------------------------
+void Simulator::HandleSendDataMulti
+(
+	uint8 const* _data,
+	uint32 _length
+)
+{
+	// count, nodeIds..., length, command..., transmit options, callback id
+	if( _length < 1 || _length < (uint32)_data[0] + 2 )
+	{
+		return;
+	}
+
+	uint8 const numNodes = _data[0];
+	uint8 const* nodeIds = &_data[1];
+	uint8 const cmdLength = _data[numNodes + 1];
+	if( _length < (uint32)numNodes + cmdLength + 4 )
+	{
+		return;
+	}
+	uint8 const* cmd = &_data[numNodes + 2];
+	uint8 const callbackId = _data[numNodes + cmdLength + 3];
+
+	uint8 accepted = 0x01;
+	SendResponse( FUNC_ID_ZW_SEND_DATA_MULTI, &accepted, 1 );
+
+	uint64 at = Now() + Delay();
+	if( callbackId )
+	{
+		uint8 callback[2] = { callbackId, TRANSMIT_COMPLETE_OK };
+		Queue( at, REQUEST, FUNC_ID_ZW_SEND_DATA_MULTI, callback, sizeof(callback) );
+	}
+
+	for( uint8 i=0; i<numNodes && cmdLength > 0; ++i )
+	{
+		map<uint8,VirtualNode>::iterator it = m_nodes.find( nodeIds[i] );
+		if( ( it == m_nodes.end() ) || !it->second.m_awake )
+		{
+			continue;
+		}
+		if( m_options.m_lossPercent && ( (uint32)rand() % 100 ) < m_options.m_lossPercent )
+		{
+			continue;
+		}
+		HandleCommand( nodeIds[i], cmd, cmdLength, at );
+	}
+}
+
+//-----------------------------------------------------------------------------
+// <Simulator::HandleCommand>
+// Apply a command class command to a virtual node
+//-----------------------------------------------------------------------------
+void Simulator::HandleCommand
+(
+	uint8 _nodeId,
+	uint8 const* _cmd,
+	uint32 _length,
+	uint64 _at
+)
+{
+	VirtualNode& node = m_nodes[_nodeId];
+	uint8 const commandClass = _cmd[0];
+	uint8 const command = ( _length > 1 ) ? _cmd[1] : 0;
+
+	if( !node.m_listening )
+	{
+		node.m_sleepAt = Now() + c_awakeTimeout;
+	}
+
+	if( commandClass == c_wakeUpClass )
+	{
+		switch( command )
+		{
+			case 0x04:		// Interval Set
+			{
+				if( _length >= 5 )
+				{
+					node.m_wakeInterval = ( (uint32)_cmd[2] << 16 ) | ( (uint32)_cmd[3] << 8 ) | (uint32)_cmd[4];
+				}
+				break;
+			}
+			case 0x05:		// Interval Get
+			{
+				uint8 report[6] = { c_wakeUpClass, 0x06, (uint8)( node.m_wakeInterval >> 16 ), (uint8)( node.m_wakeInterval >> 8 ), (uint8)node.m_wakeInterval, 0x01 };
+				QueueReport( _at, _nodeId, report, sizeof(report) );
+				break;
+			}
+			case 0x08:		// No More Information
+			{
+				node.m_awake = false;
+				node.m_nextWake = Now() + m_options.m_wakeInterval;
+				break;
+			}
+		}
+		return;
+	}
+
+	// Basic maps onto the node's primary command class
+	uint8 key = ( commandClass == c_basicClass ) ? node.m_commandClasses[0] : commandClass;
+	map<uint8,uint8>::iterator it = node.m_values.find( key );
+	if( it == node.m_values.end() )
+	{
+		// Not something this node supports
+		return;
+	}
+
+	switch( command )
+	{
+		case 0x01:		// Set
+		{
+			if( _length > 2 )
+			{
+				it->second = _cmd[2];
+			}
+			break;
+		}
+		case 0x02:		// Get
+		{
+			uint8 report[3] = { commandClass, 0x03, it->second };
+			QueueReport( _at, _nodeId, report, sizeof(report) );
+			break;
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------
+// <Simulator::WakeNodes>
+// Send wake-up notifications and put idle sleeping nodes back to sleep
+//-----------------------------------------------------------------------------
+void Simulator::WakeNodes
+(
+)
+{
+	uint64 now = Now();
+	for( map<uint8,VirtualNode>::iterator it = m_nodes.begin(); it != m_nodes.end(); ++it )
+	{
+		VirtualNode& node = it->second;
+		if( node.m_listening )
+		{
+			continue;
+		}
+
+		if( !node.m_awake && now >= node.m_nextWake )
+		{
+			node.m_awake = true;
+			node.m_sleepAt = now + c_awakeTimeout;
+			uint8 notification[2] = { c_wakeUpClass, 0x07 };
+			QueueReport( now, it->first, notification, sizeof(notification) );
+		}
+		else if( node.m_awake && now >= node.m_sleepAt )
+		{
+			node.m_awake = false;
+			node.m_nextWake = now + m_options.m_wakeInterval;
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------
+// <Simulator::SendResponse>
+// Write a RESPONSE frame immediately
+//-----------------------------------------------------------------------------
+void Simulator::SendResponse
+(
+	uint8 _function,
+	uint8 const* _data,
+	uint32 _length
+)
+{
+	Queue( 0, RESPONSE, _function, _data, _length );
+	Flush();
+}
+
+//-----------------------------------------------------------------------------
+// <Simulator::Queue>
+// Build a frame and hold it until _at
+//-----------------------------------------------------------------------------
+void Simulator::Queue
+(
+	uint64 _at,
+	uint8 _type,
+	uint8 _function,
+	uint8 const* _data,
+	uint32 _length
+)
+{
+	vector<uint8> frame( _length + 5 );
+	frame[0] = SOF;
+	frame[1] = (uint8)( _length + 3 );
+	frame[2] = _type;
+	frame[3] = _function;
+	memcpy( &frame[4], _data, _length );
+
+	uint8 checksum = 0xff;
+	for( uint32 i=1; i<_length+4; ++i )
+	{
+		checksum ^= frame[i];
+	}
+	frame[_length+4] = checksum;
+
+	m_pending.insert( pair<uint64,vector<uint8> >( _at, frame ) );
+}
+
+//-----------------------------------------------------------------------------
+// <Simulator::QueueReport>
+// Queue a command from a virtual node to the controller
+//-----------------------------------------------------------------------------
+void Simulator::QueueReport
+(
+	uint64 _at,
+	uint8 _nodeId,
+	uint8 const* _cmd,
+	uint32 _length
+)
+{
+	uint8 data[64];
+	data[0] = 0x00;			// Receive status
+	data[1] = _nodeId;
+	data[2] = (uint8)_length;
+	memcpy( &data[3], _cmd, _length );
+	Queue( _at, REQUEST, FUNC_ID_APPLICATION_COMMAND_HANDLER, data, _length + 3 );
+}
+
+//-----------------------------------------------------------------------------
+// <Simulator::Flush>
+// Write every frame that is due
+//-----------------------------------------------------------------------------
+void Simulator::Flush
+(
+)
+{
+	uint64 now = Now();
+	while( !m_pending.empty() && m_pending.begin()->first <= now )
+	{
+		vector<uint8> const& frame = m_pending.begin()->second;
+		WriteBytes( &frame[0], (uint32)frame.size() );
+		m_pending.erase( m_pending.begin() );
+	}
+}
+
+//-----------------------------------------------------------------------------
+// <Simulator::WriteBytes>
+// Write to the pty, riding out short writes
+//-----------------------------------------------------------------------------
+void Simulator::WriteBytes
+(
+	uint8 const* _data,
+	uint32 _length
+)
+{
+	while( _length > 0 )
+	{
+		ssize_t count = write( m_master, _data, _length );
+		if( count < 0 )
+		{
+			if( errno == EINTR )
+			{
+				continue;
+			}
+			return;
+		}
+		_data += count;
+		_length -= (uint32)count;
+	}
+}
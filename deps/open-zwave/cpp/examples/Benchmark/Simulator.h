@@ -0,0 +1,127 @@
+//-----------------------------------------------------------------------------
+//
+//	Simulator.h
+//
+//	Simulated Z-Wave Serial API controller for benchmarking OpenZWave
+//
+//	Speaks the SOF/ACK/NAK/CAN framing of a real PC controller on the
+//	master side of a pseudo-terminal, and answers for a set of virtual
+//	binary switches and sleeping binary sensors.
+//
+//	SOFTWARE NOTICE AND LICENSE
+//
+//	This file is part of OpenZWave.
+//
+//	OpenZWave is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU Lesser General Public License as published
+//	by the Free Software Foundation, either version 3 of the License,
+//	or (at your option) any later version.
+//
+//	OpenZWave is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//	GNU Lesser General Public License for more details.
+//
+//	You should have received a copy of the GNU Lesser General Public License
+//	along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+
+#ifndef _Simulator_H
+#define _Simulator_H
+
+#include <map>
+#include <vector>
+#include "Defs.h"
+
+//-----------------------------------------------------------------------------
+// <SimulatorOptions>
+// Shape of the simulated network
+//-----------------------------------------------------------------------------
+struct SimulatorOptions
+{
+	SimulatorOptions():
+		m_numNodes( 10 ),
+		m_numSleeping( 0 ),
+		m_latency( 20 ),
+		m_jitter( 0 ),
+		m_lossPercent( 0 ),
+		m_wakeInterval( 10000 ),
+		m_homeId( 0xc0ffee01 )
+	{
+	}
+
+	uint32	m_numNodes;			// Listening binary switches, node ids 2 upwards
+	uint32	m_numSleeping;		// Sleeping binary sensors, following the switches
+	uint32	m_latency;			// Milliseconds between a transmission and its callback
+	uint32	m_jitter;			// Up to this many milliseconds added to each latency
+	uint32	m_lossPercent;		// Chance that a transmission is not acknowledged
+	uint32	m_wakeInterval;		// Milliseconds between wake-up notifications
+	uint32	m_homeId;
+};
+
+//-----------------------------------------------------------------------------
+// <Simulator>
+// A PC controller and its network, driven from the master side of a pty
+//-----------------------------------------------------------------------------
+class Simulator
+{
+public:
+	Simulator( SimulatorOptions const& _options );
+	~Simulator();
+
+	// Opens the pseudo-terminal.  Returns the path of its slave side, or
+	// NULL on failure.  The slave is held open so the master never sees a
+	// hangup while OpenZWave is closing and reopening the port.
+	char const* Open();
+
+	// Closes the pty in a process that will not call Run.
+	void Detach();
+
+	// Serves the network until _exitFd becomes readable or is closed.
+	void Run( int _exitFd );
+
+private:
+	struct VirtualNode
+	{
+		bool				m_listening;
+		bool				m_awake;
+		uint8				m_generic;
+		uint8				m_specific;
+		std::vector<uint8>	m_commandClasses;
+		std::map<uint8,uint8>	m_values;		// Command class to current value
+		uint32				m_wakeInterval;		// Seconds, as set by the controller
+		uint64				m_nextWake;
+		uint64				m_sleepAt;
+	};
+
+	uint64 Now()const;
+	uint32 Delay();
+
+	void ReadFromHost();
+	void HandleFrame( uint8 const* _frame, uint32 _length );
+	void HandleSendData( uint8 const* _data, uint32 _length );
+	void HandleSendDataMulti( uint8 const* _data, uint32 _length );
+	void HandleCommand( uint8 _nodeId, uint8 const* _cmd, uint32 _length, uint64 _at );
+	void WakeNodes();
+
+	void SendResponse( uint8 _function, uint8 const* _data, uint32 _length );
+	void Queue( uint64 _at, uint8 _type, uint8 _function, uint8 const* _data, uint32 _length );
+	void QueueReport( uint64 _at, uint8 _nodeId, uint8 const* _cmd, uint32 _length );
+	void Flush();
+	void WriteBytes( uint8 const* _data, uint32 _length );
+
+	SimulatorOptions			m_options;
+	int							m_master;
+	int							m_slave;
+	char						m_slaveName[128];
+
+	std::map<uint8,VirtualNode>	m_nodes;
+	std::multimap<uint64,std::vector<uint8> >	m_pending;	// Frames to send, keyed on when
+
+	uint8						m_rxBuffer[512];
+	uint32						m_rxLength;
+};
+
+#endif //_Simulator_H
+
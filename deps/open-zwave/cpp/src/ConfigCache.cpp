@@ -0,0 +1,328 @@
+//-----------------------------------------------------------------------------
+//
+//	ConfigCache.cpp
+//
+//	Compiled, memory-mapped images of the XML configuration files
+//
+//	SOFTWARE NOTICE AND LICENSE
+//
+//	This file is part of OpenZWave.
+//
+//	OpenZWave is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU Lesser General Public License as published
+//	by the Free Software Foundation, either version 3 of the License,
+//	or (at your option) any later version.
+//
+//	OpenZWave is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//	GNU Lesser General Public License for more details.
+//
+//	You should have received a copy of the GNU Lesser General Public License
+//	along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+
+#include <stdio.h>
+#include <string.h>
+
+#include "ConfigCache.h"
+#include "platform/FileOps.h"
+#include "platform/Log.h"
+
+using namespace OpenZWave;
+
+static uint32 const c_magic = 0x43575a4f;		// "OZWC" in little-endian byte order
+static uint16 const c_version = 1;
+
+//-----------------------------------------------------------------------------
+// <ConfigCache::Open>
+// Map a cache image, if it was built from the current source file
+//-----------------------------------------------------------------------------
+ConfigCache* ConfigCache::Open
+(
+	string const& _sourceFile,
+	string const& _cacheFile,
+	uint32 const _recordSize
+)
+{
+	uint64 modified;
+	uint64 sourceSize;
+	if( !FileOps::FileInfo( _sourceFile, &modified, &sourceSize ) )
+	{
+		return NULL;
+	}
+
+	uint32 size = 0;
+	void const* data = FileOps::MapFile( _cacheFile, &size );
+	if( data == NULL )
+	{
+		return NULL;
+	}
+
+	// Check everything we will rely on later, so that a truncated or
+	// foreign file is rejected here rather than read out of bounds.
+	bool valid = false;
+	if( size >= sizeof(Header) )
+	{
+		Header const* header = (Header const*)data;
+		uint64 recordsOffset = Align( Align( sizeof(Header) ) + ( header->m_bucketCount * 4 ) );
+		uint64 stringsOffset = recordsOffset + ( (uint64)header->m_recordCount * header->m_recordSize );
+
+		valid = ( header->m_magic == c_magic )
+			&& ( header->m_version == c_version )
+			&& ( header->m_recordSize == _recordSize )
+			&& ( header->m_sourceModified == modified )
+			&& ( header->m_sourceSize == sourceSize )
+			&& ( header->m_imageSize == size )
+			&& ( header->m_bucketCount > 0 )
+			&& ( ( header->m_bucketCount & ( header->m_bucketCount - 1 ) ) == 0 )
+			&& ( header->m_bucketCount <= ( size / 4 ) )
+			&& ( header->m_stringSize > 0 )
+			&& ( stringsOffset + header->m_stringSize == size );
+
+		if( valid )
+		{
+			uint32 const* buckets = (uint32 const*)( (uint8 const*)data + Align( sizeof(Header) ) );
+			for( uint32 i=0; i<header->m_bucketCount; ++i )
+			{
+				if( buckets[i] > header->m_recordCount )
+				{
+					valid = false;
+					break;
+				}
+			}
+			valid = valid && ( ( (char const*)data )[size-1] == 0 );
+		}
+	}
+
+	if( !valid )
+	{
+		FileOps::UnmapFile( data, size );
+		return NULL;
+	}
+
+	return new ConfigCache( data, size );
+}
+
+//-----------------------------------------------------------------------------
+// <ConfigCache::ConfigCache>
+// Constructor
+//-----------------------------------------------------------------------------
+ConfigCache::ConfigCache
+(
+	void const* _data,
+	uint32 const _size
+):
+	m_data( _data ),
+	m_size( _size )
+{
+	uint8 const* base = (uint8 const*)_data;
+	m_header = (Header const*)base;
+	m_buckets = (uint32 const*)( base + Align( sizeof(Header) ) );
+	m_records = base + Align( Align( sizeof(Header) ) + ( m_header->m_bucketCount * 4 ) );
+	m_strings = (char const*)( m_records + ( m_header->m_recordCount * m_header->m_recordSize ) );
+}
+
+//-----------------------------------------------------------------------------
+// <ConfigCache::~ConfigCache>
+// Destructor
+//-----------------------------------------------------------------------------
+ConfigCache::~ConfigCache
+(
+)
+{
+	FileOps::UnmapFile( m_data, m_size );
+}
+
+//-----------------------------------------------------------------------------
+// <ConfigCache::Hash>
+// Spread a key over the bucket table
+//-----------------------------------------------------------------------------
+uint32 ConfigCache::Hash
+(
+	uint64 const _key
+)
+{
+	return (uint32)( ( _key * 0x9e3779b97f4a7c15ULL ) >> 32 );
+}
+
+//-----------------------------------------------------------------------------
+// <ConfigCache::Find>
+// Look up the record with the given key
+//-----------------------------------------------------------------------------
+void const* ConfigCache::Find
+(
+	uint64 const _key
+)const
+{
+	uint32 mask = m_header->m_bucketCount - 1;
+	uint32 bucket = Hash( _key ) & mask;
+	for( uint32 i=0; i<=mask; ++i )
+	{
+		uint32 index = m_buckets[bucket];
+		if( index == 0 )
+		{
+			break;
+		}
+
+		void const* record = GetRecord( index - 1 );
+		if( *(uint64 const*)record == _key )
+		{
+			return record;
+		}
+		bucket = ( bucket + 1 ) & mask;
+	}
+	return NULL;
+}
+
+//-----------------------------------------------------------------------------
+// <ConfigCache::GetString>
+// Resolve a string offset stored in a record
+//-----------------------------------------------------------------------------
+char const* ConfigCache::GetString
+(
+	uint32 const _offset
+)const
+{
+	if( _offset >= m_header->m_stringSize )
+	{
+		return "";
+	}
+	return &m_strings[_offset];
+}
+
+//-----------------------------------------------------------------------------
+// <ConfigCache::Writer::Writer>
+// Constructor
+//-----------------------------------------------------------------------------
+ConfigCache::Writer::Writer
+(
+	string const& _sourceFile,
+	uint32 const _recordSize
+):
+	m_sourceModified( 0 ),
+	m_sourceSize( 0 ),
+	m_recordSize( _recordSize )
+{
+	m_sourceFound = FileOps::FileInfo( _sourceFile, &m_sourceModified, &m_sourceSize );
+
+	// Offset zero is always the empty string
+	m_strings.push_back( 0 );
+	m_stringIndex[""] = 0;
+}
+
+//-----------------------------------------------------------------------------
+// <ConfigCache::Writer::AddRecord>
+// Append a record.  Its first eight bytes are the key.
+//-----------------------------------------------------------------------------
+void ConfigCache::Writer::AddRecord
+(
+	void const* _record
+)
+{
+	uint8 const* bytes = (uint8 const*)_record;
+	m_records.insert( m_records.end(), bytes, bytes + m_recordSize );
+}
+
+//-----------------------------------------------------------------------------
+// <ConfigCache::Writer::AddString>
+// Add a string to the pool, sharing any identical copy already there
+//-----------------------------------------------------------------------------
+uint32 ConfigCache::Writer::AddString
+(
+	string const& _str
+)
+{
+	map<string,uint32>::iterator it = m_stringIndex.find( _str );
+	if( it != m_stringIndex.end() )
+	{
+		return it->second;
+	}
+
+	uint32 offset = (uint32)m_strings.size();
+	m_strings.insert( m_strings.end(), _str.c_str(), _str.c_str() + _str.size() + 1 );
+	m_stringIndex[_str] = offset;
+	return offset;
+}
+
+//-----------------------------------------------------------------------------
+// <ConfigCache::Writer::Write>
+// Lay out the image and replace the cache file with it
+//-----------------------------------------------------------------------------
+bool ConfigCache::Writer::Write
+(
+	string const& _cacheFile
+)
+{
+	if( !m_sourceFound || ( m_recordSize & 7 ) || m_recordSize < sizeof(uint64) )
+	{
+		return false;
+	}
+
+	// Keep the table at most half full
+	uint32 recordCount = (uint32)( m_records.size() / m_recordSize );
+	uint32 bucketCount = 8;
+	while( bucketCount < recordCount * 2 )
+	{
+		bucketCount <<= 1;
+	}
+
+	vector<uint32> buckets( bucketCount, 0 );
+	for( uint32 i=0; i<recordCount; ++i )
+	{
+		uint64 key;
+		memcpy( &key, &m_records[i * m_recordSize], sizeof(key) );
+		uint32 bucket = Hash( key ) & ( bucketCount - 1 );
+		while( buckets[bucket] )
+		{
+			bucket = ( bucket + 1 ) & ( bucketCount - 1 );
+		}
+		buckets[bucket] = i + 1;
+	}
+
+	uint32 bucketsOffset = Align( sizeof(Header) );
+	uint32 recordsOffset = Align( bucketsOffset + ( bucketCount * 4 ) );
+	uint32 stringsOffset = recordsOffset + (uint32)m_records.size();
+	uint32 imageSize = stringsOffset + (uint32)m_strings.size();
+
+	vector<uint8> image( imageSize, 0 );
+	Header* header = (Header*)&image[0];
+	header->m_magic = c_magic;
+	header->m_version = c_version;
+	header->m_recordSize = (uint16)m_recordSize;
+	header->m_sourceModified = m_sourceModified;
+	header->m_sourceSize = m_sourceSize;
+	header->m_recordCount = recordCount;
+	header->m_bucketCount = bucketCount;
+	header->m_stringSize = (uint32)m_strings.size();
+	header->m_imageSize = imageSize;
+	memcpy( &image[bucketsOffset], &buckets[0], bucketCount * 4 );
+	if( !m_records.empty() )
+	{
+		memcpy( &image[recordsOffset], &m_records[0], m_records.size() );
+	}
+	memcpy( &image[stringsOffset], &m_strings[0], m_strings.size() );
+
+	// Write to the side and rename over the old image, so a reader never
+	// maps a half-written file
+	string tempFile = _cacheFile + ".tmp";
+	FILE* file = fopen( tempFile.c_str(), "wb" );
+	if( file == NULL )
+	{
+		Log::Write( LogLevel_Info, "Unable to write config cache %s", tempFile.c_str() );
+		return false;
+	}
+
+	bool written = ( fwrite( &image[0], 1, imageSize, file ) == imageSize );
+	written = ( fclose( file ) == 0 ) && written;
+	if( !written || !FileOps::ReplaceFile( tempFile, _cacheFile ) )
+	{
+		Log::Write( LogLevel_Info, "Unable to write config cache %s", _cacheFile.c_str() );
+		remove( tempFile.c_str() );
+		return false;
+	}
+
+	Log::Write( LogLevel_Info, "Wrote config cache %s (%d records)", _cacheFile.c_str(), recordCount );
+	return true;
+}
@@ -0,0 +1,117 @@
+//-----------------------------------------------------------------------------
+//
+//	ConfigCache.h
+//
+//	Compiled, memory-mapped images of the XML configuration files
+//
+//	SOFTWARE NOTICE AND LICENSE
+//
+//	This file is part of OpenZWave.
+//
+//	OpenZWave is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU Lesser General Public License as published
+//	by the Free Software Foundation, either version 3 of the License,
+//	or (at your option) any later version.
+//
+//	OpenZWave is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//	GNU Lesser General Public License for more details.
+//
+//	You should have received a copy of the GNU Lesser General Public License
+//	along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+
+#ifndef _ConfigCache_H
+#define _ConfigCache_H
+
+#include <string>
+#include <vector>
+#include <map>
+
+#include "Defs.h"
+
+namespace OpenZWave
+{
+	/** \brief Read-only binary image of one XML config file.
+	 *
+	 * The image holds fixed-size records, each starting with a 64-bit key,
+	 * an open-addressed hash table over those keys, and a pool of strings
+	 * the records refer to by offset.  It is mapped straight from disk, so
+	 * lookups need no parsing and no allocation.  The image records the
+	 * modification time and size of the XML it was built from, and is
+	 * ignored once that file changes.
+	 */
+	class ConfigCache
+	{
+	public:
+		/**
+		 * Map the cache built from _sourceFile, if there is one and it is current.
+		 * \param _sourceFile Path of the XML file.
+		 * \param _cacheFile Path of the compiled image.
+		 * \param _recordSize Size of the caller's record structure, which must start with a uint64 key.
+		 * \return The cache, or NULL if the image is missing, stale or damaged.
+		 */
+		static ConfigCache* Open( string const& _sourceFile, string const& _cacheFile, uint32 const _recordSize );
+		~ConfigCache();
+
+		void const* Find( uint64 const _key )const;
+		uint32 GetRecordCount()const{ return m_header->m_recordCount; }
+		void const* GetRecord( uint32 const _index )const{ return m_records + ( _index * m_header->m_recordSize ); }
+		char const* GetString( uint32 const _offset )const;
+
+		/** \brief Builds a ConfigCache image and writes it to disk.
+		 *
+		 * Create the Writer before reading the source, so that an edit made
+		 * while it is being parsed leaves the image stale rather than wrong.
+		 */
+		class Writer
+		{
+		public:
+			Writer( string const& _sourceFile, uint32 const _recordSize );
+
+			void AddRecord( void const* _record );
+			uint32 AddString( string const& _str );
+			bool Write( string const& _cacheFile );
+
+		private:
+			bool						m_sourceFound;
+			uint64						m_sourceModified;
+			uint64						m_sourceSize;
+			uint32						m_recordSize;
+			vector<uint8>				m_records;
+			vector<char>				m_strings;
+			map<string,uint32>			m_stringIndex;
+		};
+
+	private:
+		struct Header
+		{
+			uint32	m_magic;
+			uint16	m_version;
+			uint16	m_recordSize;
+			uint64	m_sourceModified;
+			uint64	m_sourceSize;
+			uint32	m_recordCount;
+			uint32	m_bucketCount;
+			uint32	m_stringSize;
+			uint32	m_imageSize;
+		};
+
+		ConfigCache( void const* _data, uint32 const _size );
+
+		static uint32 Hash( uint64 const _key );
+		static uint32 Align( uint32 const _offset ){ return ( _offset + 7 ) & ~7; }
+
+		void const*		m_data;
+		uint32			m_size;
+		Header const*	m_header;
+		uint32 const*	m_buckets;
+		uint8 const*	m_records;
+		char const*		m_strings;
+	};
+
+} // namespace OpenZWave
+
+#endif //_ConfigCache_H
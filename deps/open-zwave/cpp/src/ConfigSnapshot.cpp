@@ -0,0 +1,365 @@
+//-----------------------------------------------------------------------------
+//
+//	ConfigSnapshot.cpp
+//
+//	Binary image of a network configuration document
+//
+//	SOFTWARE NOTICE AND LICENSE
+//
+//	This file is part of OpenZWave.
+//
+//	OpenZWave is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU Lesser General Public License as published
+//	by the Free Software Foundation, either version 3 of the License,
+//	or (at your option) any later version.
+//
+//	OpenZWave is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//	GNU Lesser General Public License for more details.
+//
+//	You should have received a copy of the GNU Lesser General Public License
+//	along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+
+#include <stdio.h>
+#include <string.h>
+
+#include "ConfigSnapshot.h"
+#include "platform/FileOps.h"
+#include "platform/Log.h"
+
+#include "tinyxml.h"
+
+using namespace OpenZWave;
+
+static uint32 const c_magic = 0x53575a4f;		// "OZWS" in little-endian byte order
+static uint16 const c_version = 1;
+static uint32 const c_maxDepth = 32;
+
+// Tags in the tree stream.  An element is followed by its name, attribute
+// count, child count, the attribute name/value pairs and then its children.
+// A text node is followed by its value.  Names and values are indices into
+// the string pool.
+enum
+{
+	SnapshotTag_Element	= 1,
+	SnapshotTag_Text
+};
+
+//-----------------------------------------------------------------------------
+// <ConfigSnapshot::Read>
+// Rebuild a document from its snapshot, if it matches the XML file
+//-----------------------------------------------------------------------------
+bool ConfigSnapshot::Read
+(
+	string const& _snapshotFile,
+	string const& _sourceFile,
+	TiXmlDocument* _doc
+)
+{
+	_doc->Clear();
+
+	uint64 modified;
+	uint64 sourceSize;
+	if( !FileOps::FileInfo( _sourceFile, &modified, &sourceSize ) )
+	{
+		return false;
+	}
+
+	uint32 size = 0;
+	void const* data = FileOps::MapFile( _snapshotFile, &size );
+	if( data == NULL )
+	{
+		return false;
+	}
+
+	TiXmlElement* root = NULL;
+	Header const* header = (Header const*)data;
+	if( ( size >= sizeof(Header) )
+		&& ( header->m_magic == c_magic )
+		&& ( header->m_version == c_version )
+		&& ( header->m_sourceModified == modified )
+		&& ( header->m_sourceSize == sourceSize )
+		&& ( header->m_imageSize == size )
+		&& ( ( header->m_stringSize & 3 ) == 0 )
+		&& ( sizeof(Header) + (uint64)header->m_stringSize + ( (uint64)header->m_treeSize * 4 ) == size ) )
+	{
+		ConfigSnapshot reader;
+		char const* pool = (char const*)data + sizeof(Header);
+		char const* poolEnd = pool + header->m_stringSize;
+
+		// Index the string pool.  Anything after the last string is padding.
+		reader.m_stringTable.reserve( header->m_stringCount );
+		char const* str = pool;
+		while( ( reader.m_stringTable.size() < header->m_stringCount ) && ( str < poolEnd ) )
+		{
+			char const* end = (char const*)memchr( str, 0, poolEnd - str );
+			if( end == NULL )
+			{
+				break;
+			}
+			reader.m_stringTable.push_back( str );
+			str = end + 1;
+		}
+
+		if( reader.m_stringTable.size() == header->m_stringCount )
+		{
+			uint32 tag;
+			reader.m_pos = (uint32 const*)poolEnd;
+			reader.m_end = reader.m_pos + header->m_treeSize;
+			if( reader.ReadWord( &tag ) && ( tag == SnapshotTag_Element ) )
+			{
+				root = reader.ReadElement( 0 );
+			}
+			if( root && ( reader.m_pos != reader.m_end ) )
+			{
+				delete root;
+				root = NULL;
+			}
+		}
+	}
+
+	FileOps::UnmapFile( data, size );
+
+	if( root == NULL )
+	{
+		return false;
+	}
+
+	_doc->LinkEndChild( new TiXmlDeclaration( "1.0", "utf-8", "" ) );
+	_doc->LinkEndChild( root );
+
+	Log::Write( LogLevel_Info, "Read network snapshot %s", _snapshotFile.c_str() );
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+// <ConfigSnapshot::ReadElement>
+// Read an element and its children.  The tag has already been read.
+//-----------------------------------------------------------------------------
+TiXmlElement* ConfigSnapshot::ReadElement
+(
+	uint32 const _depth
+)
+{
+	char const* name;
+	uint32 attributeCount;
+	uint32 childCount;
+	if( ( _depth > c_maxDepth ) || !ReadString( &name ) || !ReadWord( &attributeCount ) || !ReadWord( &childCount ) )
+	{
+		return NULL;
+	}
+
+	TiXmlElement* element = new TiXmlElement( name );
+	for( uint32 i=0; i<attributeCount; ++i )
+	{
+		char const* attributeName;
+		char const* value;
+		if( !ReadString( &attributeName ) || !ReadString( &value ) )
+		{
+			delete element;
+			return NULL;
+		}
+		element->SetAttribute( attributeName, value );
+	}
+
+	for( uint32 i=0; i<childCount; ++i )
+	{
+		uint32 tag;
+		TiXmlNode* child = NULL;
+		if( ReadWord( &tag ) )
+		{
+			if( tag == SnapshotTag_Element )
+			{
+				child = ReadElement( _depth + 1 );
+			}
+			else if( tag == SnapshotTag_Text )
+			{
+				char const* text;
+				if( ReadString( &text ) )
+				{
+					child = new TiXmlText( text );
+				}
+			}
+		}
+
+		if( child == NULL )
+		{
+			delete element;
+			return NULL;
+		}
+		element->LinkEndChild( child );
+	}
+
+	return element;
+}
+
+//-----------------------------------------------------------------------------
+// <ConfigSnapshot::ReadWord>
+// Read the next word of the tree
+//-----------------------------------------------------------------------------
+bool ConfigSnapshot::ReadWord
+(
+	uint32* _word
+)
+{
+	if( m_pos >= m_end )
+	{
+		return false;
+	}
+	*_word = *m_pos++;
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+// <ConfigSnapshot::ReadString>
+// Read a string index from the tree and resolve it
+//-----------------------------------------------------------------------------
+bool ConfigSnapshot::ReadString
+(
+	char const** _str
+)
+{
+	uint32 index;
+	if( !ReadWord( &index ) || ( index >= m_stringTable.size() ) )
+	{
+		return false;
+	}
+	*_str = m_stringTable[index];
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+// <ConfigSnapshot::Write>
+// Write a snapshot of a document, stamped with the XML file it was saved to
+//-----------------------------------------------------------------------------
+bool ConfigSnapshot::Write
+(
+	TiXmlDocument const& _doc,
+	string const& _snapshotFile,
+	string const& _sourceFile
+)
+{
+	uint64 modified;
+	uint64 sourceSize;
+	TiXmlElement const* root = _doc.RootElement();
+	if( ( root == NULL ) || !FileOps::FileInfo( _sourceFile, &modified, &sourceSize ) )
+	{
+		return false;
+	}
+
+	ConfigSnapshot writer;
+	writer.AddElement( root );
+
+	// Pad the pool so that the tree that follows it is word aligned
+	uint32 stringCount = (uint32)writer.m_stringIndex.size();
+	while( writer.m_strings.size() & 3 )
+	{
+		writer.m_strings.push_back( 0 );
+	}
+
+	uint32 treeOffset = sizeof(Header) + (uint32)writer.m_strings.size();
+	uint32 imageSize = treeOffset + ( (uint32)writer.m_tree.size() * 4 );
+
+	vector<uint8> image( imageSize, 0 );
+	Header* header = (Header*)&image[0];
+	header->m_magic = c_magic;
+	header->m_version = c_version;
+	header->m_sourceModified = modified;
+	header->m_sourceSize = sourceSize;
+	header->m_stringCount = stringCount;
+	header->m_stringSize = (uint32)writer.m_strings.size();
+	header->m_treeSize = (uint32)writer.m_tree.size();
+	header->m_imageSize = imageSize;
+	if( !writer.m_strings.empty() )
+	{
+		memcpy( &image[sizeof(Header)], &writer.m_strings[0], writer.m_strings.size() );
+	}
+	memcpy( &image[treeOffset], &writer.m_tree[0], writer.m_tree.size() * 4 );
+
+	// Write to the side and rename over the old snapshot, so that a crash
+	// part way through leaves the previous one intact
+	string tempFile = _snapshotFile + ".tmp";
+	FILE* file = fopen( tempFile.c_str(), "wb" );
+	if( file == NULL )
+	{
+		Log::Write( LogLevel_Info, "Unable to write network snapshot %s", tempFile.c_str() );
+		return false;
+	}
+
+	bool written = ( fwrite( &image[0], 1, imageSize, file ) == imageSize );
+	written = ( fclose( file ) == 0 ) && written;
+	if( !written || !FileOps::ReplaceFile( tempFile, _snapshotFile ) )
+	{
+		Log::Write( LogLevel_Info, "Unable to write network snapshot %s", _snapshotFile.c_str() );
+		remove( tempFile.c_str() );
+		return false;
+	}
+
+	Log::Write( LogLevel_Info, "Wrote network snapshot %s (%d bytes)", _snapshotFile.c_str(), imageSize );
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+// <ConfigSnapshot::AddString>
+// Add a string to the pool, sharing any identical copy already there
+//-----------------------------------------------------------------------------
+uint32 ConfigSnapshot::AddString
+(
+	char const* _str
+)
+{
+	string str( _str ? _str : "" );
+	map<string,uint32>::iterator it = m_stringIndex.find( str );
+	if( it != m_stringIndex.end() )
+	{
+		return it->second;
+	}
+
+	uint32 index = (uint32)m_stringIndex.size();
+	m_strings.insert( m_strings.end(), str.c_str(), str.c_str() + str.size() + 1 );
+	m_stringIndex[str] = index;
+	return index;
+}
+
+//-----------------------------------------------------------------------------
+// <ConfigSnapshot::AddElement>
+// Append an element and its children to the tree
+//-----------------------------------------------------------------------------
+void ConfigSnapshot::AddElement
+(
+	TiXmlElement const* _element
+)
+{
+	m_tree.push_back( SnapshotTag_Element );
+	m_tree.push_back( AddString( _element->Value() ) );
+
+	// The counts are filled in once they are known
+	size_t counts = m_tree.size();
+	m_tree.push_back( 0 );
+	m_tree.push_back( 0 );
+
+	for( TiXmlAttribute const* attribute = _element->FirstAttribute(); attribute; attribute = attribute->Next() )
+	{
+		m_tree.push_back( AddString( attribute->Name() ) );
+		m_tree.push_back( AddString( attribute->Value() ) );
+		++m_tree[counts];
+	}
+
+	for( TiXmlNode const* child = _element->FirstChild(); child; child = child->NextSibling() )
+	{
+		if( TiXmlElement const* element = child->ToElement() )
+		{
+			AddElement( element );
+			++m_tree[counts+1];
+		}
+		else if( TiXmlText const* text = child->ToText() )
+		{
+			m_tree.push_back( SnapshotTag_Text );
+			m_tree.push_back( AddString( text->Value() ) );
+			++m_tree[counts+1];
+		}
+	}
+}
@@ -0,0 +1,107 @@
+//-----------------------------------------------------------------------------
+//
+//	ConfigSnapshot.h
+//
+//	Binary image of a network configuration document
+//
+//	SOFTWARE NOTICE AND LICENSE
+//
+//	This file is part of OpenZWave.
+//
+//	OpenZWave is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU Lesser General Public License as published
+//	by the Free Software Foundation, either version 3 of the License,
+//	or (at your option) any later version.
+//
+//	OpenZWave is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//	GNU Lesser General Public License for more details.
+//
+//	You should have received a copy of the GNU Lesser General Public License
+//	along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+
+#ifndef _ConfigSnapshot_H
+#define _ConfigSnapshot_H
+
+#include <string>
+#include <vector>
+#include <map>
+
+#include "Defs.h"
+
+class TiXmlDocument;
+class TiXmlElement;
+
+namespace OpenZWave
+{
+	/** \brief Binary copy of a zwcfg_*.xml document, for fast startup.
+	 *
+	 * The snapshot stores the element tree of the document as a stream of
+	 * words that refer into a pool of interned strings.  Reading it rebuilds
+	 * the same document with sequential reads and no text parsing, so the
+	 * nodes, command classes and values still restore themselves through
+	 * their ReadXML methods.  The snapshot records the modification time and
+	 * size of the XML file written alongside it, and is ignored once that
+	 * file changes, so the XML stays the file to edit or delete by hand.
+	 */
+	class ConfigSnapshot
+	{
+	public:
+		/**
+		 * Rebuild a document from its snapshot, if the snapshot is current.
+		 * \param _snapshotFile Path of the snapshot.
+		 * \param _sourceFile Path of the XML file the snapshot was written with.
+		 * \param _doc Document to fill in.  It is left empty on failure.
+		 * \return True if the document was read from the snapshot.
+		 */
+		static bool Read( string const& _snapshotFile, string const& _sourceFile, TiXmlDocument* _doc );
+
+		/**
+		 * Write a snapshot of a document that has just been saved as XML.
+		 * \param _doc The document.
+		 * \param _snapshotFile Path of the snapshot.
+		 * \param _sourceFile Path the document was saved to.
+		 * \return True if the snapshot was written.
+		 */
+		static bool Write( TiXmlDocument const& _doc, string const& _snapshotFile, string const& _sourceFile );
+
+	private:
+		struct Header
+		{
+			uint32	m_magic;
+			uint16	m_version;
+			uint16	m_reserved;
+			uint64	m_sourceModified;
+			uint64	m_sourceSize;
+			uint32	m_stringCount;
+			uint32	m_stringSize;
+			uint32	m_treeSize;
+			uint32	m_imageSize;
+		};
+
+		ConfigSnapshot(){}
+
+		// Writing
+		uint32 AddString( char const* _str );
+		void AddElement( TiXmlElement const* _element );
+
+		vector<uint32>			m_tree;
+		vector<char>			m_strings;
+		map<string,uint32>		m_stringIndex;
+
+		// Reading
+		TiXmlElement* ReadElement( uint32 const _depth );
+		bool ReadWord( uint32* _word );
+		bool ReadString( char const** _str );
+
+		uint32 const*			m_pos;
+		uint32 const*			m_end;
+		vector<char const*>		m_stringTable;
+	};
+
+} // namespace OpenZWave
+
+#endif //_ConfigSnapshot_H
@@ -0,0 +1,436 @@
+//-----------------------------------------------------------------------------
+//
+//	ConfigWriter.cpp
+//
+//	Saves the network configuration on a background thread
+//
+//	SOFTWARE NOTICE AND LICENSE
+//
+//	This file is part of OpenZWave.
+//
+//	OpenZWave is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU Lesser General Public License as published
+//	by the Free Software Foundation, either version 3 of the License,
+//	or (at your option) any later version.
+//
+//	OpenZWave is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//	GNU Lesser General Public License for more details.
+//
+//	You should have received a copy of the GNU Lesser General Public License
+//	along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+
+#include <stdio.h>
+#include <string.h>
+
+#include "ConfigWriter.h"
+#include "ConfigSnapshot.h"
+#include "platform/Event.h"
+#include "platform/FileOps.h"
+#include "platform/Log.h"
+#include "platform/Mutex.h"
+#include "platform/Thread.h"
+
+#include "tinyxml.h"
+
+using namespace OpenZWave;
+
+//-----------------------------------------------------------------------------
+// <ConfigWriter::Update::Update>
+// Constructor
+//-----------------------------------------------------------------------------
+ConfigWriter::Update::Update
+(
+	string const& _filename,
+	string const& _snapshotFile
+):
+	m_filename( _filename ),
+	m_snapshotFile( _snapshotFile ),
+	m_driverElement( new TiXmlElement( "Driver" ) )
+{
+	memset( m_nodes, 0, sizeof(m_nodes) );
+	memset( m_present, 0, sizeof(m_present) );
+}
+
+//-----------------------------------------------------------------------------
+// <ConfigWriter::Update::~Update>
+// Destructor
+//-----------------------------------------------------------------------------
+ConfigWriter::Update::~Update
+(
+)
+{
+	delete m_driverElement;
+	for( int i=0; i<256; ++i )
+	{
+		delete m_nodes[i];
+	}
+	for( list<ValueChange>::iterator it = m_values.begin(); it != m_values.end(); ++it )
+	{
+		delete it->m_element;
+	}
+}
+
+//-----------------------------------------------------------------------------
+// <ConfigWriter::Update::AddNode>
+// Create the element that a changed node is written into
+//-----------------------------------------------------------------------------
+TiXmlElement* ConfigWriter::Update::AddNode
+(
+	uint8 const _nodeId
+)
+{
+	// Node::WriteXML adds a Node element to its parent, so each node gets a
+	// parent of its own that the writer can keep without copying the node
+	delete m_nodes[_nodeId];
+	m_nodes[_nodeId] = new TiXmlElement( "Driver" );
+	m_present[_nodeId] = true;
+	return m_nodes[_nodeId];
+}
+
+//-----------------------------------------------------------------------------
+// <ConfigWriter::Update::AddValue>
+// Create the element that a changed value is written into
+//-----------------------------------------------------------------------------
+TiXmlElement* ConfigWriter::Update::AddValue
+(
+	ValueID const& _id
+)
+{
+	TiXmlElement* valueElement = new TiXmlElement( "Value" );
+	m_values.push_back( ValueChange( _id, valueElement ) );
+	return valueElement;
+}
+
+//-----------------------------------------------------------------------------
+// <ConfigWriter::ConfigWriter>
+// Constructor
+//-----------------------------------------------------------------------------
+ConfigWriter::ConfigWriter
+(
+):
+	m_thread( new Thread( "config" ) ),
+	m_mutex( new Mutex() ),
+	m_queueEvent( new Event() ),
+	m_idleEvent( new Event() ),
+	m_driverElement( NULL )
+{
+	memset( m_changedNodes, 0, sizeof(m_changedNodes) );
+	memset( m_savedNodes, 0, sizeof(m_savedNodes) );
+	memset( m_nodes, 0, sizeof(m_nodes) );
+
+	m_idleEvent->Set();
+	m_thread->Start( ConfigWriter::ThreadEntryPoint, this );
+}
+
+//-----------------------------------------------------------------------------
+// <ConfigWriter::~ConfigWriter>
+// Destructor
+//-----------------------------------------------------------------------------
+ConfigWriter::~ConfigWriter
+(
+)
+{
+	Flush();
+
+	m_thread->Stop();
+	m_thread->Release();
+
+	m_queueEvent->Release();
+	m_idleEvent->Release();
+	m_mutex->Release();
+
+	delete m_driverElement;
+	for( int i=0; i<256; ++i )
+	{
+		delete m_nodes[i];
+	}
+}
+
+//-----------------------------------------------------------------------------
+// <ConfigWriter::NodeChanged>
+// Record that a node must be written in full at the next save
+//-----------------------------------------------------------------------------
+void ConfigWriter::NodeChanged
+(
+	uint8 const _nodeId
+)
+{
+	m_mutex->Lock();
+	m_changedNodes[_nodeId] = true;
+	m_mutex->Unlock();
+}
+
+//-----------------------------------------------------------------------------
+// <ConfigWriter::ValueChanged>
+// Record that a value must be written at the next save
+//-----------------------------------------------------------------------------
+void ConfigWriter::ValueChanged
+(
+	ValueID const& _id
+)
+{
+	m_mutex->Lock();
+	if( !m_changedNodes[_id.GetNodeId()] )
+	{
+		m_changedValues.insert( _id );
+	}
+	m_mutex->Unlock();
+}
+
+//-----------------------------------------------------------------------------
+// <ConfigWriter::TakeChanges>
+// Collect the changes made since the previous save
+//-----------------------------------------------------------------------------
+void ConfigWriter::TakeChanges
+(
+	bool* _nodes,
+	set<ValueID>* _values
+)
+{
+	m_mutex->Lock();
+
+	// A node the writer has never been given in full cannot take single
+	// values, so it is written in full as well
+	for( int i=0; i<256; ++i )
+	{
+		_nodes[i] = m_changedNodes[i] || !m_savedNodes[i];
+	}
+
+	for( set<ValueID>::iterator it = m_changedValues.begin(); it != m_changedValues.end(); ++it )
+	{
+		if( !_nodes[it->GetNodeId()] )
+		{
+			_values->insert( *it );
+		}
+	}
+
+	memset( m_changedNodes, 0, sizeof(m_changedNodes) );
+	m_changedValues.clear();
+
+	m_mutex->Unlock();
+}
+
+//-----------------------------------------------------------------------------
+// <ConfigWriter::Queue>
+// Hand an update over to the writer thread
+//-----------------------------------------------------------------------------
+void ConfigWriter::Queue
+(
+	Update* _update
+)
+{
+	m_mutex->Lock();
+
+	for( int i=0; i<256; ++i )
+	{
+		m_savedNodes[i] = ( _update->m_nodes[i] != NULL ) || ( m_savedNodes[i] && _update->m_present[i] );
+	}
+
+	m_queue.push_back( _update );
+	m_idleEvent->Reset();
+	m_queueEvent->Set();
+
+	m_mutex->Unlock();
+}
+
+//-----------------------------------------------------------------------------
+// <ConfigWriter::Flush>
+// Wait until every queued update has been written
+//-----------------------------------------------------------------------------
+void ConfigWriter::Flush
+(
+)
+{
+	Wait::Single( m_idleEvent );
+}
+
+//-----------------------------------------------------------------------------
+// <ConfigWriter::ThreadEntryPoint>
+// Entry point of the thread that writes the configuration
+//-----------------------------------------------------------------------------
+void ConfigWriter::ThreadEntryPoint
+(
+	Event* _exitEvent,
+	void* _context
+)
+{
+	ConfigWriter* writer = (ConfigWriter*)_context;
+	if( writer )
+	{
+		writer->ThreadProc( _exitEvent );
+	}
+}
+
+//-----------------------------------------------------------------------------
+// <ConfigWriter::ThreadProc>
+// Merge queued updates and write the result, until told to exit
+//-----------------------------------------------------------------------------
+void ConfigWriter::ThreadProc
+(
+	Event* _exitEvent
+)
+{
+	while( true )
+	{
+		Wait* waitObjects[2];
+		waitObjects[0] = _exitEvent;
+		waitObjects[1] = m_queueEvent;
+		int32 res = Wait::Multiple( waitObjects, 2 );
+
+		list<Update*> updates;
+		m_mutex->Lock();
+		updates.swap( m_queue );
+		m_queueEvent->Reset();
+		m_mutex->Unlock();
+
+		if( updates.empty() )
+		{
+			if( res == 0 )
+			{
+				break;
+			}
+			continue;
+		}
+
+		// Several updates queued while the last save was in progress are
+		// merged and written once
+		for( list<Update*>::iterator it = updates.begin(); it != updates.end(); ++it )
+		{
+			Apply( *it );
+			delete *it;
+		}
+		Save();
+
+		m_mutex->Lock();
+		if( m_queue.empty() )
+		{
+			m_idleEvent->Set();
+		}
+		m_mutex->Unlock();
+	}
+}
+
+//-----------------------------------------------------------------------------
+// <ConfigWriter::Apply>
+// Merge an update into the writer's copy of the configuration
+//-----------------------------------------------------------------------------
+void ConfigWriter::Apply
+(
+	Update* _update
+)
+{
+	m_filename = _update->m_filename;
+	m_snapshotFile = _update->m_snapshotFile;
+
+	delete m_driverElement;
+	m_driverElement = _update->m_driverElement;
+	_update->m_driverElement = NULL;
+
+	for( int i=0; i<256; ++i )
+	{
+		if( _update->m_nodes[i] )
+		{
+			delete m_nodes[i];
+			m_nodes[i] = _update->m_nodes[i];
+			_update->m_nodes[i] = NULL;
+		}
+		else if( !_update->m_present[i] )
+		{
+			delete m_nodes[i];
+			m_nodes[i] = NULL;
+		}
+	}
+
+	for( list<Update::ValueChange>::iterator it = _update->m_values.begin(); it != _update->m_values.end(); ++it )
+	{
+		if( !ApplyValue( *it ) )
+		{
+			// Our copy of the node does not match, so ask for all of it next time
+			uint8 nodeId = it->m_id.GetNodeId();
+			Log::Write( LogLevel_Info, nodeId, "Config for node %d is out of date, it will be saved in full next time", nodeId );
+
+			m_mutex->Lock();
+			m_savedNodes[nodeId] = false;
+			m_mutex->Unlock();
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------
+// <ConfigWriter::ApplyValue>
+// Replace one Value element in the writer's copy of its node
+//-----------------------------------------------------------------------------
+bool ConfigWriter::ApplyValue
+(
+	Update::ValueChange const& _change
+)
+{
+	TiXmlElement* nodeElement = m_nodes[_change.m_id.GetNodeId()] ? m_nodes[_change.m_id.GetNodeId()]->FirstChildElement( "Node" ) : NULL;
+	TiXmlElement* ccsElement = nodeElement ? nodeElement->FirstChildElement( "CommandClasses" ) : NULL;
+	if( ccsElement == NULL )
+	{
+		return false;
+	}
+
+	int intVal;
+	for( TiXmlElement* ccElement = ccsElement->FirstChildElement( "CommandClass" ); ccElement; ccElement = ccElement->NextSiblingElement( "CommandClass" ) )
+	{
+		if( ( TIXML_SUCCESS != ccElement->QueryIntAttribute( "id", &intVal ) ) || ( intVal != _change.m_id.GetCommandClassId() ) )
+		{
+			continue;
+		}
+
+		for( TiXmlElement* valueElement = ccElement->FirstChildElement( "Value" ); valueElement; valueElement = valueElement->NextSiblingElement( "Value" ) )
+		{
+			if( ( TIXML_SUCCESS == valueElement->QueryIntAttribute( "instance", &intVal ) ) && ( intVal == _change.m_id.GetInstance() )
+				&& ( TIXML_SUCCESS == valueElement->QueryIntAttribute( "index", &intVal ) ) && ( intVal == _change.m_id.GetIndex() ) )
+			{
+				return( ccElement->ReplaceChild( valueElement, *_change.m_element ) != NULL );
+			}
+		}
+		break;
+	}
+
+	return false;
+}
+
+//-----------------------------------------------------------------------------
+// <ConfigWriter::Save>
+// Write the configuration to the side and rename it over the old file
+//-----------------------------------------------------------------------------
+void ConfigWriter::Save
+(
+)
+{
+	if( m_driverElement == NULL )
+	{
+		return;
+	}
+
+	TiXmlDocument doc;
+	doc.LinkEndChild( new TiXmlDeclaration( "1.0", "utf-8", "" ) );
+
+	TiXmlElement* driverElement = m_driverElement->Clone()->ToElement();
+	doc.LinkEndChild( driverElement );
+	for( int i=0; i<256; ++i )
+	{
+		if( m_nodes[i] && m_nodes[i]->FirstChildElement( "Node" ) )
+		{
+			driverElement->InsertEndChild( *m_nodes[i]->FirstChildElement( "Node" ) );
+		}
+	}
+
+	string tempFile = m_filename + ".tmp";
+	if( !doc.SaveFile( tempFile.c_str() ) || !FileOps::ReplaceFile( tempFile, m_filename ) )
+	{
+		Log::Write( LogLevel_Warning, "WARNING: Unable to save the configuration to %s", m_filename.c_str() );
+		remove( tempFile.c_str() );
+		return;
+	}
+
+	ConfigSnapshot::Write( doc, m_snapshotFile, m_filename );
+}
@@ -0,0 +1,141 @@
+//-----------------------------------------------------------------------------
+//
+//	ConfigWriter.h
+//
+//	Saves the network configuration on a background thread
+//
+//	SOFTWARE NOTICE AND LICENSE
+//
+//	This file is part of OpenZWave.
+//
+//	OpenZWave is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU Lesser General Public License as published
+//	by the Free Software Foundation, either version 3 of the License,
+//	or (at your option) any later version.
+//
+//	OpenZWave is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//	GNU Lesser General Public License for more details.
+//
+//	You should have received a copy of the GNU Lesser General Public License
+//	along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+
+#ifndef _ConfigWriter_H
+#define _ConfigWriter_H
+
+#include <string>
+#include <list>
+#include <set>
+
+#include "Defs.h"
+#include "value_classes/ValueID.h"
+
+class TiXmlElement;
+
+namespace OpenZWave
+{
+	class Thread;
+	class Mutex;
+	class Event;
+
+	/** \brief Saves the network configuration on a background thread.
+	 *
+	 * The driver records which nodes and values have changed since the last
+	 * save.  To save, it serializes only those, under the node lock, into an
+	 * Update and queues it here.  The writer thread merges each update into
+	 * its own copy of every node's XML, then writes the whole document to a
+	 * temporary file and renames it over zwcfg_*.xml.
+	 */
+	class ConfigWriter
+	{
+	public:
+		/** \brief The changes to the configuration since the previous save.
+		 */
+		class Update
+		{
+			friend class ConfigWriter;
+
+		public:
+			Update( string const& _filename, string const& _snapshotFile );
+			~Update();
+
+			/** The Driver element, for the driver's own attributes. */
+			TiXmlElement* GetDriverElement(){ return m_driverElement; }
+
+			/** An element for Node::WriteXML to add the whole node to. */
+			TiXmlElement* AddNode( uint8 const _nodeId );
+
+			/** Keep the node as it was in the previous save. */
+			void KeepNode( uint8 const _nodeId ){ m_present[_nodeId] = true; }
+
+			/** An element for Value::WriteXML to replace a single value with. */
+			TiXmlElement* AddValue( ValueID const& _id );
+
+		private:
+			struct ValueChange
+			{
+				ValueChange( ValueID const& _id, TiXmlElement* _element ): m_id( _id ), m_element( _element ){}
+
+				ValueID			m_id;
+				TiXmlElement*	m_element;
+			};
+
+			string				m_filename;
+			string				m_snapshotFile;
+			TiXmlElement*		m_driverElement;
+			TiXmlElement*		m_nodes[256];
+			bool				m_present[256];
+			list<ValueChange>	m_values;
+		};
+
+		ConfigWriter();
+		~ConfigWriter();
+
+		void NodeChanged( uint8 const _nodeId );
+		void ValueChanged( ValueID const& _id );
+
+		/**
+		 * Collect the changes made since the previous call.
+		 * \param _nodes Set for each node that must be written in full.
+		 * \param _values The values that have changed on the other nodes.
+		 */
+		void TakeChanges( bool* _nodes, set<ValueID>* _values );
+
+		/** Hand an update to the writer thread. */
+		void Queue( Update* _update );
+
+		/** Wait until every queued update has been written. */
+		void Flush();
+
+	private:
+		static void ThreadEntryPoint( Event* _exitEvent, void* _context );
+		void ThreadProc( Event* _exitEvent );
+
+		void Apply( Update* _update );
+		bool ApplyValue( Update::ValueChange const& _change );
+		void Save();
+
+		Thread*				m_thread;
+		Mutex*				m_mutex;
+		Event*				m_queueEvent;
+		Event*				m_idleEvent;
+
+		// Guarded by m_mutex
+		list<Update*>		m_queue;
+		bool				m_changedNodes[256];
+		bool				m_savedNodes[256];	// The writer thread holds the node in full
+		set<ValueID>		m_changedValues;
+
+		// Owned by the writer thread
+		string				m_filename;
+		string				m_snapshotFile;
+		TiXmlElement*		m_driverElement;
+		TiXmlElement*		m_nodes[256];		// Each holds one Node element
+	};
+
+} // namespace OpenZWave
+
+#endif //_ConfigWriter_H
@@ -179,6 +179,7 @@ namespace OpenZWave
 #define ACK_TIMEOUT	1000		// How long to wait for an ACK
 #define BYTE_TIMEOUT	150
 #define RETRY_TIMEOUT	40000		// Retry send after 40 seconds
+#define MULTICAST_CHECK_TIMEOUT	(3*RETRY_TIMEOUT)	// How long a multicast Set waits for each node to report its level
 
 #define SOF												0x01
 #define ACK												0x06
@@ -217,6 +218,7 @@ namespace OpenZWave
 
 #define FUNC_ID_ZW_SEND_NODE_INFORMATION				0x12
 #define FUNC_ID_ZW_SEND_DATA						0x13
+#define FUNC_ID_ZW_SEND_DATA_MULTI					0x14	// Send the same command to a list of nodes in one multicast frame
 #define FUNC_ID_ZW_GET_VERSION						0x15
 #define FUNC_ID_ZW_R_F_POWER_LEVEL_SET					0x17
 #define FUNC_ID_ZW_GET_RANDOM						0x1c
@@ -24,6 +24,7 @@
 //	along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
 //
 //-----------------------------------------------------------------------------
+#include <algorithm>
 #include "Defs.h"
 #include "Driver.h"
 #include "Options.h"
@@ -32,11 +33,15 @@
 #include "Msg.h"
 #include "Notification.h"
 #include "Scene.h"
+#include "ConfigSnapshot.h"
+#include "ConfigWriter.h"
 
 #include "platform/Event.h"
+#include "platform/WaitSet.h"
 #include "platform/Mutex.h"
 #include "platform/SerialController.h"
 #include "platform/HidController.h"
+#include "platform/SocketController.h"
 #include "platform/Thread.h"
 #include "platform/Log.h"
 #include "platform/TimeStamp.h"
@@ -47,12 +52,17 @@
 #include "command_classes/Security.h"
 #include "command_classes/WakeUp.h"
 #include "command_classes/SwitchAll.h"
+#include "command_classes/Basic.h"
+#include "command_classes/SwitchBinary.h"
+#include "command_classes/SwitchMultilevel.h"
 #include "command_classes/ManufacturerSpecific.h"
 #include "command_classes/NoOperation.h"
 
 #include "value_classes/ValueID.h"
 #include "value_classes/Value.h"
 #include "value_classes/ValueStore.h"
+#include "value_classes/ValueBool.h"
+#include "value_classes/ValueByte.h"
 
 #include "tinyxml.h"
 
@@ -141,6 +151,9 @@ Driver::Driver
 	m_awakeNodesQueried( false ),
 	m_allNodesQueried( false ),
 	m_notifytransactions( false ),
+	m_coalesceSets( false ),
+	m_multicastResend( false ),
+	m_configWriter( new ConfigWriter() ),
 	m_controllerInterfaceType( _interface ),
 	m_controllerPath( _controllerPath ),
 	m_controller( NULL ),
@@ -166,12 +179,16 @@ Driver::Driver
 	m_pollMutex( new Mutex() ),
 	m_pollInterval( 0 ),
 	m_bIntervalBetweenPolls( false ),				// if set to true (via SetPollInterval), the pollInterval will be interspersed between each poll (so a much smaller m_pollInterval like 100, 500, or 1,000 may be appropriate)
+	m_pollIdleEvent( new Event() ),
 	m_currentControllerCommand( NULL ),
 	m_SUCNodeId( 0 ),
 	m_controllerResetEvent( NULL ),
+	m_queueReady( 0 ),
+	m_queueEvent( new Event() ),
 	m_sendMutex( new Mutex() ),
 	m_currentMsg( NULL ),
 	m_virtualNeighborsReceived( false ),
+	m_multicastMutex( new Mutex() ),
 	m_notificationsEvent( new Event() ),
 	m_SOFCnt( 0 ),
 	m_ACKWaiting( 0 ),
@@ -198,11 +215,12 @@ Driver::Driver
 	// set a timestamp to indicate when this driver started
 	TimeStamp m_startTime;
 
-	// Create the message queue events
-	for( int32 i=0; i<MsgQueue_Count; ++i )
+	// Create the node locks
+	for( int32 i=0; i<NodeLockShards; ++i )
 	{
-		m_queueEvent[i] = new Event();
+		m_nodeLocks[i] = new Mutex();
 	}
+	memset( m_nodeLockContention, 0, sizeof(m_nodeLockContention) );
 
 	// Clear the nodes array
 	memset( m_nodes, 0, sizeof(Node*) * 256 );
@@ -214,6 +232,11 @@ Driver::Driver
 	{
 		m_controller = new HidController();
 	}
+	else if( SocketController::IsSocketPath( _controllerPath ) )
+	{
+		// tcp://host:port or unix:///path, e.g. a network bridge or a simulated stick
+		m_controller = new SocketController();
+	}
 	else
 	{
 		m_controller = new SerialController();
@@ -223,6 +246,8 @@ Driver::Driver
 	Options::Get()->GetOptionAsBool( "NotifyTransactions", &m_notifytransactions );
 	Options::Get()->GetOptionAsInt( "PollInterval", &m_pollInterval );
 	Options::Get()->GetOptionAsBool( "IntervalBetweenPolls", &m_bIntervalBetweenPolls );
+	Options::Get()->GetOptionAsBool( "CoalesceSetCommands", &m_coalesceSets );
+	Options::Get()->GetOptionAsBool( "MulticastResendSet", &m_multicastResend );
 }
 
 //-----------------------------------------------------------------------------
@@ -253,6 +278,7 @@ Driver::~Driver
 			Scene::WriteXML( "zwscene.xml" );
 		}
 	}
+	m_configWriter->Flush();
 
 	// The order of the statements below has been achieved by mitigating freed memory
 	//references using a memory allocator checker. Do not rearrange unless you are
@@ -261,11 +287,13 @@ Driver::~Driver
 
 	m_pollThread->Stop();
 	m_pollThread->Release();
+	m_pollIdleEvent->Release();
 
 	m_driverThread->Stop();
 	m_driverThread->Release();
 
 	m_sendMutex->Release();
+	m_multicastMutex->Release();
 
 	m_controller->Close();
 	m_controller->Release();
@@ -296,9 +324,9 @@ Driver::~Driver
 	// Clear the send Queue
 	for( int32 i=0; i<MsgQueue_Count; ++i )
 	{
-		while( !m_msgQueue[i].empty() )
+		while( !m_msgQueue[i].IsEmpty() )
 		{
-			MsgQueueItem const& item = m_msgQueue[i].front();
+			MsgQueueItem const& item = m_msgQueue[i].Front();
 			if( MsgQueueCmd_SendMsg == item.m_command )
 			{
 				delete item.m_msg;
@@ -307,11 +335,10 @@ Driver::~Driver
 			{
 				delete item.m_cci;
 			}
-			m_msgQueue[i].pop_front();
+			m_msgQueue[i].PopFront();
 		}
-
-		m_queueEvent[i]->Release();
 	}
+	m_queueEvent->Release();
 	/* Doing our Notification Call back here in the destructor is just asking for trouble
 	 * as there is a good chance that the application will do some sort of GetDriver() supported
 	 * method on the Manager Class, which by this time, most of the OZW Classes associated with the
@@ -329,9 +356,14 @@ Driver::~Driver
 		}
 	}
 	m_notificationsEvent->Release();
+	for( int32 i=0; i<NodeLockShards; ++i )
+	{
+		m_nodeLocks[i]->Release();
+	}
 	m_nodeMutex->Release();
 
 	delete m_controllerReplication;
+	delete m_configWriter;
 }
 
 //-----------------------------------------------------------------------------
@@ -377,19 +409,14 @@ void Driver::DriverThreadProc
 	{
 		if( Init( attempts ) )
 		{
-			// Driver has been initialised
-			Wait* waitObjects[11];
-			waitObjects[0] = _exitEvent;				// Thread must exit.
-			waitObjects[1] = m_notificationsEvent;			// Notifications waiting to be sent.
-			waitObjects[2] = m_controller;				// Controller has received data.
-			waitObjects[3] = m_queueEvent[MsgQueue_Command];	// A controller command is in progress.
-			waitObjects[4] = m_queueEvent[MsgQueue_Security];	// Security Related Commands (As they have a timeout)
-			waitObjects[5] = m_queueEvent[MsgQueue_NoOp];		// Send device probes and diagnostics messages
-			waitObjects[6] = m_queueEvent[MsgQueue_Controller];	// A multi-part controller command is in progress
-			waitObjects[7] = m_queueEvent[MsgQueue_WakeUp];		// A node has woken. Pending messages should be sent.
-			waitObjects[8] = m_queueEvent[MsgQueue_Send];		// Ordinary requests to be sent.
-			waitObjects[9] = m_queueEvent[MsgQueue_Query];		// Node queries are pending.
-			waitObjects[10] = m_queueEvent[MsgQueue_Poll];		// Poll request is waiting.
+			// Driver has been initialised.  The wait set watches every object
+			// once, so each pass round the loop below is allocation free.
+			// The order matters: Select returns the lowest signalled index.
+			WaitSet waitSet;
+			waitSet.Add( _exitEvent );				// 0: Thread must exit.
+			waitSet.Add( m_notificationsEvent );			// 1: Notifications waiting to be sent.
+			waitSet.Add( m_controller );				// 2: Controller has received data.
+			waitSet.Add( m_queueEvent );				// 3: A message queue has work.  Which one is taken from m_queueReady.
 
 			TimeStamp retryTimeStamp;
 			int retryTimeout = RETRY_TIMEOUT;
@@ -398,14 +425,19 @@ void Driver::DriverThreadProc
 			while( true )
 			{
 				Log::Write( LogLevel_StreamDetail, "      Top of DriverThreadProc loop." );
-				uint32 count = 11;
+				uint32 count = 4;
 				int32 timeout = Wait::Timeout_Infinite;
 
+				// The queues we may take the next message from, in priority order
+				// from the lowest bit
+				uint32 queues = ( 1u << MsgQueue_Count ) - 1;
+
 				// If we're waiting for a message to complete, we can only
 				// handle incoming data, notifications and exit events.
 				if( m_waitingForAck || m_expectedCallbackId || m_expectedReply )
 				{
 					count = 3;
+					queues = 0;
 					timeout = m_waitingForAck ? ACK_TIMEOUT : retryTimeStamp.TimeRemaining();
 					if( timeout < 0 )
 					{
@@ -414,15 +446,44 @@ void Driver::DriverThreadProc
 				}
 				else if( m_currentControllerCommand != NULL )
 				{
-					count = 7;
+					// Only the queues up to and including the controller queue
+					queues = ( 1u << MsgQueue_WakeUp ) - 1;
 				}
 				else
 				{
 					Log::QueueClear();							// clear the log queue when starting a new message
 				}
 
+				m_sendMutex->Lock();
+
+				// The queue event only stays signalled while one of the queues we
+				// may use has work.  Anything queued from now on sets it again.
+				if( m_queueReady & queues )
+				{
+					m_queueEvent->Set();
+				}
+				else
+				{
+					m_queueEvent->Reset();
+				}
+
+				// Let the poll thread know whether it may send the next poll
+				if( m_msgQueue[MsgQueue_Poll].IsEmpty()
+					&& m_msgQueue[MsgQueue_Send].IsEmpty()
+					&& m_msgQueue[MsgQueue_Command].IsEmpty()
+					&& m_msgQueue[MsgQueue_Query].IsEmpty()
+					&& m_currentMsg == NULL )
+				{
+					m_pollIdleEvent->Set();
+				}
+				else
+				{
+					m_pollIdleEvent->Reset();
+				}
+				m_sendMutex->Unlock();
+
 				// Wait for something to do
-				int32 res = Wait::Multiple( waitObjects, count, timeout );
+				int32 res = waitSet.Select( count, timeout );
 
 				switch( res )
 				{
@@ -459,10 +520,13 @@ void Driver::DriverThreadProc
 						ReadMsg();
 						break;
 					}
-					default:
+					case 3:
 					{
-						// All the other events are sending message queue items
-						if( WriteNextMsg( (MsgQueue)(res-3) ) )
+						// Send an item from the highest priority queue with work
+						m_sendMutex->Lock();
+						uint32 ready = m_queueReady & queues;
+						m_sendMutex->Unlock();
+						if( ready && WriteNextMsg( FirstReadyQueue( ready ) ) )
 						{
 							retryTimeStamp.SetTime( retryTimeout );
 						}
@@ -559,14 +623,15 @@ void Driver::RemoveQueues
 		RemoveCurrentMsg();
 	}
 
-	// Clear the send Queue
+	// Clear the send Queue, copying the items we keep down over the ones we remove
 	for( int32 i=0; i<MsgQueue_Count; ++i )
 	{
-		list<MsgQueueItem>::iterator it = m_msgQueue[i].begin();
-		while( it != m_msgQueue[i].end() )
+		Ring<MsgQueueItem>& queue = m_msgQueue[i];
+		uint32 kept = 0;
+		for( uint32 j=0; j<queue.GetSize(); ++j )
 		{
 			bool remove = false;
-			MsgQueueItem const& item = *it;
+			MsgQueueItem const& item = queue[j];
 			if( MsgQueueCmd_SendMsg == item.m_command && _nodeId == item.m_msg->GetTargetNodeId() )
 			{
 				delete item.m_msg;
@@ -581,18 +646,19 @@ void Driver::RemoveQueues
 				delete item.m_cci;
 				remove = true;
 			}
-			if( remove )
-			{
-				it = m_msgQueue[i].erase( it );
-			}
-			else
+			if( !remove )
 			{
-				++it;
+				if( kept != j )
+				{
+					queue[kept] = item;
+				}
+				++kept;
 			}
 		}
-		if( m_msgQueue[i].empty() )
+		queue.Truncate( kept );
+		if( queue.IsEmpty() )
 		{
-			m_queueEvent[i]->Reset();
+			ClearQueueReady( (MsgQueue)i );
 		}
 	}
 }
@@ -619,8 +685,13 @@ bool Driver::ReadConfig
 	snprintf( str, sizeof(str), "zwcfg_0x%08x.xml", m_homeId );
 	string filename =  userPath + string(str);
 
+	snprintf( str, sizeof(str), "zwcfg_0x%08x.bin", m_homeId );
+	string snapshotFile =  userPath + string(str);
+
+	// The binary snapshot holds the same document, and saves parsing the
+	// XML as long as nobody has changed that since it was written
 	TiXmlDocument doc;
-	if( !doc.LoadFile( filename.c_str(), TIXML_ENCODING_UTF8 ) )
+	if( !ConfigSnapshot::Read( snapshotFile, filename, &doc ) && !doc.LoadFile( filename.c_str(), TIXML_ENCODING_UTF8 ) )
 	{
 		return false;
 	}
@@ -721,7 +792,9 @@ bool Driver::ReadConfig
 
 	ReleaseNodes();
 
-	// restore the previous state (for now, polling) for the nodes/values just retrieved
+	// restore the previous state (for now, polling) for the nodes/values just retrieved,
+	// enabling all the values with the same intensity in one go
+	map<uint8,vector<ValueID> > polled;
 	for( int i=0; i<256; i++ )
 	{
 		if( m_nodes[i] != NULL )
@@ -731,10 +804,14 @@ bool Driver::ReadConfig
 			{
 				Value* value = it->second;
 				if( value->m_pollIntensity != 0 )
-					EnablePoll( value->GetID(), value->m_pollIntensity );
+					polled[value->m_pollIntensity].push_back( value->GetID() );
 			}
 		}
 	}
+	for( map<uint8,vector<ValueID> >::iterator it = polled.begin(); it != polled.end(); ++it )
+	{
+		EnablePoll( it->second, it->first );
+	}
 
 	return true;
 }
@@ -754,12 +831,20 @@ void Driver::WriteConfig
 		return;
 	}
 
-	// Create a new XML document to contain the driver configuration
-	TiXmlDocument doc;
-	TiXmlDeclaration* decl = new TiXmlDeclaration( "1.0", "utf-8", "" );
-	TiXmlElement* driverElement = new TiXmlElement( "Driver" );
-	doc.LinkEndChild( decl );
-	doc.LinkEndChild( driverElement );
+	string userPath;
+	Options::Get()->GetOptionAsString( "UserPath", &userPath );
+
+	snprintf( str, sizeof(str), "zwcfg_0x%08x.xml", m_homeId );
+	string filename =  userPath + string(str);
+
+	snprintf( str, sizeof(str), "zwcfg_0x%08x.bin", m_homeId );
+	string snapshotFile =  userPath + string(str);
+
+	// The update carries the driver's attributes, and the nodes and values
+	// that have changed since the last save.  The config writer keeps the
+	// rest from earlier saves, and writes the file on its own thread.
+	ConfigWriter::Update* update = new ConfigWriter::Update( filename, snapshotFile );
+	TiXmlElement* driverElement = update->GetDriverElement();
 
 	driverElement->SetAttribute( "xmlns", "http://code.google.com/p/open-zwave/" );
 
@@ -784,23 +869,67 @@ void Driver::WriteConfig
 	snprintf( str, sizeof(str), "%d", (int) m_bIntervalBetweenPolls );
 	driverElement->SetAttribute( "poll_interval_between", str );
 
+	bool changedNodes[256];
+	set<ValueID> changedValues;
+	m_configWriter->TakeChanges( changedNodes, &changedValues );
+
+	int32 nodeCount = 0;
 	LockNodes();
 	for( int i=0; i<256; ++i )
 	{
 		if( m_nodes[i] )
 		{
-			m_nodes[i]->WriteXML( driverElement );
+			if( changedNodes[i] )
+			{
+				m_nodes[i]->WriteXML( update->AddNode( i ) );
+				++nodeCount;
+			}
+			else
+			{
+				update->KeepNode( i );
+			}
+		}
+	}
+
+	for( set<ValueID>::iterator it = changedValues.begin(); it != changedValues.end(); ++it )
+	{
+		if( Node* node = m_nodes[it->GetNodeId()] )
+		{
+			if( Value* value = node->GetValue( *it ) )
+			{
+				value->WriteXML( update->AddValue( *it ) );
+				value->Release();
+			}
 		}
 	}
 	ReleaseNodes();
 
-	string userPath;
-	Options::Get()->GetOptionAsString( "UserPath", &userPath );
+	Log::Write( LogLevel_Detail, "Saving configuration: %d nodes and %d values changed", nodeCount, (int32)changedValues.size() );
+	m_configWriter->Queue( update );
+}
 
-	snprintf( str, sizeof(str), "zwcfg_0x%08x.xml", m_homeId );
-	string filename =  userPath + string(str);
+//-----------------------------------------------------------------------------
+// <Driver::NodeConfigChanged>
+// Record that a node must be written in full at the next save
+//-----------------------------------------------------------------------------
+void Driver::NodeConfigChanged
+(
+	uint8 const _nodeId
+)
+{
+	m_configWriter->NodeChanged( _nodeId );
+}
 
-	doc.SaveFile( filename.c_str() );
+//-----------------------------------------------------------------------------
+// <Driver::ValueConfigChanged>
+// Record that a value must be written at the next save
+//-----------------------------------------------------------------------------
+void Driver::ValueConfigChanged
+(
+	ValueID const& _id
+)
+{
+	m_configWriter->ValueChanged( _id );
 }
 
 //-----------------------------------------------------------------------------
@@ -851,7 +980,20 @@ void Driver::LockNodes
 (
 )
 {
-	m_nodeMutex->Lock();
+	// Always the array lock first, then every shard in ascending order
+	if( !m_nodeMutex->Lock( false ) )
+	{
+		m_nodeMutex->Lock();
+		++m_nodeLockContention[NodeLockShards];
+	}
+	for( int32 i=0; i<NodeLockShards; ++i )
+	{
+		if( !m_nodeLocks[i]->Lock( false ) )
+		{
+			m_nodeLocks[i]->Lock();
+			++m_nodeLockContention[i];
+		}
+	}
 }
 
 //-----------------------------------------------------------------------------
@@ -862,9 +1004,60 @@ void Driver::ReleaseNodes
 (
 )
 {
+	for( int32 i=NodeLockShards-1; i>=0; --i )
+	{
+		m_nodeLocks[i]->Unlock();
+	}
 	m_nodeMutex->Unlock();
 }
 
+//-----------------------------------------------------------------------------
+// <Driver::LockNode>
+// Lock a single node so that no other thread can modify it
+//-----------------------------------------------------------------------------
+void Driver::LockNode
+(
+	uint8 const _nodeId
+)
+{
+	uint8 shard = _nodeId % NodeLockShards;
+	if( !m_nodeLocks[shard]->Lock( false ) )
+	{
+		m_nodeLocks[shard]->Lock();
+		++m_nodeLockContention[shard];
+	}
+}
+
+//-----------------------------------------------------------------------------
+// <Driver::ReleaseNode>
+// Unlock a single node so that other threads can modify it
+//-----------------------------------------------------------------------------
+void Driver::ReleaseNode
+(
+	uint8 const _nodeId
+)
+{
+	m_nodeLocks[_nodeId % NodeLockShards]->Unlock();
+}
+
+//-----------------------------------------------------------------------------
+// <Driver::GetNodeLockContention>
+// Total number of contended node lock acquisitions
+//-----------------------------------------------------------------------------
+uint32 Driver::GetNodeLockContention
+(
+)const
+{
+	// Each count is only written under its own lock, so this sum is a
+	// snapshot that may be slightly stale, which is fine for statistics.
+	uint32 total = 0;
+	for( int32 i=0; i<=NodeLockShards; ++i )
+	{
+		total += m_nodeLockContention[i];
+	}
+	return total;
+}
+
 //-----------------------------------------------------------------------------
 //	Sending Z-Wave messages
 //-----------------------------------------------------------------------------
@@ -906,8 +1099,9 @@ void Driver::SendQueryStageComplete
 		// Non-sleeping node
 		Log::Write( LogLevel_Detail, node->GetNodeId(), "Queuing (%s) Query Stage Complete (%s)", c_sendQueueNames[MsgQueue_Query], node->GetQueryStageName( _stage ).c_str() );
 		m_sendMutex->Lock();
-		m_msgQueue[MsgQueue_Query].push_back( item );
-		m_queueEvent[MsgQueue_Query]->Set();
+		m_msgQueue[MsgQueue_Query].PushBack( item );
+		SetQueueReady( MsgQueue_Query );
+		m_pollIdleEvent->Reset();
 		m_sendMutex->Unlock();
 
 		ReleaseNodes();
@@ -931,11 +1125,12 @@ void Driver::RetryQueryStageComplete
 
 	m_sendMutex->Lock();
 
-	for( list<MsgQueueItem>::iterator it = m_msgQueue[MsgQueue_Query].begin(); it != m_msgQueue[MsgQueue_Query].end(); ++it )
+	Ring<MsgQueueItem>& queue = m_msgQueue[MsgQueue_Query];
+	for( uint32 i=0; i<queue.GetSize(); ++i )
 	{
-		if( *it == item )
+		if( queue[i] == item )
 		{
-			(*it).m_retry = true;
+			queue[i].m_retry = true;
 			break;
 		}
 	}
@@ -958,8 +1153,11 @@ void Driver::SendMsg
 	item.m_msg = _msg;
 	_msg->Finalize();
 
-
-	if( Node* node = GetNode(_msg->GetTargetNodeId()) )
+	// Only the target node is locked, so queuing a message does not wait
+	// behind work on unrelated nodes.
+	uint8 nodeId = _msg->GetTargetNodeId();
+	LockNode( nodeId );
+	if( Node* node = GetNodeUnsafe( nodeId ) )
 	{
 		// If the message is for a sleeping node, we queue it in the node itself.
 		if( !node->IsListeningDevice() )
@@ -979,12 +1177,12 @@ void Driver::SendMsg
 						item.m_msg = NULL;
 						UpdateControllerState( ControllerState_Sleeping );
 					}
-					else
+					else if( Log::IsLevelEnabled( LogLevel_Detail ) )
 					{
 						Log::Write( LogLevel_Detail, GetNodeNumber( _msg ), "Queuing (%s) %s", c_sendQueueNames[MsgQueue_WakeUp], _msg->GetAsString().c_str() );
 					}
 					wakeUp->QueueMsg( item );
-					ReleaseNodes();
+					ReleaseNode( nodeId );
 					return;
 				}
 			}
@@ -998,20 +1196,135 @@ void Driver::SendMsg
 			{
 				Log::Write( LogLevel_Detail, GetNodeNumber( _msg ), "Encrypting Message For Command Class %s", cc->GetCommandClassName().c_str());
 				security->SendMsg(_msg);
-				ReleaseNodes();
+				ReleaseNode( nodeId );
 				return;
 			}
 		}
-		ReleaseNodes();
 	}
+	ReleaseNode( nodeId );
 
-	Log::Write( LogLevel_Detail, GetNodeNumber( _msg ), "Queuing (%s) %s", c_sendQueueNames[_queue], _msg->GetAsString().c_str() );
+	if( Log::IsLevelEnabled( LogLevel_Detail ) )
+	{
+		Log::Write( LogLevel_Detail, GetNodeNumber( _msg ), "Queuing (%s) %s", c_sendQueueNames[_queue], _msg->GetAsString().c_str() );
+	}
 	m_sendMutex->Lock();
-	m_msgQueue[_queue].push_back( item );
-	m_queueEvent[_queue]->Set();
+	if( m_coalesceSets && CoalesceMsg( _msg, _queue ) )
+	{
+		m_sendMutex->Unlock();
+		return;
+	}
+	m_msgQueue[_queue].PushBack( item );
+	SetQueueReady( _queue );
+	m_pollIdleEvent->Reset();								// the driver thread sets it again once the queues drain
 	m_sendMutex->Unlock();
 }
 
+//-----------------------------------------------------------------------------
+// <Driver::CoalesceMsg>
+// Let a new message take the place of a queued one that it makes redundant.
+// A Set replaces an earlier Set of the same value, keeping its position in
+// the queue, and a Get is dropped if an identical one is already waiting
+// behind the last queued Set of the same command class on that node.
+//-----------------------------------------------------------------------------
+bool Driver::CoalesceMsg
+(
+	Msg* _msg,
+	MsgQueue const _queue
+)
+{
+	// Scan from the back, so a request is only matched against those queued
+	// after the last Set it has to follow.
+	Ring<MsgQueueItem>& queue = m_msgQueue[_queue];
+	for( uint32 i=queue.GetSize(); i-- > 0; )
+	{
+		MsgQueueItem* it = &queue[i];
+		if( MsgQueueCmd_SendMsg != it->m_command )
+		{
+			continue;
+		}
+
+		if( _msg->Supersedes( *it->m_msg ) )
+		{
+			Log::Write( LogLevel_Detail, GetNodeNumber( _msg ), "Replacing queued (%s) %s", c_sendQueueNames[_queue], _msg->GetLogText().c_str() );
+			delete it->m_msg;
+			it->m_msg = _msg;
+			return true;
+		}
+
+		if( _msg->GetExpectedCommandClassId() && ( (*_msg) == (*it->m_msg) ) )
+		{
+			// The report for the queued request will answer this one too
+			Log::Write( LogLevel_Detail, GetNodeNumber( _msg ), "Dropping duplicate (%s) %s", c_sendQueueNames[_queue], _msg->GetLogText().c_str() );
+			delete _msg;
+			return true;
+		}
+
+		if( _msg->GetExpectedCommandClassId() && it->m_msg->SetsCommandClass( _msg->GetTargetNodeId(), _msg->GetExpectedCommandClassId() ) )
+		{
+			// Any earlier request would report the state from before this
+			// Set, so the new one must stay behind it.
+			break;
+		}
+	}
+
+	return false;
+}
+
+//-----------------------------------------------------------------------------
+// <Driver::SendMulticast>
+// Queue one FUNC_ID_ZW_SEND_DATA_MULTI frame carrying a command for a list of nodes
+//-----------------------------------------------------------------------------
+bool Driver::SendMulticast
+(
+	char const* _logText,
+	vector<uint8> const& _nodeIds,
+	uint8 const* _command,
+	uint8 const _length
+)
+{
+	if( ( _nodeIds.size() < 2 ) || !IsAPICallSupported( FUNC_ID_ZW_SEND_DATA_MULTI ) )
+	{
+		return false;
+	}
+
+	// The controller is the target as far as the send queue is concerned
+	Msg* msg = new Msg( _logText, 0xff, REQUEST, FUNC_ID_ZW_SEND_DATA_MULTI, true );
+	msg->Append( (uint8)_nodeIds.size() );
+	for( vector<uint8>::const_iterator it = _nodeIds.begin(); it != _nodeIds.end(); ++it )
+	{
+		msg->Append( *it );
+	}
+	msg->Append( _length );
+	for( uint8 i=0; i<_length; ++i )
+	{
+		msg->Append( _command[i] );
+	}
+	msg->Append( GetTransmitOptions() );
+	SendMsg( msg, MsgQueue_Send );
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+// <Driver::FirstReadyQueue>
+// The highest priority queue of those whose bits are set in _ready
+//-----------------------------------------------------------------------------
+Driver::MsgQueue Driver::FirstReadyQueue
+(
+	uint32 const _ready
+)
+{
+#if defined(__GNUC__)
+	return (MsgQueue)__builtin_ctz( _ready );
+#else
+	uint32 queue = 0;
+	while( !( _ready & ( 1u << queue ) ) )
+	{
+		++queue;
+	}
+	return (MsgQueue)queue;
+#endif
+}
+
 //-----------------------------------------------------------------------------
 // <Driver::WriteNextMsg>
 // Transmit a queued message to the Z-Wave controller
@@ -1024,17 +1337,23 @@ bool Driver::WriteNextMsg
 
 	// There are messages to send, so get the one at the front of the queue
 	m_sendMutex->Lock();
-	MsgQueueItem item = m_msgQueue[_queue].front();
+	if( m_msgQueue[_queue].IsEmpty() )
+	{
+		ClearQueueReady( _queue );
+		m_sendMutex->Unlock();
+		return false;
+	}
+	MsgQueueItem item = m_msgQueue[_queue].Front();
 
 	if( MsgQueueCmd_SendMsg == item.m_command )
 	{
 		// Send a message
 		m_currentMsg = item.m_msg;
 		m_currentMsgQueueSource = _queue;
-		m_msgQueue[_queue].pop_front();
-		if( m_msgQueue[_queue].empty() )
+		m_msgQueue[_queue].PopFront();
+		if( m_msgQueue[_queue].IsEmpty() )
 		{
-			m_queueEvent[_queue]->Reset();
+			ClearQueueReady( _queue );
 		}
 		m_sendMutex->Unlock();
 		return WriteMsg( "WriteNextMsg" );
@@ -1045,10 +1364,10 @@ bool Driver::WriteNextMsg
 		// Move to the next query stage
 		m_currentMsg = NULL;
 		Node::QueryStage stage = item.m_queryStage;
-		m_msgQueue[_queue].pop_front();
-		if( m_msgQueue[_queue].empty() )
+		m_msgQueue[_queue].PopFront();
+		if( m_msgQueue[_queue].IsEmpty() )
 		{
-			m_queueEvent[_queue]->Reset();
+			ClearQueueReady( _queue );
 		}
 		m_sendMutex->Unlock();
 
@@ -1074,10 +1393,10 @@ bool Driver::WriteNextMsg
 		if ( m_currentControllerCommand->m_controllerCommandDone )
 		{
 			m_sendMutex->Lock();
-			m_msgQueue[_queue].pop_front();
-			if( m_msgQueue[_queue].empty() )
+			m_msgQueue[_queue].PopFront();
+			if( m_msgQueue[_queue].IsEmpty() )
 			{
-				m_queueEvent[_queue]->Reset();
+				ClearQueueReady( _queue );
 			}
 			m_sendMutex->Unlock();
 			if( m_currentControllerCommand->m_controllerCallback )
@@ -1105,7 +1424,7 @@ bool Driver::WriteNextMsg
 		{
 			Log::Write( LogLevel_Info, "WriteNextMsg Controller nothing to do" );
 			m_sendMutex->Lock();
-			m_queueEvent[_queue]->Reset();
+			ClearQueueReady( _queue );
 			m_sendMutex->Unlock();
 		}
 		return true;
@@ -1137,7 +1456,8 @@ bool Driver::WriteMsg
 
 	uint8 attempts = m_currentMsg->GetSendAttempts();
 	uint8 nodeId = m_currentMsg->GetTargetNodeId();
-	Node* node = GetNode( nodeId );
+	LockNode( nodeId );
+	Node* node = GetNodeUnsafe( nodeId );
 	if( attempts >= m_currentMsg->GetMaxSendAttempts() || (node != NULL && !node->IsNodeAlive() && !m_currentMsg->IsNoOperation() ) )
 	{
 		if( node != NULL && !node->IsNodeAlive() )
@@ -1151,10 +1471,7 @@ bool Driver::WriteMsg
 		}
 		RemoveCurrentMsg();
 		m_dropped++;
-		if( node != NULL )
-		{
-		    	ReleaseNodes();
-		}
+		ReleaseNode( nodeId );
 		return false;
 	}
 
@@ -1184,7 +1501,10 @@ bool Driver::WriteMsg
 	}
 
 	Log::Write( LogLevel_Detail, "" );
-	Log::Write( LogLevel_Info, nodeId, "Sending (%s) message (%sCallback ID=0x%.2x, Expected Reply=0x%.2x) - %s", c_sendQueueNames[m_currentMsgQueueSource], attemptsstr.c_str(), m_expectedCallbackId, m_expectedReply, m_currentMsg->GetAsString().c_str() );
+	if( Log::IsLevelEnabled( LogLevel_Info ) )
+	{
+		Log::Write( LogLevel_Info, nodeId, "Sending (%s) message (%sCallback ID=0x%.2x, Expected Reply=0x%.2x) - %s", c_sendQueueNames[m_currentMsgQueueSource], attemptsstr.c_str(), m_expectedCallbackId, m_expectedReply, m_currentMsg->GetAsString().c_str() );
+	}
 
 	m_controller->Write( m_currentMsg->GetBuffer(), m_currentMsg->GetLength() );
 	m_writeCnt++;
@@ -1209,10 +1529,7 @@ bool Driver::WriteMsg
 			}
 		}
 	}
-	if( node != NULL )
-	{
-		ReleaseNodes();
-	}
+	ReleaseNode( nodeId );
 
 	return true;
 }
@@ -1304,13 +1621,15 @@ bool Driver::MoveMessagesToWakeUpQueue
 					}
 
 					// Now the message queues
+					// Items that stay are copied down over the ones that move.
 					for( int i=0; i<MsgQueue_Count; ++i )
 					{
-						list<MsgQueueItem>::iterator it = m_msgQueue[i].begin();
-						while( it != m_msgQueue[i].end() )
+						Ring<MsgQueueItem>& queue = m_msgQueue[i];
+						uint32 kept = 0;
+						for( uint32 j=0; j<queue.GetSize(); ++j )
 						{
 							bool remove = false;
-							MsgQueueItem const& item = *it;
+							MsgQueueItem const& item = queue[j];
 							if( MsgQueueCmd_SendMsg == item.m_command )
 							{
 								if( _targetNodeId == item.m_msg->GetTargetNodeId() )
@@ -1349,20 +1668,21 @@ bool Driver::MoveMessagesToWakeUpQueue
 								}
 							}
 
-							if( remove )
-							{
-								it = m_msgQueue[i].erase( it );
-							}
-							else
+							if( !remove )
 							{
-								++it;
+								if( kept != j )
+								{
+									queue[kept] = item;
+								}
+								++kept;
 							}
 						}
+						queue.Truncate( kept );
 
-						// If the queue is now empty, we need to clear its event
-						if( m_msgQueue[i].empty() )
+						// If the queue is now empty, there is nothing more to send from it
+						if( queue.IsEmpty() )
 						{
-							m_queueEvent[i]->Reset();
+							ClearQueueReady( (MsgQueue)i );
 						}
 					}
 
@@ -1374,8 +1694,8 @@ bool Driver::MoveMessagesToWakeUpQueue
 						item.m_command = MsgQueueCmd_Controller;
 						item.m_cci = new ControllerCommandItem( *m_currentControllerCommand );
 						m_currentControllerCommand = item.m_cci;
-						m_msgQueue[MsgQueue_Controller].push_back( item );
-						m_queueEvent[MsgQueue_Controller]->Set();
+						m_msgQueue[MsgQueue_Controller].PushBack( item );
+						SetQueueReady( MsgQueue_Controller );
 					}
 
 					m_sendMutex->Unlock();
@@ -1568,15 +1888,14 @@ bool Driver::ReadMsg
 (
 )
 {
-	uint8 buffer[1024] = {0};
-
-	if( !m_controller->Read( buffer, 1 ) )
+	uint8 frameType;
+	if( !m_controller->Read( &frameType, 1 ) )
 	{
 		// Nothing to read
 		return false;
 	}
 
-	switch( buffer[0] )
+	switch( frameType )
 	{
 		case SOF:
 		{
@@ -1600,49 +1919,56 @@ bool Driver::ReadMsg
 				break;
 			}
 
-			m_controller->Read( &buffer[1], 1 );
-			m_controller->SetSignalThreshold( buffer[1] );
+			// The length byte stays in the stream, so that the whole frame after
+			// the SOF can be taken in one piece once it has all arrived.
+			uint8 scratch[256 + Stream::ViewPadding];
+			uint8* frame = m_controller->GetView( 1, scratch );
+			uint32 frameSize = frame[0] + 1;		// length byte, then the data and checksum it counts
+			m_controller->SetSignalThreshold( frameSize );
 			if( Wait::Single( m_controller, 500 ) < 0 )
 			{
 				Log::Write( LogLevel_Warning, "WARNING: 500ms passed without reading the rest of the frame...aborting frame read" );
 				m_readAborts++;
+				m_controller->Skip( 1 );
 				m_controller->SetSignalThreshold( 1 );
 				break;
 			}
-
-			m_controller->Read( &buffer[2], buffer[1] );
 			m_controller->SetSignalThreshold( 1 );
 
-			uint32 length = buffer[1] + 2;
-
-			// Log the data
-			string str = "";
-			for( uint32 i=0; i<length; ++i )
-			{
-				if( i )
-				{
-					str += ", ";
-				}
+			// Unless the frame wraps round the end of the stream buffer, or the
+			// next one has already arrived behind it, this refers to it in place,
+			// so it is checked, logged and processed without a copy.  The handlers
+			// read fields at fixed offsets and rely on the bytes after a short
+			// frame being zero, so the view is followed by zero padding, and the
+			// stream stays locked until the frame is released.
+			frame = m_controller->GetPaddedView( frameSize, scratch );
 
-				char byteStr[8];
-				snprintf( byteStr, sizeof(byteStr), "0x%.2x", buffer[i] );
-				str += byteStr;
-			}
-			uint8 nodeId = NodeFromMessage( buffer );
+			uint8 nodeId = NodeFromMessage( frame );
 			if( nodeId == 0 )
 			{
 				nodeId = GetNodeNumber( m_currentMsg );
 			}
-			Log::Write( LogLevel_Detail, nodeId, "  Received: %s", str.c_str() );
 
-			// Verify checksum
+			// Verify checksum (it covers the length byte and the data)
 			uint8 checksum = 0xff;
-			for( uint32 i=1; i<(length-1); ++i )
+			for( uint32 i=0; i<(frameSize-1); ++i )
+			{
+				checksum ^= frame[i];
+			}
+
+			// Log the data
+			if( Log::IsLevelEnabled( LogLevel_Detail ) )
 			{
-				checksum ^= buffer[i];
+				char str[257*6];
+				uint32 pos = snprintf( str, sizeof(str), "0x%.2x", SOF );
+				for( uint32 i=0; i<frameSize; ++i )
+				{
+					pos += snprintf( &str[pos], sizeof(str)-pos, ", 0x%.2x", frame[i] );
+				}
+				Log::Write( LogLevel_Detail, nodeId, "  Received: %s", str );
 			}
 
-			if( buffer[length-1] == checksum )
+			if( frame[frameSize-1] == checksum )
 			{
 				// Checksum correct - send ACK
 				uint8 ack = ACK;
@@ -1650,7 +1976,8 @@ bool Driver::ReadMsg
 				m_readCnt++;
 
 				// Process the received message
-				ProcessMsg( &buffer[2] );
+				ProcessMsg( &frame[1] );
+				m_controller->ReleaseView( frameSize );
 			}
 			else
 			{
@@ -1658,6 +1985,7 @@ bool Driver::ReadMsg
 				m_badChecksum++;
 				uint8 nak = NAK;
 				m_controller->Write( &nak, 1 );
+				m_controller->ReleaseView( frameSize );
 				m_controller->Purge();
 			}
 			break;
@@ -1715,7 +2043,7 @@ bool Driver::ReadMsg
 
 		default:
 		{
-			Log::Write( LogLevel_Warning, "WARNING: Out of frame flow! (0x%.2x).  Sending NAK.", buffer[0] );
+			Log::Write( LogLevel_Warning, "WARNING: Out of frame flow! (0x%.2x).  Sending NAK.", frameType );
 			m_OOFCnt++;
 			uint8 nak = NAK;
 			m_controller->Write( &nak, 1 );
@@ -1773,6 +2101,12 @@ void Driver::ProcessMsg
 				handleCallback = false;			// Skip the callback handling - a subsequent FUNC_ID_ZW_SEND_DATA request will deal with that
 				break;
 			}
+			case FUNC_ID_ZW_SEND_DATA_MULTI:
+			{
+				HandleSendDataMultiResponse( _data );
+				handleCallback = false;			// Skip the callback handling - a subsequent FUNC_ID_ZW_SEND_DATA_MULTI request will deal with that
+				break;
+			}
 			case FUNC_ID_ZW_GET_VERSION:
 			{
 				Log::Write( LogLevel_Detail, "" );
@@ -1983,6 +2317,11 @@ void Driver::ProcessMsg
 				HandleSendDataRequest( _data, false );
 				break;
 			}
+			case FUNC_ID_ZW_SEND_DATA_MULTI:
+			{
+				HandleSendDataMultiRequest( _data );
+				break;
+			}
 			case FUNC_ID_ZW_REPLICATION_COMMAND_COMPLETE:
 			{
 				if( m_controllerReplication )
@@ -2871,6 +3210,61 @@ void Driver::HandleSendDataRequest
 	}
 }
 
+//-----------------------------------------------------------------------------
+// <Driver::HandleSendDataMultiResponse>
+// Process a response from the Z-Wave PC interface
+//-----------------------------------------------------------------------------
+void Driver::HandleSendDataMultiResponse
+(
+	uint8* _data
+)
+{
+	if( _data[2] )
+	{
+		Log::Write( LogLevel_Detail, "  ZW_SEND_DATA_MULTI delivered to Z-Wave stack" );
+	}
+	else
+	{
+		Log::Write( LogLevel_Error, "ERROR: ZW_SEND_DATA_MULTI could not be delivered to Z-Wave stack" );
+		m_nondelivery++;
+
+		// The stick will not send a callback for a frame it refused, so end
+		// the transaction now rather than waiting out the retry timeout.  The
+		// frame is dropped, since each node is followed up on its own anyway.
+		RemoveCurrentMsg();
+		m_dropped++;
+	}
+}
+
+//-----------------------------------------------------------------------------
+// <Driver::HandleSendDataMultiRequest>
+// Process a request from the Z-Wave PC interface
+//-----------------------------------------------------------------------------
+void Driver::HandleSendDataMultiRequest
+(
+	uint8* _data
+)
+{
+	Log::Write( LogLevel_Detail, "  ZW_SEND_DATA_MULTI Request with callback ID 0x%.2x received (expected 0x%.2x)", _data[2], m_expectedCallbackId );
+
+	if( _data[2] != m_expectedCallbackId )
+	{
+		// Wrong callback ID
+	  	m_callbacks++;
+		Log::Write( LogLevel_Warning, "WARNING: Unexpected Callback ID received" );
+	}
+	else
+	{
+		// Multicast is not acknowledged by the nodes, so this only tells us
+		// whether the frame went out.  The senders follow up with each node.
+		if( _data[3] != 0 )
+		{
+			HandleErrorResponse( _data[3], 0xff, "ZW_SEND_DATA_MULTI" );
+		}
+		m_expectedCallbackId = 0;
+	}
+}
+
 //-----------------------------------------------------------------------------
 // <Driver::HandleNetworkUpdateRequest>
 // Process a response from the Z-Wave PC interface
@@ -3297,15 +3691,23 @@ void Driver::HandleApplicationCommandHandlerRequest
 	{
 		node->m_receivedCnt++;
 		node->m_errors = 0;
-		int cmp = memcmp( _data, node->m_lastReceivedMessage, sizeof(node->m_lastReceivedMessage));
-		if( cmp == 0 && node->m_receivedTS.TimeRemaining() > -500 )
+		// Only the bytes of this frame are compared and kept: type, function,
+		// status, node, command length and the command itself.
+		uint32 length = 5 + (uint32)_data[4];
+		if( length > sizeof(node->m_lastReceivedMessage) )
+		{
+			length = sizeof(node->m_lastReceivedMessage);
+		}
+		int cmp = memcmp( _data, node->m_lastReceivedMessage, length );
+		if( cmp == 0 && node->m_receivedTS.TimeRemaining() > -500 )
 		{
 			// if the exact same sequence of bytes are received within 500ms
 			node->m_receivedDups++;
 		}
 		else
 		{
-			memcpy( node->m_lastReceivedMessage, _data, sizeof(node->m_lastReceivedMessage) );
+			memcpy( node->m_lastReceivedMessage, _data, length );
+			memset( &node->m_lastReceivedMessage[length], 0, sizeof(node->m_lastReceivedMessage) - length );
 		}
 		node->m_receivedTS.SetTime();
 		if( m_expectedReply == FUNC_ID_APPLICATION_COMMAND_HANDLER && m_expectedNodeId == nodeId )
@@ -3760,6 +4162,115 @@ bool Driver::EnablePoll
 	uint8 const _intensity
 )
 {
+	vector<ValueID> valueIds( 1, _valueId );
+	return EnablePoll( valueIds, _intensity );
+}
+
+//-----------------------------------------------------------------------------
+// <Driver::EnablePoll>
+// Enable polling of several values, taking the locks only once
+//-----------------------------------------------------------------------------
+bool Driver::EnablePoll
+(
+	vector<ValueID> const& _valueIds,
+	uint8 const _intensity
+)
+{
+	bool res = true;
+	vector<uint8> enabled;
+
+	// make sure the polling thread doesn't lock the node while we're in this function
+	m_pollMutex->Lock();
+	LockNodes();
+
+	for( vector<ValueID>::const_iterator vit = _valueIds.begin(); vit != _valueIds.end(); ++vit )
+	{
+		ValueID const& valueId = *vit;
+
+		// confirm that this node exists
+		uint8 nodeId = valueId.GetNodeId();
+		Node* node = ( valueId.GetHomeId() == m_homeId ) ? GetNodeUnsafe( nodeId ) : NULL;
+		if( node == NULL )
+		{
+			Log::Write( LogLevel_Info, "EnablePoll failed - node %d not found", nodeId );
+			res = false;
+			continue;
+		}
+
+		// confirm that this value is in the node's value store
+		Value* value = node->GetValue( valueId );
+		if( value == NULL )
+		{
+			Log::Write( LogLevel_Info, nodeId, "EnablePoll failed - value not found for node %d", nodeId );
+			res = false;
+			continue;
+		}
+
+		// update the value's pollIntensity
+		value->SetPollIntensity( _intensity );
+		value->Release();
+
+		// See if the value is already being polled
+		bool wasTimed = false;
+		map<uint64,list<PollEntry>::iterator>::iterator it = m_pollIndex.find( valueId.GetId() );
+		if( it != m_pollIndex.end() )
+		{
+			if( it->second != m_pollList.end() )
+			{
+				// It is already in the poll list, so we have nothing to do.
+				Log::Write( LogLevel_Detail, "EnablePoll not required to do anything (value is already in the poll list)" );
+				continue;
+			}
+
+			// A value polled at its own interval goes back to the shared list
+			wasTimed = RemoveTimedPoll( valueId );
+		}
+
+		// Add the valueid to the polling list
+		PollEntry pe;
+		pe.m_id = valueId;
+		pe.m_pollCounter = _intensity;
+		m_pollIndex[valueId.GetId()] = m_pollList.insert( m_pollList.end(), pe );
+
+		if( !wasTimed )
+		{
+			enabled.push_back( nodeId );
+		}
+		Log::Write( LogLevel_Info, nodeId, "EnablePoll for HomeID 0x%.8x, value(cc=0x%02x,in=0x%02x,id=0x%02x)--poll list has %d items",
+			    valueId.GetHomeId(), valueId.GetCommandClassId(), valueId.GetIndex(), valueId.GetInstance(), m_pollList.size() );
+	}
+
+	// allow the poll thread to continue
+	ReleaseNodes();
+	m_pollMutex->Unlock();
+
+	// send notifications to indicate polling is enabled
+	for( vector<uint8>::iterator it = enabled.begin(); it != enabled.end(); ++it )
+	{
+		Notification* notification = new Notification( Notification::Type_PollingEnabled );
+		notification->SetHomeAndNodeIds( m_homeId, *it );
+		QueueNotification( notification );
+	}
+
+	return res;
+}
+
+//-----------------------------------------------------------------------------
+// <Driver::EnablePollInterval>
+// Enable polling of a value at its own interval, independent of the poll list
+//-----------------------------------------------------------------------------
+bool Driver::EnablePollInterval
+(
+	ValueID const &_valueId,
+	int32 const _milliseconds
+)
+{
+	if( _milliseconds <= 0 )
+	{
+		Log::Write( LogLevel_Info, _valueId.GetNodeId(), "EnablePollInterval failed - interval of %d ms is not valid", _milliseconds );
+		return false;
+	}
+
 	// make sure the polling thread doesn't lock the node while we're in this function
 	m_pollMutex->Lock();
 
@@ -3771,39 +4282,43 @@ bool Driver::EnablePoll
 		// confirm that this value is in the node's value store
 		if( Value* value = node->GetValue( _valueId ) )
 		{
-			// update the value's pollIntensity
-			value->SetPollIntensity( _intensity );
+			bool wasPolled = ( value->GetPollIntensity() != 0 );
+			if( !wasPolled )
+			{
+				value->SetPollIntensity( 1 );
+			}
+			value->Release();
 
-			// Add the valueid to the polling list
-			// See if the node is already in the poll list.
-			for( list<PollEntry>::iterator it = m_pollList.begin(); it != m_pollList.end(); ++it )
+			// Take the value out of the shared poll list, if it is there
+			map<uint64,list<PollEntry>::iterator>::iterator it = m_pollIndex.find( _valueId.GetId() );
+			if( ( it != m_pollIndex.end() ) && ( it->second != m_pollList.end() ) )
 			{
-				if( (*it).m_id == _valueId )
-				{
-					// It is already in the poll list, so we have nothing to do.
-					Log::Write( LogLevel_Detail, "EnablePoll not required to do anything (value is already in the poll list)" );
-					value->Release();
-					m_pollMutex->Unlock();
-					ReleaseNodes();
-					return true;
-				}
+				m_pollList.erase( it->second );
+				m_pollIndex.erase( it );
 			}
 
-			// Not in the list, so we add it
-			PollEntry pe;
-			pe.m_id = _valueId;
-			pe.m_pollCounter = value->GetPollIntensity();
-			m_pollList.push_back( pe );
-			value->Release();
+			// Schedule the first poll straight away, replacing any earlier interval
+			RemoveTimedPoll( _valueId );
+			TimedPollEntry tpe;
+			tpe.m_id = _valueId;
+			tpe.m_interval = _milliseconds;
+			tpe.m_due = GetPollClock();
+			m_pollHeap.push_back( tpe );
+			push_heap( m_pollHeap.begin(), m_pollHeap.end(), TimedPollLater() );
+			m_pollIndex[_valueId.GetId()] = m_pollList.end();
+
 			m_pollMutex->Unlock();
 			ReleaseNodes();
 
 			// send notification to indicate polling is enabled
-			Notification* notification = new Notification( Notification::Type_PollingEnabled );
-			notification->SetHomeAndNodeIds( m_homeId, _valueId.GetNodeId() );
-			QueueNotification( notification );
-			Log::Write( LogLevel_Info, nodeId, "EnablePoll for HomeID 0x%.8x, value(cc=0x%02x,in=0x%02x,id=0x%02x)--poll list has %d items",
-				    _valueId.GetHomeId(), _valueId.GetCommandClassId(), _valueId.GetIndex(), _valueId.GetInstance(), m_pollList.size() );
+			if( !wasPolled )
+			{
+				Notification* notification = new Notification( Notification::Type_PollingEnabled );
+				notification->SetHomeAndNodeIds( m_homeId, _valueId.GetNodeId() );
+				QueueNotification( notification );
+			}
+			Log::Write( LogLevel_Info, nodeId, "EnablePollInterval for HomeID 0x%.8x, value(cc=0x%02x,in=0x%02x,id=0x%02x) every %d ms--%d values have their own interval",
+				    _valueId.GetHomeId(), _valueId.GetCommandClassId(), _valueId.GetIndex(), _valueId.GetInstance(), _milliseconds, m_pollHeap.size() );
 			return true;
 		}
 
@@ -3811,14 +4326,14 @@ bool Driver::EnablePoll
 		m_pollMutex->Unlock();
 		ReleaseNodes();
 
-		Log::Write( LogLevel_Info, nodeId, "EnablePoll failed - value not found for node %d", nodeId );
+		Log::Write( LogLevel_Info, nodeId, "EnablePollInterval failed - value not found for node %d", nodeId );
 		return false;
 	}
 
 	// allow the poll thread to continue
 	m_pollMutex->Unlock();
 
-	Log::Write( LogLevel_Info, "EnablePoll failed - node %d not found", nodeId );
+	Log::Write( LogLevel_Info, "EnablePollInterval failed - node %d not found", nodeId );
 	return false;
 }
 
@@ -3839,32 +4354,51 @@ bool Driver::DisablePoll
 	Node* node = GetNode( nodeId );
 	if( node != NULL)
 	{
-		// See if the value is already in the poll list.
-		for( list<PollEntry>::iterator it = m_pollList.begin(); it != m_pollList.end(); ++it )
+		// Values with their own poll interval are kept in the poll heap instead
+		if( RemoveTimedPoll( _valueId ) )
 		{
-			if( (*it).m_id == _valueId )
+			if( Value* value = GetValue( _valueId ) )
 			{
-				// Found it
-				// remove it from the poll list
-				m_pollList.erase( it );
-
-				// get the value object and reset pollIntensity to zero (indicating no polling)
-				Value* value = GetValue( _valueId );
-                                if (!value)
-                                        continue;
 				value->SetPollIntensity( 0 );
 				value->Release();
-				m_pollMutex->Unlock();
-				ReleaseNodes();
+			}
+			m_pollMutex->Unlock();
+			ReleaseNodes();
 
-				// send notification to indicate polling is disabled
-				Notification* notification = new Notification( Notification::Type_PollingDisabled );
-				notification->SetHomeAndNodeIds( m_homeId, _valueId.GetNodeId() );
-				QueueNotification( notification );
-				Log::Write( LogLevel_Info, nodeId, "DisablePoll for HomeID 0x%.8x, value(cc=0x%02x,in=0x%02x,id=0x%02x)--poll list has %d items",
-					    _valueId.GetHomeId(), _valueId.GetCommandClassId(), _valueId.GetIndex(), _valueId.GetInstance(), m_pollList.size() );
-				return true;
+			// send notification to indicate polling is disabled
+			Notification* notification = new Notification( Notification::Type_PollingDisabled );
+			notification->SetHomeAndNodeIds( m_homeId, _valueId.GetNodeId() );
+			QueueNotification( notification );
+			Log::Write( LogLevel_Info, nodeId, "DisablePoll for HomeID 0x%.8x, value(cc=0x%02x,in=0x%02x,id=0x%02x)--%d values have their own interval",
+				    _valueId.GetHomeId(), _valueId.GetCommandClassId(), _valueId.GetIndex(), _valueId.GetInstance(), m_pollHeap.size() );
+			return true;
+		}
+
+		// See if the value is in the poll list.
+		map<uint64,list<PollEntry>::iterator>::iterator it = m_pollIndex.find( _valueId.GetId() );
+		if( it != m_pollIndex.end() )
+		{
+			// Found it
+			// remove it from the poll list
+			m_pollList.erase( it->second );
+			m_pollIndex.erase( it );
+
+			// get the value object and reset pollIntensity to zero (indicating no polling)
+			if( Value* value = GetValue( _valueId ) )
+			{
+				value->SetPollIntensity( 0 );
+				value->Release();
 			}
+			m_pollMutex->Unlock();
+			ReleaseNodes();
+
+			// send notification to indicate polling is disabled
+			Notification* notification = new Notification( Notification::Type_PollingDisabled );
+			notification->SetHomeAndNodeIds( m_homeId, _valueId.GetNodeId() );
+			QueueNotification( notification );
+			Log::Write( LogLevel_Info, nodeId, "DisablePoll for HomeID 0x%.8x, value(cc=0x%02x,in=0x%02x,id=0x%02x)--poll list has %d items",
+				    _valueId.GetHomeId(), _valueId.GetCommandClassId(), _valueId.GetIndex(), _valueId.GetInstance(), m_pollList.size() );
+			return true;
 		}
 
 		// Not in the list
@@ -3917,38 +4451,16 @@ bool Driver::isPolled
 	Node* node = GetNode( nodeId );
 	if( node != NULL)
 	{
-
-		// See if the value is already in the poll list.
-		for( list<PollEntry>::iterator it = m_pollList.begin(); it != m_pollList.end(); ++it )
-		{
-			if( (*it).m_id == _valueId )
-			{
-				// Found it
-				if( bPolled )
-				{
-					m_pollMutex->Unlock();
-					ReleaseNodes();
-					return true;
-				}
-				else
-				{
-					Log::Write( LogLevel_Error, nodeId, "IsPolled setting for valueId 0x%016x is not consistent with the poll list", _valueId.GetId() );
-				}
-			}
-		}
-
-		// Not in the list
-
-		if( !bPolled )
-		{
-			m_pollMutex->Unlock();
-			ReleaseNodes();
-			return false;
-		}
-		else
+		// See if the value is in the poll list or the poll heap.
+		bool bListed = ( m_pollIndex.find( _valueId.GetId() ) != m_pollIndex.end() );
+		if( bListed != bPolled )
 		{
 			Log::Write( LogLevel_Error, nodeId, "IsPolled setting for valueId 0x%016x is not consistent with the poll list", _valueId.GetId() );
 		}
+
+		m_pollMutex->Unlock();
+		ReleaseNodes();
+		return( bListed && bPolled );
 	}
 
 	// allow the poll thread to continue
@@ -3975,6 +4487,7 @@ void Driver::SetPollIntensity
 	if (!value)
 	        return;
 	value->SetPollIntensity( _intensity );
+	ValueConfigChanged( _valueId );
 
 	value->Release();
 	m_pollMutex->Unlock();
@@ -4006,83 +4519,124 @@ void Driver::PollThreadProc
 	Event* _exitEvent
 )
 {
+	// The poll list is worked through one entry per poll interval, while values
+	// with their own interval are taken from the poll heap as they fall due.
+	TimeStamp listPollDue;
+
 	while( 1 )
 	{
+		ExpireMulticastTargets();
+
 		int32 pollInterval = m_pollInterval;
 
-		if( m_awakeNodesQueried && !m_pollList.empty() )
+		if( m_awakeNodesQueried && ( !m_pollList.empty() || !m_pollHeap.empty() ) )
 		{
-			// We only bother getting the lock if the pollList is not empty
+			// We only bother getting the lock if there is something to poll
 			m_pollMutex->Lock();
 
-			// Get the next value to be polled
-			PollEntry pe = m_pollList.front();
-			m_pollList.pop_front();
-			ValueID  valueId = pe.m_id;
+			int32 now = GetPollClock();
+			bool listPoll = false;
+			if( !m_pollHeap.empty() && ( m_pollHeap.front().m_due - now <= 0 ) )
+			{
+				// The value that is due soonest has fallen due.  Schedule its next poll
+				// from now, so a value that had to wait does not get polled twice in a row.
+				pop_heap( m_pollHeap.begin(), m_pollHeap.end(), TimedPollLater() );
+				TimedPollEntry& tpe = m_pollHeap.back();
+				ValueID valueId = tpe.m_id;
+
+				// lock the node so the value cannot be removed while it is polled
+				uint8 nodeId = valueId.GetNodeId();
+				LockNode( nodeId );
+				Value* value = GetValue( valueId );
+				if( !value )
+				{
+					// The value or its node has gone without polling being disabled
+					m_pollIndex.erase( valueId.GetId() );
+					m_pollHeap.pop_back();
+					ReleaseNode( nodeId );
+					m_pollMutex->Unlock();
+					continue;
+				}
+				value->Release();
 
-			// only execute this poll if pe.m_pollCounter == 1; otherwise decrement the counter and process the next polled value
-			if( pe.m_pollCounter != 1)
-			{
-				pe.m_pollCounter--;
-				m_pollList.push_back( pe );
-				m_pollMutex->Unlock();
-				continue;
+				tpe.m_due = now + tpe.m_interval;
+				push_heap( m_pollHeap.begin(), m_pollHeap.end(), TimedPollLater() );
+
+				RequestPoll( valueId );
+				ReleaseNode( nodeId );
 			}
+			else if( !m_pollList.empty() && ( listPollDue.TimeRemaining() <= 0 ) )
+			{
+				// Get the next value to be polled.  Entries are moved to the back of the
+				// list with splice, so the iterators in m_pollIndex stay valid.
+				PollEntry& pe = m_pollList.front();
+				ValueID  valueId = pe.m_id;
 
-			// reset the poll counter to the full pollIntensity value and push it at the end of the list
-			// release the value object referenced; call GetNode to ensure the node objects are locked during this period
-			(void)GetNode( valueId.GetNodeId() );
-			Value* value = GetValue( valueId );
-			if (!value)
-			        continue;
-			pe.m_pollCounter = value->GetPollIntensity();
-			m_pollList.push_back( pe );
-			value->Release();
-			ReleaseNodes();
+				// only execute this poll if pe.m_pollCounter == 1; otherwise decrement the counter and process the next polled value
+				if( pe.m_pollCounter != 1)
+				{
+					pe.m_pollCounter--;
+					m_pollList.splice( m_pollList.end(), m_pollList, m_pollList.begin() );
+					m_pollMutex->Unlock();
+					continue;
+				}
 
-			// If the polling interval is for the whole poll list, calculate the time before the next poll,
-			// so that all polls can take place within the user-specified interval.
-			if( !m_bIntervalBetweenPolls )
-			{
-				if( pollInterval < 100 )
+				// reset the poll counter to the full pollIntensity value and move it to the end of the list
+				// release the value object referenced; lock the node so it cannot change during this period
+				uint8 nodeId = valueId.GetNodeId();
+				LockNode( nodeId );
+				Value* value = GetValue( valueId );
+				if( !value )
 				{
-					Log::Write( LogLevel_Info, "The pollInterval setting is only %d, which appears to be a legacy setting.  Multiplying by 1000 to convert to ms.", pollInterval );
-					pollInterval *= 1000;
+					m_pollIndex.erase( valueId.GetId() );
+					m_pollList.pop_front();
+					ReleaseNode( nodeId );
+					m_pollMutex->Unlock();
+					continue;
 				}
-				pollInterval /= (int32) m_pollList.size();
-			}
+				pe.m_pollCounter = value->GetPollIntensity();
+				m_pollList.splice( m_pollList.end(), m_pollList, m_pollList.begin() );
+				value->Release();
 
-			// Request the state of the value from the node to which it belongs
-			if( Node* node = GetNode( valueId.GetNodeId() ) )
-			{
-				bool requestState = true;
-				if( !node->IsListeningDevice() )
+				// If the polling interval is for the whole poll list, calculate the time before the next poll,
+				// so that all polls can take place within the user-specified interval.
+				if( !m_bIntervalBetweenPolls )
 				{
-					// The device is not awake all the time.  If it is not awake, we mark it
-					// as requiring a poll.  The poll will be done next time the node wakes up.
-					if( WakeUp* wakeUp = static_cast<WakeUp*>( node->GetCommandClass( WakeUp::StaticGetCommandClassId() ) ) )
+					if( pollInterval < 100 )
 					{
-						if( !wakeUp->IsAwake() )
-						{
-							wakeUp->SetPollRequired();
-							requestState = false;
-						}
+						Log::Write( LogLevel_Info, "The pollInterval setting is only %d, which appears to be a legacy setting.  Multiplying by 1000 to convert to ms.", pollInterval );
+						pollInterval *= 1000;
 					}
+					pollInterval /= (int32) m_pollList.size();
 				}
 
-				if( requestState )
+				// Request the state of the value from the node to which it belongs.  Only
+				// this node stays locked, so readers of other nodes are not held up.
+				RequestPoll( valueId );
+				ReleaseNode( nodeId );
+				listPoll = true;
+			}
+			else
+			{
+				// Nothing is due yet.  Sleep until the earliest deadline, but re-check
+				// at least as often as before so newly enabled values are picked up.
+				int32 timeout = 500;
+				if( !m_pollHeap.empty() && ( m_pollHeap.front().m_due - now < timeout ) )
 				{
-					// Request an update of the value
-					CommandClass* cc = node->GetCommandClass( valueId.GetCommandClassId() );
-					if (cc) {
-        					uint8 index = valueId.GetIndex();
-	        				uint8 instance = valueId.GetInstance();
-		        			Log::Write( LogLevel_Detail, node->m_nodeId, "Polling: %s index = %d instance = %d (poll queue has %d messages)", cc->GetCommandClassName().c_str(), index, instance, m_msgQueue[MsgQueue_Poll].size() );
-			        		cc->RequestValue( 0, index, instance, MsgQueue_Poll );
-                                        }
+					timeout = m_pollHeap.front().m_due - now;
 				}
+				if( !m_pollList.empty() && ( listPollDue.TimeRemaining() < timeout ) )
+				{
+					timeout = listPollDue.TimeRemaining();
+				}
+				m_pollMutex->Unlock();
 
-				ReleaseNodes();
+				if( Wait::Single( _exitEvent, timeout ) == 0 )
+				{
+					// Exit has been called
+					return;
+				}
+				continue;
 			}
 
 			m_pollMutex->Unlock();
@@ -4091,39 +4645,31 @@ void Driver::PollThreadProc
 			// While this makes the polls much more variable and uncertain if some other activity dominates
 			// a send queue, that may be appropriate
 			// TODO we can have a debate about whether to test all four queues or just the Poll queue
-			// Wait until the library isn't actively sending messages (or in the midst of a transaction)
-			int i32;
-			int loopCount = 0;
-			while( !m_msgQueue[MsgQueue_Poll].empty()
-				|| !m_msgQueue[MsgQueue_Send].empty()
-				|| !m_msgQueue[MsgQueue_Command].empty()
-				|| !m_msgQueue[MsgQueue_Query].empty()
-				|| m_currentMsg != NULL )
-			{
-				i32 = Wait::Single( _exitEvent, 10);		// test conditions every 10ms
-				if( i32 == 0 )
-				{
-					// Exit has been called
-					return;
-				}
-				loopCount++;
-				if( loopCount == 3000*10 )		// 300 seconds worth of delay?  Something unusual is going on
-				{
-					Log::Write( LogLevel_Warning, "Poll queue hasn't been able to execute for 300 secs or more" );
-					Log::QueueDump();
-//					assert( 0 );
-				}
+			// Wait until the library isn't actively sending messages (or in the midst of a transaction).
+			// The driver thread signals m_pollIdleEvent as soon as that is the case.
+			Wait* waitObjects[2];
+			waitObjects[0] = _exitEvent;
+			waitObjects[1] = m_pollIdleEvent;
+			int32 i32;
+			while( ( i32 = Wait::Multiple( waitObjects, 2, 300*1000 ) ) < 0 )
+			{
+				// 300 seconds worth of delay?  Something unusual is going on
+				Log::Write( LogLevel_Warning, "Poll queue hasn't been able to execute for 300 secs or more" );
+				Log::QueueDump();
 			}
-
-			// ready for next poll...insert the pollInterval delay
-			i32 = Wait::Single( _exitEvent, pollInterval );
 			if( i32 == 0 )
 			{
 				// Exit has been called
 				return;
 			}
+
+			// ready for next poll...the next entry in the poll list waits out the pollInterval
+			if( listPoll )
+			{
+				listPollDue.SetTime( pollInterval );
+			}
 		}
-		else		// poll list is empty or awake nodes haven't been fully queried yet
+		else		// nothing to poll or awake nodes haven't been fully queried yet
 		{
 			// don't poll just yet, wait for the pollInterval or exit before re-checking to see if the pollList has elements
 			int32 i32 = Wait::Single( _exitEvent, 500 );
@@ -4136,6 +4682,97 @@ void Driver::PollThreadProc
 	}
 }
 
+//-----------------------------------------------------------------------------
+// <Driver::RequestPoll>
+// Request the current state of a polled value.  The caller holds the node lock.
+//-----------------------------------------------------------------------------
+void Driver::RequestPoll
+(
+	ValueID const& _valueId
+)
+{
+	Node* node = GetNodeUnsafe( _valueId.GetNodeId() );
+	if( node == NULL )
+	{
+		return;
+	}
+
+	if( !node->IsListeningDevice() )
+	{
+		// The device is not awake all the time.  If it is not awake, we mark it
+		// as requiring a poll.  The poll will be done next time the node wakes up.
+		if( WakeUp* wakeUp = static_cast<WakeUp*>( node->GetCommandClass( WakeUp::StaticGetCommandClassId() ) ) )
+		{
+			if( !wakeUp->IsAwake() )
+			{
+				wakeUp->SetPollRequired();
+				return;
+			}
+		}
+	}
+
+	// Request an update of the value
+	if( CommandClass* cc = node->GetCommandClass( _valueId.GetCommandClassId() ) )
+	{
+		uint8 index = _valueId.GetIndex();
+		uint8 instance = _valueId.GetInstance();
+		Log::Write( LogLevel_Detail, node->m_nodeId, "Polling: %s index = %d instance = %d (poll queue has %d messages)", cc->GetCommandClassName().c_str(), index, instance, m_msgQueue[MsgQueue_Poll].GetSize() );
+		cc->RequestValue( 0, index, instance, MsgQueue_Poll );
+	}
+}
+
+//-----------------------------------------------------------------------------
+// <Driver::GetPollClock>
+// Milliseconds since m_pollEpoch.  The epoch is moved forward once a day so
+// the poll heap times never overflow.  The caller holds m_pollMutex.
+//-----------------------------------------------------------------------------
+int32 Driver::GetPollClock
+(
+)
+{
+	int32 now = -m_pollEpoch.TimeRemaining();
+	if( now > 24*60*60*1000 )
+	{
+		// Shifting every entry by the same amount keeps the heap ordered
+		for( vector<TimedPollEntry>::iterator it = m_pollHeap.begin(); it != m_pollHeap.end(); ++it )
+		{
+			(*it).m_due -= now;
+		}
+		m_pollEpoch.SetTime();
+		now = 0;
+	}
+	return now;
+}
+
+//-----------------------------------------------------------------------------
+// <Driver::RemoveTimedPoll>
+// Remove a value from the poll heap.  The caller holds m_pollMutex.
+//-----------------------------------------------------------------------------
+bool Driver::RemoveTimedPoll
+(
+	ValueID const& _valueId
+)
+{
+	// Only the heap itself needs searching, once the index says the value is in it
+	map<uint64,list<PollEntry>::iterator>::iterator index = m_pollIndex.find( _valueId.GetId() );
+	if( ( index == m_pollIndex.end() ) || ( index->second != m_pollList.end() ) )
+	{
+		return false;
+	}
+	m_pollIndex.erase( index );
+
+	for( vector<TimedPollEntry>::iterator it = m_pollHeap.begin(); it != m_pollHeap.end(); ++it )
+	{
+		if( (*it).m_id == _valueId )
+		{
+			m_pollHeap.erase( it );
+			make_heap( m_pollHeap.begin(), m_pollHeap.end(), TimedPollLater() );
+			return true;
+		}
+	}
+	return false;
+}
+
 //-----------------------------------------------------------------------------
 //	Retrieving Node information
 //-----------------------------------------------------------------------------
@@ -4601,6 +5238,7 @@ void Driver::SetNodeManufacturerName
 	if( Node* node = GetNode( _nodeId ) )
 	{
 		node->SetManufacturerName( _manufacturerName );
+		NodeConfigChanged( _nodeId );
 		ReleaseNodes();
 	}
 }
@@ -4618,6 +5256,7 @@ void Driver::SetNodeProductName
 	if( Node* node = GetNode( _nodeId ) )
 	{
 		node->SetProductName( _productName );
+		NodeConfigChanged( _nodeId );
 		ReleaseNodes();
 	}
 }
@@ -4819,8 +5458,8 @@ bool Driver::BeginControllerCommand
 	item.m_cci = cci;
 
 	m_sendMutex->Lock();
-	m_msgQueue[MsgQueue_Controller].push_back( item );
-	m_queueEvent[MsgQueue_Controller]->Set();
+	m_msgQueue[MsgQueue_Controller].PushBack( item );
+	SetQueueReady( MsgQueue_Controller );
 	m_sendMutex->Unlock();
 
 	return true;
@@ -5348,6 +5987,240 @@ void Driver::SwitchAllOff
 	ReleaseNodes();
 }
 
+//-----------------------------------------------------------------------------
+// <Driver::SetValueMulticast>
+// Set several switch values to the same level at once.  The caller holds
+// the node locks.
+//-----------------------------------------------------------------------------
+bool Driver::SetValueMulticast
+(
+	vector<ValueID> const& _ids,
+	uint8 const _level
+)
+{
+	// Group the values that can share a frame by command class.  Basic,
+	// SwitchBinary and SwitchMultilevel all use command 0x01 for Set.
+	map<uint8,vector<ValueID> > multicast;
+	vector<ValueID> unicast;
+	for( vector<ValueID>::const_iterator it = _ids.begin(); it != _ids.end(); ++it )
+	{
+		if( CanMulticast( *it ) )
+		{
+			multicast[it->GetCommandClassId()].push_back( *it );
+		}
+		else
+		{
+			unicast.push_back( *it );
+		}
+	}
+
+	bool res = true;
+	for( map<uint8,vector<ValueID> >::iterator it = multicast.begin(); it != multicast.end(); ++it )
+	{
+		uint8 level = _level;
+		if( ( it->first == SwitchBinary::StaticGetCommandClassId() ) && ( level != 0 ) )
+		{
+			level = 0xff;
+		}
+
+		vector<uint8> nodeIds;
+		for( vector<ValueID>::iterator vit = it->second.begin(); vit != it->second.end(); ++vit )
+		{
+			nodeIds.push_back( vit->GetNodeId() );
+		}
+
+		uint8 command[3] = { it->first, 0x01, level };
+		if( !SendMulticast( "Multicast Set", nodeIds, command, sizeof(command) ) )
+		{
+			unicast.insert( unicast.end(), it->second.begin(), it->second.end() );
+			continue;
+		}
+		Log::Write( LogLevel_Info, "Multicast Set of level %d to %d nodes", level, nodeIds.size() );
+
+		if( m_multicastResend )
+		{
+			// Multicast frames are neither routed nor acknowledged, so send
+			// every node the Set as well, as SwitchAll does after its broadcast.
+			unicast.insert( unicast.end(), it->second.begin(), it->second.end() );
+			continue;
+		}
+
+		// Otherwise just ask each node for its level.  CheckMulticastLevel
+		// sets the value again for any node whose report shows it missed
+		// the frame.
+		m_multicastMutex->Lock();
+		for( vector<ValueID>::iterator vit = it->second.begin(); vit != it->second.end(); ++vit )
+		{
+			MulticastTarget& target = m_multicastTargets[vit->GetId()];
+			target.m_level = level;
+			target.m_expires = time( NULL ) + MULTICAST_CHECK_TIMEOUT / 1000;
+		}
+		m_multicastMutex->Unlock();
+
+		for( vector<ValueID>::iterator vit = it->second.begin(); vit != it->second.end(); ++vit )
+		{
+			bool requested = false;
+			if( Node* node = GetNodeUnsafe( vit->GetNodeId() ) )
+			{
+				if( CommandClass* cc = node->GetCommandClass( vit->GetCommandClassId() ) )
+				{
+					requested = cc->RequestValue( 0, vit->GetIndex(), vit->GetInstance(), MsgQueue_Send );
+				}
+			}
+			if( !requested )
+			{
+				m_multicastMutex->Lock();
+				m_multicastTargets.erase( vit->GetId() );
+				m_multicastMutex->Unlock();
+				unicast.push_back( *vit );
+			}
+		}
+	}
+
+	// Values that could not be multicast are set on their own, exactly as
+	// SetValue would.
+	for( vector<ValueID>::const_iterator it = unicast.begin(); it != unicast.end(); ++it )
+	{
+		bool set = false;
+		if( ( it->GetHomeId() == m_homeId ) && ( it->GetNodeId() != m_nodeId ) )
+		{
+			if( Value* value = GetValue( *it ) )
+			{
+				if( ValueID::ValueType_Bool == it->GetType() )
+				{
+					set = static_cast<ValueBool*>( value )->Set( _level != 0 );
+				}
+				else if( ValueID::ValueType_Byte == it->GetType() )
+				{
+					set = static_cast<ValueByte*>( value )->Set( _level );
+				}
+				value->Release();
+			}
+		}
+		res = res && set;
+	}
+
+	return res;
+}
+
+//-----------------------------------------------------------------------------
+// <Driver::CheckMulticastLevel>
+// Compare a reported switch level with the level sent by a multicast Set
+//-----------------------------------------------------------------------------
+void Driver::CheckMulticastLevel
+(
+	ValueID const& _id,
+	uint8 const _level
+)
+{
+	m_multicastMutex->Lock();
+	map<uint64,MulticastTarget>::iterator it = m_multicastTargets.find( _id.GetId() );
+	if( it == m_multicastTargets.end() )
+	{
+		m_multicastMutex->Unlock();
+		return;
+	}
+	uint8 level = it->second.m_level;
+	bool expired = ( time( NULL ) > it->second.m_expires );
+	m_multicastTargets.erase( it );
+	m_multicastMutex->Unlock();
+
+	// 0xff asks the node to go back to its last level, so any level other
+	// than off confirms it.
+	if( expired || ( ( level == 0xff ) ? ( _level != 0 ) : ( _level == level ) ) )
+	{
+		return;
+	}
+
+	Log::Write( LogLevel_Info, _id.GetNodeId(), "Node reported level %d after a multicast Set of %d, sending the Set again", _level, level );
+	LockNodes();
+	if( Value* value = GetValue( _id ) )
+	{
+		if( ValueID::ValueType_Bool == _id.GetType() )
+		{
+			static_cast<ValueBool*>( value )->Set( level != 0 );
+		}
+		else if( ValueID::ValueType_Byte == _id.GetType() )
+		{
+			static_cast<ValueByte*>( value )->Set( level );
+		}
+		value->Release();
+	}
+	ReleaseNodes();
+}
+
+//-----------------------------------------------------------------------------
+// <Driver::ExpireMulticastTargets>
+// Forget the multicast Sets whose nodes have not reported back in time
+//-----------------------------------------------------------------------------
+void Driver::ExpireMulticastTargets
+(
+)
+{
+	m_multicastMutex->Lock();
+	time_t now = time( NULL );
+	map<uint64,MulticastTarget>::iterator it = m_multicastTargets.begin();
+	while( it != m_multicastTargets.end() )
+	{
+		if( now > it->second.m_expires )
+		{
+			Log::Write( LogLevel_Detail, (uint8)( it->first >> 24 ), "No report after a multicast Set of %d", it->second.m_level );
+			m_multicastTargets.erase( it++ );
+		}
+		else
+		{
+			++it;
+		}
+	}
+	m_multicastMutex->Unlock();
+}
+
+//-----------------------------------------------------------------------------
+// <Driver::CanMulticast>
+// Whether a value is a switch level that can be set by a multicast frame
+//-----------------------------------------------------------------------------
+bool Driver::CanMulticast
+(
+	ValueID const& _id
+)
+{
+	if( ( _id.GetHomeId() != m_homeId ) || ( _id.GetNodeId() == m_nodeId ) || ( _id.GetInstance() != 1 ) || ( _id.GetIndex() != 0 ) )
+	{
+		return false;
+	}
+
+	uint8 const ccId = _id.GetCommandClassId();
+	if( ccId == SwitchBinary::StaticGetCommandClassId() )
+	{
+		if( _id.GetType() != ValueID::ValueType_Bool )
+		{
+			return false;
+		}
+	}
+	else if( ( ccId == Basic::StaticGetCommandClassId() ) || ( ccId == SwitchMultilevel::StaticGetCommandClassId() ) )
+	{
+		if( _id.GetType() != ValueID::ValueType_Byte )
+		{
+			return false;
+		}
+	}
+	else
+	{
+		return false;
+	}
+
+	// Sleeping nodes would miss the frame, and a multicast frame cannot be
+	// encrypted or addressed to an endpoint.
+	Node* node = GetNodeUnsafe( _id.GetNodeId() );
+	if( ( node == NULL ) || !node->IsListeningDevice() )
+	{
+		return false;
+	}
+
+	CommandClass* cc = node->GetCommandClass( ccId );
+	return( ( cc != NULL ) && !cc->IsSecured() && ( cc->GetEndPoint( 1 ) == 0 ) );
+}
+
 //-----------------------------------------------------------------------------
 // <Driver::SetConfigParam>
 // Set the value of one of the configuration parameters of a device
@@ -5512,6 +6385,36 @@ void Driver::QueueNotification
 	Notification* _notification
 )
 {
+	// Most changes to what is saved in the configuration are announced here
+	switch( _notification->GetType() )
+	{
+		case Notification::Type_ValueChanged:
+		{
+			ValueConfigChanged( _notification->GetValueID() );
+			break;
+		}
+		case Notification::Type_ValueAdded:
+		case Notification::Type_ValueRemoved:
+		case Notification::Type_Group:
+		case Notification::Type_NodeNew:
+		case Notification::Type_NodeAdded:
+		case Notification::Type_NodeRemoved:
+		case Notification::Type_NodeProtocolInfo:
+		case Notification::Type_NodeNaming:
+		case Notification::Type_PollingDisabled:
+		case Notification::Type_PollingEnabled:
+		case Notification::Type_EssentialNodeQueriesComplete:
+		case Notification::Type_NodeQueriesComplete:
+		{
+			NodeConfigChanged( _notification->GetNodeId() );
+			break;
+		}
+		default:
+		{
+			break;
+		}
+	}
+
 	m_notifications.push_back( _notification );
 	m_notificationsEvent->Set();
 }
@@ -6105,17 +7008,17 @@ void Driver::HandleApplicationSlaveCommandRequest
 //-----------------------------------------------------------------------------
 uint8 Driver::NodeFromMessage
 (
-	uint8 const* buffer
+	uint8 const* _frame			// starts at the length byte
 )
 {
 	uint8 nodeId = 0;
 
-	if( buffer[1] >= 5 )
+	if( _frame[0] >= 5 )
 	{
-		switch( buffer[3] )
+		switch( _frame[2] )
 		{
-			case FUNC_ID_APPLICATION_COMMAND_HANDLER:		nodeId = buffer[5];	break;
-			case FUNC_ID_ZW_APPLICATION_UPDATE:			nodeId = buffer[5];	break;
+			case FUNC_ID_APPLICATION_COMMAND_HANDLER:		nodeId = _frame[4];	break;
+			case FUNC_ID_ZW_APPLICATION_UPDATE:			nodeId = _frame[4];	break;
 		}
 	}
 	return nodeId;
@@ -6211,6 +7114,7 @@ void Driver::GetDriverStatistics
 	_data->m_routedbusy = m_routedbusy;
 	_data->m_broadcastReadCnt = m_broadcastReadCnt;
 	_data->m_broadcastWriteCnt = m_broadcastWriteCnt;
+	_data->m_nodeLockContention = GetNodeLockContention();
 }
 
 //-----------------------------------------------------------------------------
@@ -6274,6 +7178,7 @@ void Driver::LogDriverStatistics
 	Log::Write( LogLevel_Always, "Out of frame data flow errors:  . . . . . . . . . . . . . %ld", data.m_OOFCnt );
 	Log::Write( LogLevel_Always, "Messages retransmitted: . . . . . . . . . . . . . . . . . %ld", data.m_retries );
 	Log::Write( LogLevel_Always, "Messages dropped and not delivered: . . . . . . . . . . . %ld", data.m_dropped );
+	Log::Write( LogLevel_Always, "Contended node lock acquisitions: . . . . . . . . . . . . %ld", data.m_nodeLockContention );
 	Log::Write( LogLevel_Always, "***************************************************************************" );
 }
 
@@ -31,10 +31,13 @@
 #include <string>
 #include <map>
 #include <list>
+#include <vector>
+#include <ctime>
 
 #include "Defs.h"
 #include "value_classes/ValueID.h"
 #include "Node.h"
+#include "Ring.h"
 #include "platform/Event.h"
 #include "platform/Mutex.h"
 #include "platform/TimeStamp.h"
@@ -49,6 +52,7 @@ namespace OpenZWave
 	class Thread;
 	class ControllerReplication;
 	class Notification;
+	class ConfigWriter;
 
 	/** \brief The Driver class handles communication between OpenZWave
 	 *  and a device attached via a serial port (typically a controller).
@@ -151,6 +155,8 @@ namespace OpenZWave
 		bool					m_awakeNodesQueried;	/**< Set to true once the driver has polled all awake nodes */
 		bool					m_allNodesQueried;		/**< Set to true once the driver has polled all nodes */
 		bool					m_notifytransactions;
+		bool					m_coalesceSets;			/**< Set to true to let a queued Set be replaced by a newer one for the same value */
+		bool					m_multicastResend;		/**< Set to true to follow a multicast Set with a full Set to each node, rather than a Get */
 		TimeStamp				m_startTime;			/**< Time this driver started (for log report purposes) */
 
 	//-----------------------------------------------------------------------------
@@ -160,6 +166,10 @@ namespace OpenZWave
 		void RequestConfig();							// Get the network configuration from the Z-Wave network
 		bool ReadConfig();								// Read the configuration from a file
 		void WriteConfig();								// Save the configuration to a file
+		void NodeConfigChanged( uint8 const _nodeId );	// Write this node in full at the next save
+		void ValueConfigChanged( ValueID const& _id );	// Write this value at the next save
+
+		ConfigWriter*			m_configWriter;			// Saves the configuration on its own thread
 
 	//-----------------------------------------------------------------------------
 	//	Controller
@@ -205,7 +215,7 @@ namespace OpenZWave
 			int32 count = 0;
 			for( int32 i=0; i<MsgQueue_Count; ++i )
 			{
-				count += (int32) (m_msgQueue[i].size());
+				count += (int32) (m_msgQueue[i].GetSize());
 			}
 			return count;
 		}
@@ -238,6 +248,24 @@ namespace OpenZWave
 		 *  Release the lock on the nodes so other threads can modify them.
 		 */
 		void ReleaseNodes();
+		/**
+		 *  Lock a single node.  Only the shard the node belongs to is locked, so threads
+		 *  working on nodes in other shards are not blocked.  LockNodes takes every shard,
+		 *  so code holding LockNodes may call this freely.  The reverse is not allowed:
+		 *  LockNodes (or GetNode) must never be called while holding only a node lock.
+		 *  \param _nodeId The nodeId of the node to lock.
+		 *  \see ReleaseNode, LockNodes
+		 */
+		void LockNode( uint8 const _nodeId );
+		/**
+		 *  Release the lock taken by LockNode.
+		 *  \param _nodeId The nodeId passed to the matching LockNode call.
+		 */
+		void ReleaseNode( uint8 const _nodeId );
+		/**
+		 *  Number of times a thread had to block waiting for the node locks.
+		 */
+		uint32 GetNodeLockContention()const;
 
 		ControllerInterface			m_controllerInterfaceType;						// Specifies the controller's hardware interface
 		string					m_controllerPath;							// name or path used to open the controller hardware.
@@ -259,7 +287,13 @@ namespace OpenZWave
 		uint8					m_controllerCaps;							// Set of flags indicating the controller's capabilities (See IsInclusionController above).
 		uint8					m_nodeId;									// Z-Wave Controller's own node ID.
 		Node*					m_nodes[256];								// Array containing all the node objects.
-		Mutex*					m_nodeMutex;								// Serializes access to node data
+		Mutex*					m_nodeMutex;								// Serializes changes to the node array
+		enum
+		{
+			NodeLockShards = 16
+		};
+		Mutex*					m_nodeLocks[NodeLockShards];				// Serializes access to node data, one lock per group of nodes (nodeId % NodeLockShards)
+		uint32					m_nodeLockContention[NodeLockShards+1];		// Per-lock count of contended acquisitions, last entry is m_nodeMutex.  Each count is protected by its own lock.
 
 		ControllerReplication*	m_controllerReplication;					// Controller replication is handled separately from the other command classes, due to older hand-held controllers using invalid node IDs.
 
@@ -306,6 +340,8 @@ namespace OpenZWave
 		void HandleGetRoutingInfoResponse( uint8* _data );
 
 		void HandleSendDataRequest( uint8* _data, bool _replication );
+		void HandleSendDataMultiResponse( uint8* _data );
+		void HandleSendDataMultiRequest( uint8* _data );
 		void HandleAddNodeToNetworkRequest( uint8* _data );
 		void HandleCreateNewPrimaryRequest( uint8* _data );
 		void HandleControllerChangeRequest( uint8* _data );
@@ -347,11 +383,16 @@ namespace OpenZWave
 		int32 GetPollInterval(){ return m_pollInterval ; }
 		void SetPollInterval( int32 _milliseconds, bool _bIntervalBetweenPolls ){ m_pollInterval = _milliseconds; m_bIntervalBetweenPolls = _bIntervalBetweenPolls; }
 		bool EnablePoll( const ValueID &_valueId, uint8 _intensity = 1 );
+		bool EnablePoll( vector<ValueID> const& _valueIds, uint8 const _intensity );
+		bool EnablePollInterval( const ValueID &_valueId, int32 _milliseconds );
 		bool DisablePoll( const ValueID &_valueId );
 		bool isPolled( const ValueID &_valueId );
 		void SetPollIntensity( const ValueID &_valueId, uint8 _intensity );
 		static void PollThreadEntryPoint( Event* _exitEvent, void* _context );
 		void PollThreadProc( Event* _exitEvent );
+		void RequestPoll( ValueID const& _valueId );
+		int32 GetPollClock();
+		bool RemoveTimedPoll( ValueID const& _valueId );
 
 		Thread*					m_pollThread;								// Thread for polling devices on the Z-Wave network
 		struct PollEntry
@@ -359,12 +400,26 @@ namespace OpenZWave
 			ValueID	m_id;
 			uint8	m_pollCounter;
 		};
+		struct TimedPollEntry
+		{
+			ValueID	m_id;
+			int32	m_interval;													// Milliseconds between polls of this value
+			int32	m_due;														// Next poll time, in milliseconds since m_pollEpoch
+		};
+		struct TimedPollLater
+		{
+			bool operator()( TimedPollEntry const& _a, TimedPollEntry const& _b )const{ return( _a.m_due - _b.m_due > 0 ); }
+		};
 OPENZWAVE_EXPORT_WARNINGS_OFF
 		list<PollEntry>			m_pollList;									// List of nodes that need to be polled
+		vector<TimedPollEntry>	m_pollHeap;									// Values polled at their own interval, kept as a min-heap on m_due
+		map<uint64,list<PollEntry>::iterator>	m_pollIndex;				// Every polled value, by ValueID::GetId().  Points at its m_pollList entry, or m_pollList.end() if it is in m_pollHeap
 OPENZWAVE_EXPORT_WARNINGS_ON
+		TimeStamp				m_pollEpoch;								// Origin of the TimedPollEntry::m_due times
 		Mutex*					m_pollMutex;								// Serialize access to the polling list
 		int32					m_pollInterval;								// Time interval during which all nodes must be polled
 		bool					m_bIntervalBetweenPolls;					// if true, the library intersperses m_pollInterval between polls; if false, the library attempts to complete all polls within m_pollInterval
+		Event*					m_pollIdleEvent;							// Signalled by the driver thread while the Poll, Send, Command and Query queues are empty and no message is in flight
 
 	//-----------------------------------------------------------------------------
 	//	Retrieving Node information
@@ -429,7 +484,7 @@ OPENZWAVE_EXPORT_WARNINGS_ON
 				m_apiMask[( _apinum - 1 ) >> 3] &= ~( 1 << (( _apinum - 1 ) & 0x07 ));
 			}
 		}
-		uint8 NodeFromMessage( uint8 const* buffer );
+		uint8 NodeFromMessage( uint8 const* _frame );
 
 	//-----------------------------------------------------------------------------
 	// Controller commands
@@ -552,7 +607,7 @@ OPENZWAVE_EXPORT_WARNINGS_ON
 						{
 							m_currentControllerCommand->m_controllerCommandDone = true;
 							m_sendMutex->Lock();
-							m_queueEvent[MsgQueue_Controller]->Set();
+							SetQueueReady( MsgQueue_Controller );
 							m_sendMutex->Unlock();
 							break;
 						}
@@ -595,6 +650,16 @@ OPENZWAVE_EXPORT_WARNINGS_ON
 
 		void SendMsg( Msg* _msg, MsgQueue const _queue );
 
+		/**
+		 *  Send one command to several nodes.  The command (command class, command
+		 *  and parameters) goes out in a single FUNC_ID_ZW_SEND_DATA_MULTI frame, so
+		 *  the nodes act on it together.  Multicast frames are neither routed nor
+		 *  acknowledged, so callers should follow up with each node.
+		 *  \return false, without sending anything, if there are fewer than two nodes
+		 *  or the controller does not support multicast.
+		 */
+		bool SendMulticast( char const* _logText, vector<uint8> const& _nodeIds, uint8 const* _command, uint8 const _length );
+
 		/**
 		 * Fetch the transmit options
 		 */
@@ -619,6 +684,7 @@ OPENZWAVE_EXPORT_WARNINGS_ON
 		 *  RemoveNodeQuery, Node::AllQueriesCompleted
 		 */
 		bool WriteNextMsg( MsgQueue const _queue );							// Extracts the first message from the queue, and makes it the current one.
+		bool CoalesceMsg( Msg* _msg, MsgQueue const _queue );				// Merges a message into one already waiting in the queue.  Called with m_sendMutex held.
 		bool WriteMsg( string const &str);									// Sends the current message to the Z-Wave network
 		void RemoveCurrentMsg();											// Deletes the current message and cleans up the callback etc states
 		bool MoveMessagesToWakeUpQueue(	uint8 const _targetNodeId, bool const _move );		// If a node does not respond, and is of a type that can sleep, this method is used to move all its pending messages to another queue ready for when it mext wakes up.
@@ -709,10 +775,14 @@ OPENZWAVE_EXPORT_WARNINGS_ON
 			ControllerCommandItem*		m_cci;
 		};
 
-OPENZWAVE_EXPORT_WARNINGS_OFF
-		list<MsgQueueItem>			m_msgQueue[MsgQueue_Count];
-OPENZWAVE_EXPORT_WARNINGS_ON
-		Event*					m_queueEvent[MsgQueue_Count];				// Events for each queue, which are signalled when the queue is not empty
+		// Mark a queue as having work for the driver thread, or not.  The caller holds m_sendMutex.
+		void SetQueueReady( MsgQueue const _queue ){ m_queueReady |= ( 1u << _queue ); m_queueEvent->Set(); }
+		void ClearQueueReady( MsgQueue const _queue ){ m_queueReady &= ~( 1u << _queue ); }
+		static MsgQueue FirstReadyQueue( uint32 const _ready );
+
+		Ring<MsgQueueItem>		m_msgQueue[MsgQueue_Count];
+		uint32					m_queueReady;						// One bit per queue, set while the queue has work for the driver thread.  Usually the same as not empty.
+		Event*					m_queueEvent;						// Signalled when a bit is set in m_queueReady
 		Mutex*					m_sendMutex;						// Serialize access to the queues
 		Msg*					m_currentMsg;
 		MsgQueue				m_currentMsgQueueSource;			// identifies which queue held m_currentMsg
@@ -752,6 +822,32 @@ OPENZWAVE_EXPORT_WARNINGS_ON
 		void SwitchAllOn();
 		void SwitchAllOff();
 
+	//-----------------------------------------------------------------------------
+	// Multicast
+	//-----------------------------------------------------------------------------
+	private:
+		// The public interface is provided via the wrappers in the Manager class
+		bool SetValueMulticast( vector<ValueID> const& _ids, uint8 const _level );
+		bool CanMulticast( ValueID const& _id );
+
+		// Called by the switch values when a node reports its level.  If the report
+		// answers a multicast Set and does not show the level that was sent, the
+		// value is set again with a unicast Set.
+		void CheckMulticastLevel( ValueID const& _id, uint8 const _level );
+
+		// Called by the poll thread to forget the multicast Sets that went
+		// unanswered for MULTICAST_CHECK_TIMEOUT.
+		void ExpireMulticastTargets();
+
+		struct MulticastTarget
+		{
+			uint8		m_level;		// Level sent in the multicast frame
+			time_t		m_expires;		// Reports after this time are no longer checked
+		};
+
+		map<uint64,MulticastTarget>	m_multicastTargets;		// Values waiting for the report that confirms a multicast Set, keyed by ValueID::GetId()
+		Mutex*						m_multicastMutex;		// Serializes access to m_multicastTargets
+
 	//-----------------------------------------------------------------------------
 	// Configuration Parameters	(wrappers for the Node methods)
 	//-----------------------------------------------------------------------------
@@ -811,6 +907,7 @@ OPENZWAVE_EXPORT_WARNINGS_ON
 			uint32 m_routedbusy;			// Number of messages received with routed busy status
 			uint32 m_broadcastReadCnt;		// Number of broadcasts read
 			uint32 m_broadcastWriteCnt;		// Number of broadcasts sent
+			uint32 m_nodeLockContention;		// Number of times a node lock was already held by another thread
 		};
 
 		void LogDriverStatistics();
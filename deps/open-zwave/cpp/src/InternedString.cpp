@@ -0,0 +1,69 @@
+//-----------------------------------------------------------------------------
+//
+//	InternedString.cpp
+//
+//	Strings stored once and shared by every value that uses them
+//
+//	SOFTWARE NOTICE AND LICENSE
+//
+//	This file is part of OpenZWave.
+//
+//	OpenZWave is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU Lesser General Public License as published
+//	by the Free Software Foundation, either version 3 of the License,
+//	or (at your option) any later version.
+//
+//	OpenZWave is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//	GNU Lesser General Public License for more details.
+//
+//	You should have received a copy of the GNU Lesser General Public License
+//	along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+
+#include <set>
+
+#include "InternedString.h"
+#include "platform/Mutex.h"
+
+using namespace OpenZWave;
+
+//-----------------------------------------------------------------------------
+// The table and its lock are created by the first call to Intern, which is
+// the initialization of s_empty below, before any other thread exists.
+//-----------------------------------------------------------------------------
+static set<string>& GetTable
+(
+)
+{
+	static set<string> s_table;
+	return s_table;
+}
+
+static Mutex* GetTableMutex
+(
+)
+{
+	static Mutex* s_mutex = new Mutex();
+	return s_mutex;
+}
+
+string const* InternedString::s_empty = InternedString::Intern( string() );
+
+//-----------------------------------------------------------------------------
+// <InternedString::Intern>
+// Find or add a string in the table
+//-----------------------------------------------------------------------------
+string const* InternedString::Intern
+(
+	string const& _str
+)
+{
+	Mutex* mutex = GetTableMutex();
+	mutex->Lock();
+	string const* str = &*GetTable().insert( _str ).first;
+	mutex->Unlock();
+	return str;
+}
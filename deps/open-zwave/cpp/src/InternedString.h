@@ -0,0 +1,82 @@
+//-----------------------------------------------------------------------------
+//
+//	InternedString.h
+//
+//	Strings stored once and shared by every value that uses them
+//
+//	SOFTWARE NOTICE AND LICENSE
+//
+//	This file is part of OpenZWave.
+//
+//	OpenZWave is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU Lesser General Public License as published
+//	by the Free Software Foundation, either version 3 of the License,
+//	or (at your option) any later version.
+//
+//	OpenZWave is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//	GNU Lesser General Public License for more details.
+//
+//	You should have received a copy of the GNU Lesser General Public License
+//	along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+
+#ifndef _InternedString_H
+#define _InternedString_H
+
+#include <string>
+
+#include "Defs.h"
+
+namespace OpenZWave
+{
+	/** \brief An immutable string held once in a process-wide table.
+	 *
+	 * Labels, units and help text are the same for every node of a given
+	 * type, so values keep a pointer into a shared table instead of their own
+	 * copy.  Entries are never freed, which means a reference obtained from
+	 * an InternedString stays valid after any lock protecting its owner has
+	 * been released.
+	 */
+	class InternedString
+	{
+	public:
+		InternedString(): m_str( s_empty ? s_empty : Intern( string() ) ){}
+		InternedString( string const& _str ): m_str( Intern( _str ) ){}
+		InternedString( char const* _str ): m_str( Intern( _str ) ){}
+
+		InternedString& operator=( string const& _str ){ if( *m_str != _str ) m_str = Intern( _str ); return *this; }
+		InternedString& operator=( char const* _str ){ if( *m_str != _str ) m_str = Intern( _str ); return *this; }
+
+		operator string const&()const{ return *m_str; }
+		string const& Get()const{ return *m_str; }
+		char const* c_str()const{ return m_str->c_str(); }
+		size_t length()const{ return m_str->length(); }
+
+		// Equal strings are always the same entry
+		bool operator==( InternedString const& _other )const{ return m_str == _other.m_str; }
+		bool operator!=( InternedString const& _other )const{ return m_str != _other.m_str; }
+
+		/**
+		 * Find or add a string in the table.
+		 * \param _str The string.
+		 * \return The shared copy, valid for the life of the process.
+		 */
+		static string const* Intern( string const& _str );
+
+	private:
+		string const*			m_str;
+
+		static string const*	s_empty;
+	};
+
+	inline bool operator==( string const& _a, InternedString const& _b ){ return _a == _b.Get(); }
+	inline bool operator==( InternedString const& _a, string const& _b ){ return _a.Get() == _b; }
+	inline bool operator!=( string const& _a, InternedString const& _b ){ return _a != _b.Get(); }
+	inline bool operator!=( InternedString const& _a, string const& _b ){ return _a.Get() != _b; }
+
+} // namespace OpenZWave
+
+#endif //_InternedString_H
@@ -158,8 +158,11 @@ Manager::Manager
 	int nDumpTrigger = (int) LogLevel_Warning;
 	Options::Get()->GetOptionAsInt( "DumpTriggerLevel", &nDumpTrigger );
 
+	int nAsyncLogBufferSize = 0;
+	Options::Get()->GetOptionAsInt( "AsyncLogBufferSize", &nAsyncLogBufferSize );
+
 	string logFilename = userPath + logFileNameBase;
-	Log::Create( logFilename, bAppend, bConsoleOutput, (LogLevel) nSaveLogLevel, (LogLevel) nQueueLogLevel, (LogLevel) nDumpTrigger );
+	Log::Create( logFilename, bAppend, bConsoleOutput, (LogLevel) nSaveLogLevel, (LogLevel) nQueueLogLevel, (LogLevel) nDumpTrigger, nAsyncLogBufferSize > 0 ? (uint32) nAsyncLogBufferSize : 0 );
 	Log::SetLoggingState( logging );
 
 	CommandClasses::RegisterCommandClasses();
@@ -650,6 +653,49 @@ bool Manager::EnablePoll
 	return false;
 }
 
+//-----------------------------------------------------------------------------
+// <Manager::EnablePoll>
+// Enable polling of several values
+//-----------------------------------------------------------------------------
+bool Manager::EnablePoll
+(
+	vector<ValueID> const& _valueIds,
+	uint8 const _intensity
+)
+{
+	if( _valueIds.empty() )
+	{
+		return true;
+	}
+
+	if( Driver* driver = GetDriver( _valueIds[0].GetHomeId() ) )
+	{
+		return( driver->EnablePoll( _valueIds, _intensity ) );
+	}
+
+	Log::Write( LogLevel_Info, "mgr,     EnablePoll failed - Driver with Home ID 0x%.8x is not available", _valueIds[0].GetHomeId() );
+	return false;
+}
+
+//-----------------------------------------------------------------------------
+// <Manager::EnablePollInterval>
+// Enable polling of a value at its own interval
+//-----------------------------------------------------------------------------
+bool Manager::EnablePollInterval
+(
+	ValueID const &_valueId,
+	int32 const _milliseconds
+)
+{
+	if( Driver* driver = GetDriver( _valueId.GetHomeId() ) )
+	{
+		return( driver->EnablePollInterval( _valueId, _milliseconds ) );
+	}
+
+	Log::Write( LogLevel_Info, "mgr,     EnablePollInterval failed - Driver with Home ID 0x%.8x is not available", _valueId.GetHomeId() );
+	return false;
+}
+
 //-----------------------------------------------------------------------------
 // <Manager::DisablePoll>
 // Disable polling of a value
@@ -716,13 +762,13 @@ uint8 Manager::GetPollIntensity
 	uint8 intensity = 0;
 	if( Driver* driver = GetDriver( _valueId.GetHomeId() ) )
 	{
-		driver->LockNodes();
+		driver->LockNode( _valueId.GetNodeId() );
 		if( Value* value = driver->GetValue( _valueId ) )
 		{
 			intensity = value->GetPollIntensity();
 			value->Release();
 		}
-		driver->ReleaseNodes();
+		driver->ReleaseNode( _valueId.GetNodeId() );
 	}
 
  	return intensity;
@@ -1461,19 +1507,32 @@ string Manager::GetValueLabel
 	ValueID const& _id
 )
 {
-	string label;
+	return GetValueLabelRef( _id );
+}
+
+//-----------------------------------------------------------------------------
+// <Manager::GetValueLabelRef>
+// Gets the user-friendly label for the value, from the shared string table
+//-----------------------------------------------------------------------------
+string const& Manager::GetValueLabelRef
+(
+	ValueID const& _id
+)
+{
+	// Points into the string table, so it outlives the node lock
+	string const* label = NULL;
 	if( Driver* driver = GetDriver( _id.GetHomeId() ) )
 	{
-		driver->LockNodes();
+		driver->LockNode( _id.GetNodeId() );
 		if( Value* value = driver->GetValue( _id ) )
 		{
-			label = value->GetLabel();
+			label = &value->GetLabel();
 			value->Release();
 		}
-		driver->ReleaseNodes();
+		driver->ReleaseNode( _id.GetNodeId() );
 	}
 
-	return label;
+	return label ? *label : InternedString().Get();
 }
 
 //-----------------------------------------------------------------------------
@@ -1492,6 +1551,7 @@ void Manager::SetValueLabel
 		if( Value* value = driver->GetValue( _id ) )
 		{
 			value->SetLabel( _value );
+			driver->ValueConfigChanged( _id );
 			value->Release();
 		}
 		driver->ReleaseNodes();
@@ -1507,19 +1567,32 @@ string Manager::GetValueUnits
 	ValueID const& _id
 )
 {
-	string units;
+	return GetValueUnitsRef( _id );
+}
+
+//-----------------------------------------------------------------------------
+// <Manager::GetValueUnitsRef>
+// Gets the units that the value is measured in, from the shared string table
+//-----------------------------------------------------------------------------
+string const& Manager::GetValueUnitsRef
+(
+	ValueID const& _id
+)
+{
+	// Points into the string table, so it outlives the node lock
+	string const* units = NULL;
 	if( Driver* driver = GetDriver( _id.GetHomeId() ) )
 	{
-		driver->LockNodes();
+		driver->LockNode( _id.GetNodeId() );
 		if( Value* value = driver->GetValue( _id ) )
 		{
-			units = value->GetUnits();
+			units = &value->GetUnits();
 			value->Release();
 		}
-		driver->ReleaseNodes();
+		driver->ReleaseNode( _id.GetNodeId() );
 	}
 
-	return units;
+	return units ? *units : InternedString().Get();
 }
 
 //-----------------------------------------------------------------------------
@@ -1538,6 +1611,7 @@ void Manager::SetValueUnits
 		if( Value* value = driver->GetValue( _id ) )
 		{
 			value->SetUnits( _value );
+			driver->ValueConfigChanged( _id );
 			value->Release();
 		}
 		driver->ReleaseNodes();
@@ -1553,19 +1627,32 @@ string Manager::GetValueHelp
 	ValueID const& _id
 )
 {
-	string help;
+	return GetValueHelpRef( _id );
+}
+
+//-----------------------------------------------------------------------------
+// <Manager::GetValueHelpRef>
+// Gets a help string describing the value's purpose and usage, from the shared string table
+//-----------------------------------------------------------------------------
+string const& Manager::GetValueHelpRef
+(
+	ValueID const& _id
+)
+{
+	// Points into the string table, so it outlives the node lock
+	string const* help = NULL;
 	if( Driver* driver = GetDriver( _id.GetHomeId() ) )
 	{
-		driver->LockNodes();
+		driver->LockNode( _id.GetNodeId() );
 		if( Value* value = driver->GetValue( _id ) )
 		{
-			help = value->GetHelp();
+			help = &value->GetHelp();
 			value->Release();
 		}
-		driver->ReleaseNodes();
+		driver->ReleaseNode( _id.GetNodeId() );
 	}
 
-	return help;
+	return help ? *help : InternedString().Get();
 }
 
 //-----------------------------------------------------------------------------
@@ -1584,6 +1671,7 @@ void Manager::SetValueHelp
 		if( Value* value = driver->GetValue( _id ) )
 		{
 			value->SetHelp( _value );
+			driver->ValueConfigChanged( _id );
 			value->Release();
 		}
 		driver->ReleaseNodes();
@@ -1602,13 +1690,13 @@ int32 Manager::GetValueMin
 	int32 limit = 0;
 	if( Driver* driver = GetDriver( _id.GetHomeId() ) )
 	{
-		driver->LockNodes();
+		driver->LockNode( _id.GetNodeId() );
 		if( Value* value = driver->GetValue( _id ) )
 		{
 			limit = value->GetMin();
 			value->Release();
 		}
-		driver->ReleaseNodes();
+		driver->ReleaseNode( _id.GetNodeId() );
 	}
 
 	return limit;
@@ -1626,13 +1714,13 @@ int32 Manager::GetValueMax
 	int32 limit = 0;
 	if( Driver* driver = GetDriver( _id.GetHomeId() ) )
 	{
-		driver->LockNodes();
+		driver->LockNode( _id.GetNodeId() );
 		if( Value* value = driver->GetValue( _id ) )
 		{
 			limit = value->GetMax();
 			value->Release();
 		}
-		driver->ReleaseNodes();
+		driver->ReleaseNode( _id.GetNodeId() );
 	}
 
 	return limit;
@@ -1650,13 +1738,13 @@ bool Manager::IsValueReadOnly
 	bool res = false;
 	if( Driver* driver = GetDriver( _id.GetHomeId() ) )
 	{
-		driver->LockNodes();
+		driver->LockNode( _id.GetNodeId() );
 		if( Value* value = driver->GetValue( _id ) )
 		{
 			res = value->IsReadOnly();
 			value->Release();
 		}
-		driver->ReleaseNodes();
+		driver->ReleaseNode( _id.GetNodeId() );
 	}
 
 	return res;
@@ -1674,13 +1762,13 @@ bool Manager::IsValueWriteOnly
 	bool res = false;
 	if( Driver* driver = GetDriver( _id.GetHomeId() ) )
 	{
-		driver->LockNodes();
+		driver->LockNode( _id.GetNodeId() );
 		if( Value* value = driver->GetValue( _id ) )
 		{
 			res = value->IsWriteOnly();
 			value->Release();
 		}
-		driver->ReleaseNodes();
+		driver->ReleaseNode( _id.GetNodeId() );
 	}
 
 	return res;
@@ -1698,13 +1786,13 @@ bool Manager::IsValueSet
 	bool res = false;
 	if( Driver* driver = GetDriver( _id.GetHomeId() ) )
 	{
-		driver->LockNodes();
+		driver->LockNode( _id.GetNodeId() );
 		if( Value* value = driver->GetValue( _id ) )
 		{
 			res = value->IsSet();
 			value->Release();
 		}
-		driver->ReleaseNodes();
+		driver->ReleaseNode( _id.GetNodeId() );
 	}
 
 	return res;
@@ -1722,13 +1810,13 @@ bool Manager::IsValuePolled
 	bool res = false;
 	if( Driver* driver = GetDriver( _id.GetHomeId() ) )
 	{
-		driver->LockNodes();
+		driver->LockNode( _id.GetNodeId() );
 		if( Value* value = driver->GetValue( _id ) )
 		{
 			res = value->IsPolled();
 			value->Release();
 		}
-		driver->ReleaseNodes();
+		driver->ReleaseNode( _id.GetNodeId() );
 	}
 
 	return res;
@@ -1752,28 +1840,28 @@ bool Manager::GetValueAsBool
 		{
 			if( Driver* driver = GetDriver( _id.GetHomeId() ) )
 			{
-				driver->LockNodes();
+				driver->LockNode( _id.GetNodeId() );
 				if( ValueBool* value = static_cast<ValueBool*>( driver->GetValue( _id ) ) )
 				{
 					*o_value = value->GetValue();
 					value->Release();
 					res = true;
 				}
-				driver->ReleaseNodes();
+				driver->ReleaseNode( _id.GetNodeId() );
 			}
 		}
 		else if( ValueID::ValueType_Button == _id.GetType() )
 		{
 			if( Driver* driver = GetDriver( _id.GetHomeId() ) )
 			{
-			    	driver->LockNodes();
+			    	driver->LockNode( _id.GetNodeId() );
 				if( ValueButton* value = static_cast<ValueButton*>( driver->GetValue( _id ) ) )
 				{
 					*o_value = value->IsPressed();
 					value->Release();
 					res = true;
 				}
-				driver->ReleaseNodes();
+				driver->ReleaseNode( _id.GetNodeId() );
 			}
 		}
 	}
@@ -1799,14 +1887,14 @@ bool Manager::GetValueAsByte
 		{
 			if( Driver* driver = GetDriver( _id.GetHomeId() ) )
 			{
-				driver->LockNodes();
+				driver->LockNode( _id.GetNodeId() );
 				if( ValueByte* value = static_cast<ValueByte*>( driver->GetValue( _id ) ) )
 				{
 					*o_value = value->GetValue();
 					value->Release();
 					res = true;
 				}
-				driver->ReleaseNodes();
+				driver->ReleaseNode( _id.GetNodeId() );
 			}
 		}
 	}
@@ -1832,15 +1920,14 @@ bool Manager::GetValueAsFloat
 		{
 			if( Driver* driver = GetDriver( _id.GetHomeId() ) )
 			{
-				driver->LockNodes();
+				driver->LockNode( _id.GetNodeId() );
 				if( ValueDecimal* value = static_cast<ValueDecimal*>( driver->GetValue( _id ) ) )
 				{
-					string str = value->GetValue();
-					*o_value = (float)atof( str.c_str() );
+					*o_value = value->GetAsFloat();
 					value->Release();
 					res = true;
 				}
-				driver->ReleaseNodes();
+				driver->ReleaseNode( _id.GetNodeId() );
 			}
 		}
 	}
@@ -1866,14 +1953,14 @@ bool Manager::GetValueAsInt
 		{
 			if( Driver* driver = GetDriver( _id.GetHomeId() ) )
 			{
-				driver->LockNodes();
+				driver->LockNode( _id.GetNodeId() );
 				if( ValueInt* value = static_cast<ValueInt*>( driver->GetValue( _id ) ) )
 				{
 					*o_value = value->GetValue();
 					value->Release();
 					res = true;
 				}
-				driver->ReleaseNodes();
+				driver->ReleaseNode( _id.GetNodeId() );
 			}
 		}
 	}
@@ -1900,7 +1987,7 @@ bool Manager::GetValueAsRaw
 		{
 			if( Driver* driver = GetDriver( _id.GetHomeId() ) )
 			{
-				driver->LockNodes();
+				driver->LockNode( _id.GetNodeId() );
 				if( ValueRaw* value = static_cast<ValueRaw*>( driver->GetValue( _id ) ) )
 				{
 					*o_length = value->GetLength();
@@ -1909,7 +1996,7 @@ bool Manager::GetValueAsRaw
 					value->Release();
 					res = true;
 				}
-				driver->ReleaseNodes();
+				driver->ReleaseNode( _id.GetNodeId() );
 			}
 		}
 	}
@@ -1935,14 +2022,14 @@ bool Manager::GetValueAsShort
 		{
 			if( Driver* driver = GetDriver( _id.GetHomeId() ) )
 			{
-				driver->LockNodes();
+				driver->LockNode( _id.GetNodeId() );
 				if( ValueShort* value = static_cast<ValueShort*>( driver->GetValue( _id ) ) )
 				{
 					*o_value = value->GetValue();
 					value->Release();
 					res = true;
 				}
-				driver->ReleaseNodes();
+				driver->ReleaseNode( _id.GetNodeId() );
 			}
 		}
 	}
@@ -1967,7 +2054,7 @@ bool Manager::GetValueAsString
 	{
 		if( Driver* driver = GetDriver( _id.GetHomeId() ) )
 		{
-			driver->LockNodes();
+			driver->LockNode( _id.GetNodeId() );
 
 			switch( _id.GetType() )
 			{
@@ -2072,7 +2159,7 @@ bool Manager::GetValueAsString
 				}
 			}
 
-			driver->ReleaseNodes();
+			driver->ReleaseNode( _id.GetNodeId() );
 		}
 	}
 
@@ -2097,7 +2184,7 @@ bool Manager::GetValueListSelection
 		{
 			if( Driver* driver = GetDriver( _id.GetHomeId() ) )
 			{
-				driver->LockNodes();
+				driver->LockNode( _id.GetNodeId() );
 				if( ValueList* value = static_cast<ValueList*>( driver->GetValue( _id ) ) )
 				{
 					ValueList::Item const& item = value->GetItem();
@@ -2108,7 +2195,7 @@ bool Manager::GetValueListSelection
 					}
 					value->Release();
 				}
-				driver->ReleaseNodes();
+				driver->ReleaseNode( _id.GetNodeId() );
 			}
 		}
 	}
@@ -2134,7 +2221,7 @@ bool Manager::GetValueListSelection
 		{
 			if( Driver* driver = GetDriver( _id.GetHomeId() ) )
 			{
-				driver->LockNodes();
+				driver->LockNode( _id.GetNodeId() );
 				if( ValueList* value = static_cast<ValueList*>( driver->GetValue( _id ) ) )
 				{
 					ValueList::Item const& item = value->GetItem();
@@ -2142,7 +2229,7 @@ bool Manager::GetValueListSelection
 					value->Release();
 					res = true;
 				}
-				driver->ReleaseNodes();
+				driver->ReleaseNode( _id.GetNodeId() );
 			}
 		}
 	}
@@ -2168,13 +2255,13 @@ bool Manager::GetValueListItems
 		{
 			if( Driver* driver = GetDriver( _id.GetHomeId() ) )
 			{
-				driver->LockNodes();
+				driver->LockNode( _id.GetNodeId() );
 				if( ValueList* value = static_cast<ValueList*>( driver->GetValue( _id ) ) )
 				{
 					res = value->GetItemLabels( o_value );
 					value->Release();
 				}
-				driver->ReleaseNodes();
+				driver->ReleaseNode( _id.GetNodeId() );
 			}
 		}
 	}
@@ -2200,14 +2287,14 @@ bool Manager::GetValueFloatPrecision
 		{
 			if( Driver* driver = GetDriver( _id.GetHomeId() ) )
 			{
-				driver->LockNodes();
+				driver->LockNode( _id.GetNodeId() );
 				if( ValueDecimal* value = static_cast<ValueDecimal*>( driver->GetValue( _id ) ) )
 				{
 					*o_value = value->GetPrecision();
 					value->Release();
 					res = true;
 				}
-				driver->ReleaseNodes();
+				driver->ReleaseNode( _id.GetNodeId() );
 			}
 		}
 	}
@@ -2215,6 +2302,207 @@ bool Manager::GetValueFloatPrecision
 	return res;
 }
 
+//-----------------------------------------------------------------------------
+// <FillValueSnapshot>
+// Copy everything the value accessors report into a snapshot.  The caller
+// must hold the lock for the value's node.
+//-----------------------------------------------------------------------------
+static void FillValueSnapshot
+(
+	Value* _value,
+	Manager::ValueSnapshot* o_snapshot
+)
+{
+	char str[256] = {0};
+
+	o_snapshot->m_valid = true;
+	o_snapshot->m_readOnly = _value->IsReadOnly();
+	o_snapshot->m_writeOnly = _value->IsWriteOnly();
+	o_snapshot->m_isSet = _value->IsSet();
+	o_snapshot->m_pollIntensity = _value->GetPollIntensity();
+	o_snapshot->m_min = _value->GetMin();
+	o_snapshot->m_max = _value->GetMax();
+	o_snapshot->m_label = _value->GetLabel();
+	o_snapshot->m_units = _value->GetUnits();
+	o_snapshot->m_help = _value->GetHelp();
+
+	o_snapshot->m_valueAsBool = false;
+	o_snapshot->m_valueAsByte = 0;
+	o_snapshot->m_valueAsShort = 0;
+	o_snapshot->m_valueAsInt = 0;
+	o_snapshot->m_valueAsFloat = 0.0f;
+	o_snapshot->m_precision = 0;
+	o_snapshot->m_listSelection = 0;
+	o_snapshot->m_listItems.clear();
+
+	switch( _value->GetID().GetType() )
+	{
+		case ValueID::ValueType_Bool:
+		{
+			o_snapshot->m_valueAsBool = static_cast<ValueBool*>( _value )->GetValue();
+			o_snapshot->m_valueAsString = o_snapshot->m_valueAsBool ? "True" : "False";
+			break;
+		}
+		case ValueID::ValueType_Byte:
+		{
+			o_snapshot->m_valueAsByte = static_cast<ValueByte*>( _value )->GetValue();
+			snprintf( str, sizeof(str), "%u", o_snapshot->m_valueAsByte );
+			o_snapshot->m_valueAsString = str;
+			break;
+		}
+		case ValueID::ValueType_Decimal:
+		{
+			ValueDecimal* value = static_cast<ValueDecimal*>( _value );
+			o_snapshot->m_valueAsString = value->GetValue();
+			o_snapshot->m_valueAsFloat = value->GetAsFloat();
+			o_snapshot->m_precision = value->GetPrecision();
+			break;
+		}
+		case ValueID::ValueType_Int:
+		{
+			o_snapshot->m_valueAsInt = static_cast<ValueInt*>( _value )->GetValue();
+			snprintf( str, sizeof(str), "%d", o_snapshot->m_valueAsInt );
+			o_snapshot->m_valueAsString = str;
+			break;
+		}
+		case ValueID::ValueType_List:
+		{
+			ValueList* value = static_cast<ValueList*>( _value );
+			if( value->HasItem() )
+			{
+				ValueList::Item const& item = value->GetItem();
+				o_snapshot->m_listSelection = item.m_value;
+				o_snapshot->m_valueAsString = item.m_label;
+			}
+			else
+			{
+				o_snapshot->m_listSelection = -1;
+				o_snapshot->m_valueAsString = "";
+			}
+			value->GetItemLabels( &o_snapshot->m_listItems );
+			break;
+		}
+		case ValueID::ValueType_Raw:
+		{
+			o_snapshot->m_valueAsString = static_cast<ValueRaw*>( _value )->GetAsString();
+			break;
+		}
+		case ValueID::ValueType_Short:
+		{
+			o_snapshot->m_valueAsShort = static_cast<ValueShort*>( _value )->GetValue();
+			snprintf( str, sizeof(str), "%d", o_snapshot->m_valueAsShort );
+			o_snapshot->m_valueAsString = str;
+			break;
+		}
+		case ValueID::ValueType_String:
+		{
+			o_snapshot->m_valueAsString = static_cast<ValueString*>( _value )->GetValue();
+			break;
+		}
+		case ValueID::ValueType_Button:
+		{
+			o_snapshot->m_valueAsString = static_cast<ValueButton*>( _value )->IsPressed() ? "True" : "False";
+			break;
+		}
+		default:
+		{
+			o_snapshot->m_valueAsString.clear();
+			break;
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------
+// <Manager::GetValueSnapshot>
+// Gets everything about a value under a single node lock
+//-----------------------------------------------------------------------------
+bool Manager::GetValueSnapshot
+(
+	ValueID const& _id,
+	ValueSnapshot* o_snapshot
+)
+{
+	bool res = false;
+
+	if( o_snapshot )
+	{
+		o_snapshot->m_valid = false;
+		if( Driver* driver = GetDriver( _id.GetHomeId() ) )
+		{
+			driver->LockNode( _id.GetNodeId() );
+			if( Value* value = driver->GetValue( _id ) )
+			{
+				FillValueSnapshot( value, o_snapshot );
+				value->Release();
+				res = true;
+			}
+			driver->ReleaseNode( _id.GetNodeId() );
+		}
+	}
+
+	return res;
+}
+
+//-----------------------------------------------------------------------------
+// <Manager::GetValueSnapshots>
+// Gets snapshots for a set of values, locking each run of same-node ids once
+//-----------------------------------------------------------------------------
+uint32 Manager::GetValueSnapshots
+(
+	vector<ValueID> const& _ids,
+	vector<ValueSnapshot>* o_snapshots
+)
+{
+	uint32 found = 0;
+
+	if( o_snapshots )
+	{
+		o_snapshots->resize( _ids.size() );
+
+		Driver* lockedDriver = NULL;
+		uint32 lockedHomeId = 0;
+		uint8 lockedNodeId = 0;
+
+		for( size_t i=0; i<_ids.size(); ++i )
+		{
+			ValueID const& id = _ids[i];
+			ValueSnapshot& snapshot = (*o_snapshots)[i];
+			snapshot.m_valid = false;
+
+			if( !lockedDriver || ( lockedHomeId != id.GetHomeId() ) || ( lockedNodeId != id.GetNodeId() ) )
+			{
+				if( lockedDriver )
+				{
+					lockedDriver->ReleaseNode( lockedNodeId );
+				}
+
+				lockedDriver = GetDriver( id.GetHomeId() );
+				lockedHomeId = id.GetHomeId();
+				lockedNodeId = id.GetNodeId();
+				if( !lockedDriver )
+				{
+					continue;
+				}
+				lockedDriver->LockNode( lockedNodeId );
+			}
+
+			if( Value* value = lockedDriver->GetValue( id ) )
+			{
+				FillValueSnapshot( value, &snapshot );
+				value->Release();
+				++found;
+			}
+		}
+
+		if( lockedDriver )
+		{
+			lockedDriver->ReleaseNode( lockedNodeId );
+		}
+	}
+
+	return found;
+}
+
 //-----------------------------------------------------------------------------
 // <Manager::SetValue>
 // Sets the value from a bool
@@ -2461,6 +2749,44 @@ bool Manager::SetValueListSelection
 	return res;
 }
 
+//-----------------------------------------------------------------------------
+// <Manager::SetValueMulticast>
+// Switches several values on or off together
+//-----------------------------------------------------------------------------
+bool Manager::SetValueMulticast
+(
+	vector<ValueID> const& _ids,
+	bool const _value
+)
+{
+	return SetValueMulticast( _ids, (uint8)( _value ? 0xff : 0x00 ) );
+}
+
+//-----------------------------------------------------------------------------
+// <Manager::SetValueMulticast>
+// Sets several switch levels together
+//-----------------------------------------------------------------------------
+bool Manager::SetValueMulticast
+(
+	vector<ValueID> const& _ids,
+	uint8 const _value
+)
+{
+	bool res = false;
+
+	if( !_ids.empty() )
+	{
+		if( Driver* driver = GetDriver( _ids[0].GetHomeId() ) )
+		{
+			driver->LockNodes();
+			res = driver->SetValueMulticast( _ids, _value );
+			driver->ReleaseNodes();
+		}
+	}
+
+	return res;
+}
+
 //-----------------------------------------------------------------------------
 // <Manager::SetValue>
 // Sets the value from a string
@@ -2633,6 +2959,7 @@ void Manager::SetChangeVerified
 		if( Value* value = driver->GetValue( _id ) )
 		{
 			value->SetChangeVerified( _verify );
+			driver->ValueConfigChanged( _id );
 			value->Release();
 		}
 		driver->ReleaseNodes();
@@ -2715,13 +3042,13 @@ uint8 Manager::GetNumSwitchPoints
 	{
 		if( Driver* driver = GetDriver( _id.GetHomeId() ) )
 		{
-			driver->LockNodes();
+			driver->LockNode( _id.GetNodeId() );
 			if( ValueSchedule* value = static_cast<ValueSchedule*>( driver->GetValue( _id ) ) )
 			{
 				numSwitchPoints = value->GetNumSwitchPoints();
 				value->Release();
 			}
-			driver->ReleaseNodes();
+			driver->ReleaseNode( _id.GetNodeId() );
 		}
 	}
 
@@ -2838,13 +3165,13 @@ bool Manager::GetSwitchPoint
 	{
 		if( Driver* driver = GetDriver( _id.GetHomeId() ) )
 		{
-			driver->LockNodes();
+			driver->LockNode( _id.GetNodeId() );
 			if( ValueSchedule* value = static_cast<ValueSchedule*>( driver->GetValue( _id ) ) )
 			{
 				res = value->GetSwitchPoint( _idx, o_hours, o_minutes, o_setback );
 				value->Release();
 			}
-			driver->ReleaseNodes();
+			driver->ReleaseNode( _id.GetNodeId() );
 		}
 	}
 
@@ -189,6 +189,9 @@ namespace OpenZWave
 		 * consists of the 8 digit hexadecimal version of the controller's Home ID, prefixed with the string 'zwcfg_'.
 		 * This convention allows OpenZWave to find the correct configuration file for a controller, even if it is
 		 * attached to a different serial port, USB device path, etc.
+		 * Only the nodes and values that have changed since the previous save are gathered
+		 * here.  The file itself is written on a background thread, so it may not be complete
+		 * when this method returns.
 		 * \param _homeId The Home ID of the Z-Wave controller to save.
 		 */
 		void WriteConfig( uint32 const _homeId );
@@ -220,7 +223,8 @@ namespace OpenZWave
 		 * has been received, a DriverReady notification callback is sent, containing the Home ID of the controller.  This Home ID is
 		 * required by most of the OpenZWave Manager class methods.
 		 * @param _controllerPath The string used to open the controller.  On Windows this might be something like
-		 * "\\.\COM3", or on Linux "/dev/ttyUSB0".
+		 * "\\.\COM3", or on Linux "/dev/ttyUSB0".  A controller reached over a socket, such as a serial-to-network
+		 * bridge or a simulated stick, is given as "tcp://host:port" or (not on Windows) "unix:///path/to/socket".
 		 * \return True if a new driver was created, false if a driver for the controller already exists.
 		 * \see Create, Get, RemoveDriver
 		 */
@@ -383,6 +387,27 @@ OPENZWAVE_EXPORT_WARNINGS_ON
 		 */
 		bool EnablePoll( ValueID const &_valueId, uint8 const _intensity = 1 );
 
+		/**
+		 * \brief Enable the polling of several values at once.
+		 * The poll list is locked once for the whole set, so configuring polling for a
+		 * large network at startup does not hold up the poll thread value by value.
+		 * \param _valueIds The IDs of the values to start polling, which must all belong to the same Home ID.
+		 * \param _intensity The poll intensity to give every value.
+		 * \return True if polling was enabled for every value.
+		 */
+		bool EnablePoll( vector<ValueID> const& _valueIds, uint8 const _intensity = 1 );
+
+		/**
+		 * \brief Enable the polling of a device's state at its own interval.
+		 * Unlike EnablePoll, the value is not part of the list shared by the poll interval.  It is
+		 * polled every _milliseconds, whatever else is being polled.  Calling EnablePoll for the
+		 * value moves it back onto the shared list, and DisablePoll stops it as usual.
+		 * \param _valueId The ID of the value to start polling.
+		 * \param _milliseconds The time between polls of this value.
+		 * \return True if polling was enabled.
+		 */
+		bool EnablePollInterval( ValueID const &_valueId, int32 const _milliseconds );
+
 		/**
 		 * \brief Disable the polling of a device's state.
 		 * \param _valueId The ID of the value to stop polling.
@@ -857,6 +882,33 @@ OPENZWAVE_EXPORT_WARNINGS_ON
 		 */
 		void SetValueHelp( ValueID const& _id, string const& _value );
 
+		/**
+		 * \brief Gets the user-friendly label for the value, without copying it.
+		 * Labels, units and help text are held once in a table shared by every value, and are
+		 * never freed, so the reference remains valid after this call returns.  It does not
+		 * follow later changes to the label.
+		 * \param _id The unique identifier of the value.
+		 * \return The value label, or an empty string if the value was not found.
+		 * \see GetValueLabel, GetValueUnitsRef, GetValueHelpRef
+		 */
+		string const& GetValueLabelRef( ValueID const& _id );
+
+		/**
+		 * \brief Gets the units that the value is measured in, without copying them.
+		 * \param _id The unique identifier of the value.
+		 * \return The value units, or an empty string if the value was not found.
+		 * \see GetValueUnits, GetValueLabelRef
+		 */
+		string const& GetValueUnitsRef( ValueID const& _id );
+
+		/**
+		 * \brief Gets the help text for the value, without copying it.
+		 * \param _id The unique identifier of the value.
+		 * \return The value help text, or an empty string if the value was not found.
+		 * \see GetValueHelp, GetValueLabelRef
+		 */
+		string const& GetValueHelpRef( ValueID const& _id );
+
 		/**
 		 * \brief Gets the minimum that this value may contain.
 		 * \param _id The unique identifier of the value.
@@ -1006,6 +1058,57 @@ OPENZWAVE_EXPORT_WARNINGS_ON
 		 */
 		bool GetValueFloatPrecision( ValueID const& _id, uint8* o_value );
 
+		/**
+		 * \brief Everything the value accessors above report about a single value.
+		 * Only the typed member matching the ValueID's type is meaningful.  m_valueAsString
+		 * is filled for every type, and holds the selected item's label for list values.
+		 * \see GetValueSnapshot, GetValueSnapshots
+		 */
+		struct ValueSnapshot
+		{
+			bool			m_valid;			// false if the value could not be found
+			bool			m_readOnly;
+			bool			m_writeOnly;
+			bool			m_isSet;
+			uint8			m_pollIntensity;
+			int32			m_min;
+			int32			m_max;
+			string			m_label;
+			string			m_units;
+			string			m_help;
+
+			bool			m_valueAsBool;
+			uint8			m_valueAsByte;
+			int16			m_valueAsShort;
+			int32			m_valueAsInt;
+			float			m_valueAsFloat;
+			uint8			m_precision;		// ValueType_Decimal only
+			int32			m_listSelection;	// ValueType_List only, -1 if no item is selected
+			vector<string>	m_listItems;		// ValueType_List only
+			string			m_valueAsString;
+		};
+
+		/**
+		 * \brief Gets the label, units, flags, limits and current value of a value in one call.
+		 * The node is locked once and the value looked up once, rather than once per accessor.
+		 * \param _id The unique identifier of the value.
+		 * \param o_snapshot Pointer to a ValueSnapshot that will be filled in.
+		 * \return true if the value was found.  On failure o_snapshot->m_valid is also false.
+		 * \see ValueSnapshot, GetValueSnapshots
+		 */
+		bool GetValueSnapshot( ValueID const& _id, ValueSnapshot* o_snapshot );
+
+		/**
+		 * \brief Gets snapshots for a set of values.
+		 * Consecutive ids that belong to the same node share a single node lock, so refreshing every
+		 * value of a node costs one lock acquisition.  Ids should therefore be grouped by node.
+		 * \param _ids The unique identifiers of the values.
+		 * \param o_snapshots Pointer to a vector that will be resized to match _ids, with one snapshot per id in the same order.
+		 * \return The number of values that were found.
+		 * \see ValueSnapshot, GetValueSnapshot
+		 */
+		uint32 GetValueSnapshots( vector<ValueID> const& _ids, vector<ValueSnapshot>* o_snapshots );
+
 		/**
 		 * \brief Sets the state of a bool.
 		 * Due to the possibility of a device being asleep, the command is assumed to suceed, and the value
@@ -1096,6 +1199,33 @@ OPENZWAVE_EXPORT_WARNINGS_ON
 		 */
 		bool SetValueListSelection( ValueID const& _id, string const& _selectedItem );
 
+		/**
+		 * \brief Switches several lights or appliances on or off together.
+		 * Binary switch, multilevel switch and basic levels on awake, unencrypted nodes are sent in a single
+		 * multicast frame, so they change at the same moment rather than one after another.  Since multicast
+		 * frames are neither routed nor acknowledged, each of those nodes is then asked for its level, and
+		 * set again on its own only if it did not change.  With the MulticastResendSet option, each value
+		 * is instead also set on its own, exactly as SetValue would.  Other switch values are only set on
+		 * their own.
+		 * \param _ids The unique identifiers of the values, which must all belong to the same Home ID.
+		 * \param _value The new state: true for on, false for off.
+		 * \return true if every value was set.  Returns false if any value is not a ValueID::ValueType_Bool
+		 * or ValueID::ValueType_Byte, or could not be set.
+		 * \see SetValue
+		 */
+		bool SetValueMulticast( vector<ValueID> const& _ids, bool const _value );
+
+		/**
+		 * \brief Sets several switch levels to the same value together.
+		 * As SetValueMulticast( vector<ValueID> const&, bool const ), but with a level of 0-99, or 255 to
+		 * restore the last level.  Binary switches treat any non-zero level as on.
+		 * \param _ids The unique identifiers of the values, which must all belong to the same Home ID.
+		 * \param _value The new level.
+		 * \return true if every value was set.
+		 * \see SetValue
+		 */
+		bool SetValueMulticast( vector<ValueID> const& _ids, uint8 const _value );
+
 		/**
 		 * \brief Refreshes the specified value from the Z-Wave network.
 		 * A call to this function causes the library to send a message to the network to retrieve the current value
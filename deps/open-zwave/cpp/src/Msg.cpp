@@ -29,16 +29,26 @@
 #include "Msg.h"
 #include "Node.h"
 #include "platform/Log.h"
+#include "platform/Mutex.h"
 #include "command_classes/MultiInstance.h"
+#include <set>
 
 using namespace OpenZWave;
 
 uint8 Msg::s_nextCallbackId = 1;
 
+// Enough spare messages to cover a burst of queued commands
+static uint32 const c_maxFreeMsgs = 64;
+
+Mutex* Msg::s_poolMutex = new Mutex();
+void* Msg::s_freeList = NULL;
+uint32 Msg::s_freeCount = 0;
+
 
 //-----------------------------------------------------------------------------
 // <Msg::Msg>
-// Constructor
+// Constructor for log text built at run time.  The text is interned, since
+// it is drawn from a small set (command names, node and endpoint numbers).
 //-----------------------------------------------------------------------------
 Msg::Msg
 ( 
@@ -51,20 +61,41 @@ Msg::Msg
 	uint8 const _expectedReply,			// = 0
 	uint8 const _expectedCommandClassId	// = 0
 ):
-	m_logText( _logText ),
-	m_bFinal( false ),
-	m_bCallbackRequired( _bCallbackRequired ),
-	m_callbackId( 0 ),
-	m_expectedReply( 0 ),
-	m_expectedCommandClassId( _expectedCommandClassId ),
-	m_length( 4 ),
-	m_targetNodeId( _targetNodeId ),
-	m_sendAttempts( 0 ),
-	m_maxSendAttempts( MAX_TRIES ),
-	m_instance( 1 ),
-	m_endPoint( 0 ),
-	m_flags( 0 )
+	m_logText( InternLogText( _logText ) )
+{
+	Init( _targetNodeId, _msgType, _function, _bCallbackRequired, _bReplyRequired, _expectedReply, _expectedCommandClassId );
+}
+
+//-----------------------------------------------------------------------------
+// <Msg::Init>
+// Set up the message header and state shared by both constructors
+//-----------------------------------------------------------------------------
+void Msg::Init
+( 
+	uint8 _targetNodeId,
+	uint8 const _msgType,
+	uint8 const _function,
+	bool const _bCallbackRequired,
+	bool const _bReplyRequired,
+	uint8 const _expectedReply,
+	uint8 const _expectedCommandClassId
+)
 {
+	m_bFinal = false;
+	m_bEncapsulated = false;
+	m_bCallbackRequired = _bCallbackRequired;
+	m_callbackId = 0;
+	m_expectedReply = 0;
+	m_expectedCommandClassId = _expectedCommandClassId;
+	m_length = 4;
+	m_targetNodeId = _targetNodeId;
+	m_sendAttempts = 0;
+	m_maxSendAttempts = MAX_TRIES;
+	m_instance = 1;
+	m_endPoint = 0;
+	m_flags = 0;
+	m_supersedeKey = 0;
+
 	if( _bReplyRequired )
 	{
 		// Wait for this message before considering the transaction complete 
@@ -77,6 +108,96 @@ Msg::Msg
 	m_buffer[3] = _function;
 }
 
+//-----------------------------------------------------------------------------
+// <Msg::operator new>
+// Take a message from the free list, or the heap if it is empty
+//-----------------------------------------------------------------------------
+void* Msg::operator new
+(
+	size_t _size
+)
+{
+	if( _size == sizeof(Msg) )
+	{
+		s_poolMutex->Lock();
+		if( void* p = s_freeList )
+		{
+			s_freeList = *(void**)p;
+			--s_freeCount;
+			s_poolMutex->Unlock();
+			return p;
+		}
+		s_poolMutex->Unlock();
+	}
+	return ::operator new( _size );
+}
+
+//-----------------------------------------------------------------------------
+// <Msg::operator delete>
+// Keep a freed message for reuse, up to c_maxFreeMsgs of them
+//-----------------------------------------------------------------------------
+void Msg::operator delete
+(
+	void* _p
+)
+{
+	if( _p == NULL )
+	{
+		return;
+	}
+
+	s_poolMutex->Lock();
+	if( s_freeCount < c_maxFreeMsgs )
+	{
+		*(void**)_p = s_freeList;
+		s_freeList = _p;
+		++s_freeCount;
+		s_poolMutex->Unlock();
+		return;
+	}
+	s_poolMutex->Unlock();
+	::operator delete( _p );
+}
+
+//-----------------------------------------------------------------------------
+// <Msg::InternLogText>
+// Return a copy of the text that lives as long as the library
+//-----------------------------------------------------------------------------
+char const* Msg::InternLogText
+(
+	string const& _logText
+)
+{
+	static set<string>* s_logTexts = NULL;
+
+	s_poolMutex->Lock();
+	if( s_logTexts == NULL )
+	{
+		s_logTexts = new set<string>();
+	}
+	char const* text = s_logTexts->insert( _logText ).first->c_str();
+	s_poolMutex->Unlock();
+	return text;
+}
+
+//-----------------------------------------------------------------------------
+// <Msg::GetLogText>
+// Get the log text, including any encapsulation added by Finalize
+//-----------------------------------------------------------------------------
+string Msg::GetLogText
+(
+)const
+{
+	if( !m_bEncapsulated )
+	{
+		return m_logText;
+	}
+
+	char str[256];
+	snprintf( str, sizeof(str), "%s Encapsulated (instance=%d): %s", ( m_flags & m_MultiChannel ) ? "MultiChannel" : "MultiInstance", m_instance, m_logText );
+	return str;
+}
+
 //-----------------------------------------------------------------------------
 // <Msg::SetInstance>
 // Used to enable wrapping with MultiInstance/MultiChannel during finalize.
@@ -205,7 +326,7 @@ void Msg::UpdateCallbackId()
 //-----------------------------------------------------------------------------
 string Msg::GetAsString()
 {
-	string str = m_logText;
+	string str = GetLogText();
 
 	char byteStr[16];
 	if( m_targetNodeId != 0xff )
@@ -238,7 +359,6 @@ void Msg::MultiEncap
 (
 )
 {
-	char str[256];
 	if( m_buffer[3]	!= FUNC_ID_ZW_SEND_DATA )
 	{
 		return;
@@ -260,8 +380,7 @@ void Msg::MultiEncap
 		m_buffer[9] = m_endPoint;
 		m_length += 4;
 
-		snprintf( str, sizeof(str), "MultiChannel Encapsulated (instance=%d): %s", m_instance, m_logText.c_str() );
-		m_logText = str;
+		m_bEncapsulated = true;
 	}
 	else
 	{
@@ -277,7 +396,6 @@ void Msg::MultiEncap
 		m_buffer[8] = m_instance;
 		m_length += 3;
 
-		snprintf( str, sizeof(str), "MultiInstance Encapsulated (instance=%d): %s", m_instance, m_logText.c_str() );
-		m_logText = str;
+		m_bEncapsulated = true;
 	}
 }
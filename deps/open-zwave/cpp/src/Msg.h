@@ -36,6 +36,7 @@
 namespace OpenZWave
 {
 	class CommandClass;
+	class Mutex;
 
 	/** \brief Message object to be passed to and from devices on the Z-Wave network.
 	 */
@@ -48,9 +49,26 @@ namespace OpenZWave
 			m_MultiInstance			= 0x02,		// Indicate MultiInstance encapsulation
 		};
 
+		// A string literal is kept by pointer.  A writable char array (text built
+		// in a local buffer) and anything else goes through the string constructor's
+		// interning, since the Msg outlives the caller's stack frame.
+		template<size_t N> Msg( char const (&_logtext)[N], uint8 _targetNodeId, uint8 const _msgType, uint8 const _function, bool const _bCallbackRequired, bool const _bReplyRequired = true, uint8 const _expectedReply = 0, uint8 const _expectedCommandClassId = 0 ):
+			m_logText( _logtext )
+		{
+			Init( _targetNodeId, _msgType, _function, _bCallbackRequired, _bReplyRequired, _expectedReply, _expectedCommandClassId );
+		}
+		template<size_t N> Msg( char (&_logtext)[N], uint8 _targetNodeId, uint8 const _msgType, uint8 const _function, bool const _bCallbackRequired, bool const _bReplyRequired = true, uint8 const _expectedReply = 0, uint8 const _expectedCommandClassId = 0 ):
+			m_logText( InternLogText( _logtext ) )
+		{
+			Init( _targetNodeId, _msgType, _function, _bCallbackRequired, _bReplyRequired, _expectedReply, _expectedCommandClassId );
+		}
 		Msg( string const& _logtext, uint8 _targetNodeId, uint8 const _msgType, uint8 const _function, bool const _bCallbackRequired, bool const _bReplyRequired = true, uint8 const _expectedReply = 0, uint8 const _expectedCommandClassId = 0 );
 		~Msg(){}
 
+		// A Msg is built for every frame sent, so freed ones are kept for reuse
+		static void* operator new( size_t _size );
+		static void operator delete( void* _p );
+
 		void SetInstance( CommandClass* _cc, uint8 const _instance );	// Used to enable wrapping with MultiInstance/MultiChannel during finalize.
 
 		void Append( uint8 const _data );
@@ -103,7 +121,7 @@ namespace OpenZWave
 		 * \brief get the LogText Associated with this message
 		 * \return the LogText used during the constructor
 		 */
-		string GetLogText()const{ return m_logText; }
+		string GetLogText()const;
 
 		uint32 GetLength()const{ return m_length; }
 		uint8* GetBuffer(){ return m_buffer; }
@@ -124,6 +142,24 @@ namespace OpenZWave
 			return( m_bFinal && (m_length==11) && (m_buffer[3]==0x13) && (m_buffer[6]==0x00) && (m_buffer[7]==0x00) );
 		}
 
+		/**
+		 * \brief Mark this message as setting the state of one value, so that a later
+		 * message for the same value may replace it while it is still queued.
+		 * \see Supersedes, Driver::SendMsg
+		 */
+		void SetSupersedable( uint8 const _commandClassId, uint8 const _instance, uint8 const _index ){ m_supersedeKey = 0x01000000 | ((uint32)_commandClassId<<16) | ((uint32)_instance<<8) | _index; }
+
+		/**
+		 * \brief Whether this message sets the same value of the same node as _other,
+		 * which makes _other redundant if it has not been sent yet.
+		 */
+		bool Supersedes( Msg const& _other )const{ return( m_supersedeKey && ( m_supersedeKey == _other.m_supersedeKey ) && ( m_targetNodeId == _other.m_targetNodeId ) ); }
+
+		/**
+		 * \brief Whether this message sets a value of the given command class on the given node.
+		 */
+		bool SetsCommandClass( uint8 const _nodeId, uint8 const _commandClassId )const{ return( m_supersedeKey && ( (uint8)( m_supersedeKey >> 16 ) == _commandClassId ) && ( m_targetNodeId == _nodeId ) ); }
+
 		bool operator == ( Msg const& _other )const
 		{
 			if( m_bFinal && _other.m_bFinal )
@@ -144,10 +180,13 @@ namespace OpenZWave
 		}
 
 	private:
+		void Init( uint8 _targetNodeId, uint8 const _msgType, uint8 const _function, bool const _bCallbackRequired, bool const _bReplyRequired, uint8 const _expectedReply, uint8 const _expectedCommandClassId );
 		void MultiEncap();					// Encapsulate the data inside a MultiInstance/Multicommand message
+		static char const* InternLogText( string const& _logText );
 
-		string			m_logText;
+		char const*		m_logText;			// Either a literal or an interned string, so never freed
 		bool			m_bFinal;
+		bool			m_bEncapsulated;		// true once MultiEncap has wrapped the message
 		bool			m_bCallbackRequired;
 
 		uint8			m_callbackId;
@@ -163,8 +202,13 @@ namespace OpenZWave
 		uint8			m_instance;
 		uint8			m_endPoint;			// Endpoint to use if the message must be wrapped in a multiInstance or multiChannel command class
 		uint8			m_flags;
+		uint32			m_supersedeKey;		// Command class, instance and index of the value this message sets, or zero
 
 		static uint8		s_nextCallbackId;		// counter to get a unique callback id
+
+		static Mutex*		s_poolMutex;			// guards the free list and the interned log text
+		static void*		s_freeList;				// freed Msg blocks, linked through their first word
+		static uint32		s_freeCount;
 	};
 
 } // namespace OpenZWave
@@ -78,6 +78,25 @@ bool Node::s_deviceClassesLoaded = false;
 map<uint8,string> Node::s_basicDeviceClasses;
 map<uint8,Node::GenericDeviceClass*> Node::s_genericDeviceClasses;
 
+// Record layout of the device_classes.xml cache.  Keys are the class type
+// in bits 16-23 (see below), the generic key in bits 8-15 and the specific
+// key in bits 0-7.  Command classes are stored as a zero-terminated string.
+struct DeviceClassRecord
+{
+	uint64	m_key;
+	uint32	m_label;
+	uint32	m_commandClasses;
+	uint8	m_basicMapping;
+	uint8	m_reserved[7];
+};
+
+enum
+{
+	DeviceClassRecord_Basic		= 1,
+	DeviceClassRecord_Generic,
+	DeviceClassRecord_Specific
+};
+
 static char const* c_queryStageNames[] =
 {
 	"ProtocolInfo",
@@ -157,6 +176,7 @@ Node::Node
 {
 	memset( m_neighbors, 0, sizeof(m_neighbors) );
 	memset( m_routeNodes, 0, sizeof(m_routeNodes) );
+	memset( m_commandClassTable, 0, sizeof(m_commandClassTable) );
 	AddCommandClass( 0 );
 }
 
@@ -190,6 +210,7 @@ Node::~Node
 	while( !m_commandClassMap.empty() )
 	{
 		map<uint8,CommandClass*>::iterator it = m_commandClassMap.begin();
+		m_commandClassTable[it->first] = NULL;
 		delete it->second;
 		m_commandClassMap.erase( it );
 	}
@@ -232,6 +253,7 @@ void Node::AdvanceQueries
 	// each stage is only visited once.
 
 	Log::Write( LogLevel_Detail, m_nodeId, "AdvanceQueries queryPending=%d queryRetries=%d queryStage=%s live=%d", m_queryPending, m_queryRetries, c_queryStageNames[m_queryStage], m_nodeAlive );
+	QueryStage startStage = m_queryStage;
 	bool addQSC = false;			// We only want to add a query stage complete if we did some work.
 	while( !m_queryPending && m_nodeAlive )
 	{
@@ -622,6 +644,12 @@ void Node::AdvanceQueries
 		}
 	}
 
+	if( m_queryStage != startStage )
+	{
+		// The query stage is saved, so that queries resume where they left off
+		GetDriver()->NodeConfigChanged( m_nodeId );
+	}
+
 	if( addQSC && m_nodeAlive )
 	{
 		// Add a marker to the query queue so this advance method
@@ -655,6 +683,9 @@ void Node::QueryStageComplete
 			m_queryStage = (QueryStage)( (uint32)m_queryStage + 1 );
 		}
 		m_queryRetries = 0;
+
+		// The stage and whatever the command classes learned in it are saved
+		GetDriver()->NodeConfigChanged( m_nodeId );
 	}
 }
 
@@ -685,6 +716,7 @@ void Node::QueryStageRetry
 		if( m_queryStage != QueryStage_Probe && m_queryStage != QueryStage_Probe1 )
 		{
 			m_queryStage = (Node::QueryStage)( (uint32)(m_queryStage + 1) );
+			GetDriver()->NodeConfigChanged( m_nodeId );
 		}
 	}
 	// Repeat the current query stage
@@ -705,6 +737,7 @@ void Node::SetQueryStage
 	{
 		m_queryStage = _stage;
 		m_queryPending = false;
+		GetDriver()->NodeConfigChanged( m_nodeId );
 
 		if( QueryStage_Configuration == _stage )
 		{
@@ -1557,14 +1590,8 @@ CommandClass* Node::GetCommandClass
 	uint8 const _commandClassId
 )const
 {
-	map<uint8,CommandClass*>::const_iterator it = m_commandClassMap.find( _commandClassId );
-	if( it != m_commandClassMap.end() )
-	{
-		return it->second;
-	}
-
-	// Not found
-	return NULL;
+	// NULL if not supported
+	return m_commandClassTable[_commandClassId];
 }
 
 //-----------------------------------------------------------------------------
@@ -1586,6 +1613,7 @@ CommandClass* Node::AddCommandClass
 	if( CommandClass* pCommandClass = CommandClasses::CreateCommandClass( _commandClassId, m_homeId, m_nodeId ) )
 	{
 		m_commandClassMap[_commandClassId] = pCommandClass;
+		m_commandClassTable[_commandClassId] = pCommandClass;
 		return pCommandClass;
 	}
 	else
@@ -1605,12 +1633,12 @@ void Node::RemoveCommandClass
 	uint8 const _commandClassId
 )
 {
-	map<uint8,CommandClass*>::iterator it = m_commandClassMap.find( _commandClassId );
-	if( it == m_commandClassMap.end() )
+	if( m_commandClassTable[_commandClassId] == NULL )
 	{
 		// Class is not found
 		return;
 	}
+	map<uint8,CommandClass*>::iterator it = m_commandClassMap.find( _commandClassId );
 
 	// Remove all the values associated with this class
 	if( ValueStore* store = GetValueStore() )
@@ -1621,6 +1649,7 @@ void Node::RemoveCommandClass
 	// Destroy the command class object and remove it from our map
 	Log::Write( LogLevel_Info, m_nodeId, "RemoveCommandClass - Removed support for %s", it->second->GetCommandClassName().c_str() );
 
+	m_commandClassTable[_commandClassId] = NULL;
 	delete it->second;
 	m_commandClassMap.erase( it );
 }
@@ -2701,6 +2730,17 @@ void Node::ReadDeviceClasses
 
 	string filename =  configPath + string("device_classes.xml");
 
+	string userPath;
+	Options::Get()->GetOptionAsString( "UserPath", &userPath );
+	string cacheFile = userPath + "device_classes.cache";
+
+	if( ReadDeviceClassCache( filename, cacheFile ) )
+	{
+		s_deviceClassesLoaded = true;
+		return;
+	}
+	ConfigCache::Writer writer( filename, sizeof(DeviceClassRecord) );
+
 	TiXmlDocument doc;
 	if( !doc.LoadFile( filename.c_str(), TIXML_ENCODING_UTF8 ) )
 	{
@@ -2743,6 +2783,108 @@ void Node::ReadDeviceClasses
 	}
 
 	s_deviceClassesLoaded = true;
+
+	// Save what we read for the next start
+	WriteDeviceClassCache( &writer );
+	writer.Write( cacheFile );
+}
+
+//-----------------------------------------------------------------------------
+// <Node::ReadDeviceClassCache>
+// Build the device class maps from the compiled cache, if it is current
+//-----------------------------------------------------------------------------
+bool Node::ReadDeviceClassCache
+(
+	string const& _filename,
+	string const& _cacheFile
+)
+{
+	ConfigCache* cache = ConfigCache::Open( _filename, _cacheFile, sizeof(DeviceClassRecord) );
+	if( cache == NULL )
+	{
+		return false;
+	}
+
+	// Generic classes first, so the specific classes have somewhere to go
+	for( int pass=0; pass<2; ++pass )
+	{
+		for( uint32 i=0; i<cache->GetRecordCount(); ++i )
+		{
+			DeviceClassRecord const* record = (DeviceClassRecord const*)cache->GetRecord( i );
+			uint8 type = (uint8)( record->m_key >> 16 );
+			uint8 generic = (uint8)( record->m_key >> 8 );
+			uint8 key = (uint8)record->m_key;
+			string label = cache->GetString( record->m_label );
+			char const* ccs = cache->GetString( record->m_commandClasses );
+
+			if( pass == 0 && type == DeviceClassRecord_Basic )
+			{
+				s_basicDeviceClasses[key] = label;
+			}
+			else if( pass == 0 && type == DeviceClassRecord_Generic )
+			{
+				s_genericDeviceClasses[generic] = new GenericDeviceClass( label, ccs, record->m_basicMapping );
+			}
+			else if( pass == 1 && type == DeviceClassRecord_Specific )
+			{
+				map<uint8,GenericDeviceClass*>::iterator git = s_genericDeviceClasses.find( generic );
+				if( git != s_genericDeviceClasses.end() )
+				{
+					git->second->AddSpecificDeviceClass( key, new DeviceClass( label, ccs, record->m_basicMapping ) );
+				}
+			}
+		}
+	}
+
+	delete cache;
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+// <Node::WriteDeviceClassCache>
+// Add the device class maps to a cache image
+//-----------------------------------------------------------------------------
+void Node::WriteDeviceClassCache
+(
+	ConfigCache::Writer* _writer
+)
+{
+	DeviceClassRecord record;
+
+	for( map<uint8,string>::iterator bit = s_basicDeviceClasses.begin(); bit != s_basicDeviceClasses.end(); ++bit )
+	{
+		memset( &record, 0, sizeof(record) );
+		record.m_key = ( DeviceClassRecord_Basic << 16 ) | bit->first;
+		record.m_label = _writer->AddString( bit->second );
+		_writer->AddRecord( &record );
+	}
+
+	for( map<uint8,GenericDeviceClass*>::iterator git = s_genericDeviceClasses.begin(); git != s_genericDeviceClasses.end(); ++git )
+	{
+		GenericDeviceClass* genericDeviceClass = git->second;
+		uint8 const* ccs = genericDeviceClass->GetMandatoryCommandClasses();
+
+		memset( &record, 0, sizeof(record) );
+		record.m_key = ( DeviceClassRecord_Generic << 16 ) | ( git->first << 8 );
+		record.m_label = _writer->AddString( genericDeviceClass->GetLabel() );
+		record.m_commandClasses = _writer->AddString( ccs ? (char const*)ccs : "" );
+		record.m_basicMapping = genericDeviceClass->GetBasicMapping();
+		_writer->AddRecord( &record );
+
+		map<uint8,DeviceClass*> const& specifics = genericDeviceClass->GetSpecificDeviceClasses();
+		for( map<uint8,DeviceClass*>::const_iterator sit = specifics.begin(); sit != specifics.end(); ++sit )
+		{
+			DeviceClass* specificDeviceClass = sit->second;
+			ccs = specificDeviceClass->GetMandatoryCommandClasses();
+
+			memset( &record, 0, sizeof(record) );
+			record.m_key = ( DeviceClassRecord_Specific << 16 ) | ( git->first << 8 ) | sit->first;
+			record.m_label = _writer->AddString( specificDeviceClass->GetLabel() );
+			record.m_commandClasses = _writer->AddString( ccs ? (char const*)ccs : "" );
+			record.m_basicMapping = specificDeviceClass->GetBasicMapping();
+			_writer->AddRecord( &record );
+		}
+	}
 }
 
 //-----------------------------------------------------------------------------
@@ -2830,6 +2972,29 @@ Node::DeviceClass::DeviceClass
 	}
 }
 
+//-----------------------------------------------------------------------------
+// <DeviceClass::DeviceClass>
+// Constructor, from the device class cache
+//-----------------------------------------------------------------------------
+Node::DeviceClass::DeviceClass
+(
+	string const& _label,
+	char const* _commandClasses,
+	uint8 const _basicMapping
+):
+	m_mandatoryCommandClasses(NULL),
+	m_basicMapping(_basicMapping),
+	m_label(_label)
+{
+	// An empty list is stored as no list at all, as for a missing attribute
+	size_t numCCs = strlen( _commandClasses );
+	if( numCCs )
+	{
+		m_mandatoryCommandClasses = new uint8[numCCs+1];
+		memcpy( m_mandatoryCommandClasses, _commandClasses, numCCs+1 );
+	}
+}
+
 //-----------------------------------------------------------------------------
 // <Node::GenericDeviceClass::GenericDeviceClass>
 // Constructor
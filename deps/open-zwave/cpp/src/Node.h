@@ -36,6 +36,7 @@
 #include "value_classes/ValueID.h"
 #include "value_classes/ValueList.h"
 #include "Msg.h"
+#include "ConfigCache.h"
 #include "platform/TimeStamp.h"
 
 class TiXmlElement;
@@ -398,6 +399,7 @@ namespace OpenZWave
 		void WriteXML( TiXmlElement* _nodeElement );
 
 		map<uint8,CommandClass*>		m_commandClassMap;	/**< Map of command class ids and pointers to associated command class objects */
+		CommandClass*				m_commandClassTable[256];	/**< The same pointers indexed by class id, so GetCommandClass is a single lookup on the receive path.  m_commandClassMap is kept for iteration in id order. */
 
 	//-----------------------------------------------------------------------------
 	// Basic commands (helpers that go through the basic command class)
@@ -487,6 +489,7 @@ namespace OpenZWave
 		{
 		public:
 			DeviceClass( TiXmlElement const* _el );
+			DeviceClass( string const& _label, char const* _commandClasses, uint8 const _basicMapping );
 			~DeviceClass(){ delete [] m_mandatoryCommandClasses; }
 
 			uint8 const*	GetMandatoryCommandClasses(){ return m_mandatoryCommandClasses; }
@@ -504,9 +507,12 @@ namespace OpenZWave
 		{
 		public:
 			GenericDeviceClass( TiXmlElement const* _el );
+			GenericDeviceClass( string const& _label, char const* _commandClasses, uint8 const _basicMapping ): DeviceClass( _label, _commandClasses, _basicMapping ){}
 			~GenericDeviceClass();
 
 			DeviceClass* GetSpecificDeviceClass( uint8 const& _specific );
+			void AddSpecificDeviceClass( uint8 const _specific, DeviceClass* _deviceClass ){ m_specificDeviceClasses[_specific] = _deviceClass; }
+			map<uint8,DeviceClass*> const& GetSpecificDeviceClasses()const{ return m_specificDeviceClasses; }
 
 		private:
 			map<uint8,DeviceClass*>	m_specificDeviceClasses;
@@ -516,6 +522,8 @@ namespace OpenZWave
 		bool SetDeviceClasses( uint8 const _basic, uint8 const _generic, uint8 const _specific );	// Set the device class data for the node
 		bool AddMandatoryCommandClasses( uint8 const* _commandClasses );							// Add mandatory command classes as specified in the device_classes.xml to the node.
 		void ReadDeviceClasses();																	// Read the static device class data from the device_classes.xml file
+		bool ReadDeviceClassCache( string const& _filename, string const& _cacheFile );			// Read the same data from its compiled cache, if that is current
+		void WriteDeviceClassCache( ConfigCache::Writer* _writer );								// Add the device class data to a cache image
 		string GetEndPointDeviceClassLabel( uint8 const _generic, uint8 const _specific );
 
 		static bool								s_deviceClassesLoaded;		// True if the xml file has alreayd been loaded
@@ -90,7 +90,7 @@ Options* Options::Create
 				exit( 1 );
 			}
 		}
-		FileOps::Destroy();
+		// FileOps stays alive with Options, for the config caches
 		s_instance = new Options( configPath, userPath, _commandLine );
 
 		// Add the default options
@@ -104,6 +104,7 @@ Options* Options::Create
 		s_instance->AddOptionInt(		"SaveLogLevel",				LogLevel_Detail );			// Save (to file) log messages equal to or above LogLevel_Detail
 		s_instance->AddOptionInt(		"QueueLogLevel",			LogLevel_Debug );			// Save (in RAM) log messages equal to or above LogLevel_Debug
 		s_instance->AddOptionInt(		"DumpTriggerLevel",			LogLevel_None );			// Default is to never dump RAM-stored log messages
+		s_instance->AddOptionInt(		"AsyncLogBufferSize",		0 );						// If non-zero, log lines are written by a background thread through a buffer of this many bytes
 
 		s_instance->AddOptionBool(		"Associate",				true );						// Enable automatic association of the controller with group one of every device.
 		s_instance->AddOptionString(	"Exclude",					string(""),		true );		// Remove support for the listed command classes.
@@ -124,6 +125,8 @@ Options* Options::Create
 		s_instance->AddOptionBool( 		"EnableSIS", 				true);						// Automatically become a SUC if there is no SUC on the network.
 		s_instance->AddOptionBool( 		"AssumeAwake", 				true);						// Assume Devices that Support the Wakeup CC are awake when we first query them....
 		s_instance->AddOptionBool(		"NotifyOnDriverUnload",		false);						// Should we send the Node/Value Notifications on Driver Unloading - Read comments in Driver::~Driver() method about possible race conditions
+		s_instance->AddOptionBool(		"CoalesceSetCommands",		false);						// A Set for a value replaces an earlier Set of that value still waiting in the send queue, and duplicate pending Gets are dropped
+		s_instance->AddOptionBool(		"MulticastResendSet",		false);						// if true, a multicast Set is followed by the full Set to each node (for nodes out of direct range); if false, only by a Get, with a Set to nodes that did not change
 	}
 
 	return s_instance;
@@ -146,6 +149,7 @@ bool Options::Destroy
 
 	delete s_instance;
 	s_instance = NULL;
+	FileOps::Destroy();
 
 	return true;
 }
@@ -0,0 +1,107 @@
+//-----------------------------------------------------------------------------
+//
+//	Ring.h
+//
+//	Growable circular queue for the driver's message queues
+//
+//	SOFTWARE NOTICE AND LICENSE
+//
+//	This file is part of OpenZWave.
+//
+//	OpenZWave is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU Lesser General Public License as published
+//	by the Free Software Foundation, either version 3 of the License,
+//	or (at your option) any later version.
+//
+//	OpenZWave is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//	GNU Lesser General Public License for more details.
+//
+//	You should have received a copy of the GNU Lesser General Public License
+//	along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+
+#ifndef _Ring_H
+#define _Ring_H
+
+#include "Defs.h"
+
+namespace OpenZWave
+{
+	/** \brief A first-in first-out queue held in one circular array.
+	 *
+	 * Unlike a std::list, pushing an item does not allocate.  The array only
+	 * grows, doubling when it is full, so once a queue has seen its busiest
+	 * moment it never allocates again.  Items can be read in place by their
+	 * position from the front, which lets a caller remove items matching some
+	 * test by copying the survivors down and truncating the rest.
+	 * T must be default constructible and assignable.
+	 */
+	template<class T> class Ring
+	{
+	public:
+		Ring(): m_items( NULL ), m_capacity( 0 ), m_head( 0 ), m_count( 0 ){}
+		~Ring(){ delete [] m_items; }
+
+		bool IsEmpty()const{ return( m_count == 0 ); }
+		uint32 GetSize()const{ return m_count; }
+
+		T& Front(){ return m_items[m_head]; }
+		T& operator[]( uint32 _idx ){ return m_items[( m_head + _idx ) & ( m_capacity - 1 )]; }
+		T const& operator[]( uint32 _idx )const{ return m_items[( m_head + _idx ) & ( m_capacity - 1 )]; }
+
+		void PushBack( T const& _item )
+		{
+			if( m_count == m_capacity )
+			{
+				Grow();
+			}
+			m_items[( m_head + m_count ) & ( m_capacity - 1 )] = _item;
+			++m_count;
+		}
+
+		void PopFront()
+		{
+			m_items[m_head] = T();
+			m_head = ( m_head + 1 ) & ( m_capacity - 1 );
+			--m_count;
+		}
+
+		// Drop everything from position _size onwards
+		void Truncate( uint32 _size )
+		{
+			while( m_count > _size )
+			{
+				--m_count;
+				m_items[( m_head + m_count ) & ( m_capacity - 1 )] = T();
+			}
+		}
+
+	private:
+		Ring( Ring const& );					// prevent copy
+		Ring& operator = ( Ring const& );		// prevent assignment
+
+		void Grow()
+		{
+			uint32 capacity = m_capacity ? ( m_capacity << 1 ) : 16;
+			T* items = new T[capacity];
+			for( uint32 i=0; i<m_count; ++i )
+			{
+				items[i] = (*this)[i];
+			}
+			delete [] m_items;
+			m_items = items;
+			m_capacity = capacity;
+			m_head = 0;
+		}
+
+		T*		m_items;
+		uint32	m_capacity;						// Always zero or a power of two
+		uint32	m_head;
+		uint32	m_count;
+	};
+} // namespace OpenZWave
+
+#endif //_Ring_H
@@ -26,12 +26,16 @@
 //-----------------------------------------------------------------------------
 
 #include <cstring>
+#include <map>
 #include "Manager.h"
 #include "platform/Log.h"
 #include "value_classes/Value.h"
 #include "value_classes/ValueID.h"
 #include "Scene.h"
 #include "Options.h"
+#include "command_classes/Basic.h"
+#include "command_classes/SwitchBinary.h"
+#include "command_classes/SwitchMultilevel.h"
 
 #include "tinyxml.h"
 
@@ -470,12 +474,74 @@ bool Scene::Activate
 )
 {
 	bool res = true;
+
+	// Switches going to the same level are set together, so that a scene
+	// of several lights changes at once rather than one light at a time.
+	map<uint64,vector<ValueID> > switches;
 	for( vector<SceneStorage*>::iterator it = m_values.begin(); it != m_values.end(); ++it )
 	{
-		if ( !Manager::Get()->SetValue( (*it)->m_id, (*it)->m_value ) )
+		uint8 level;
+		if( GetSwitchLevel( (*it)->m_id, (*it)->m_value, &level ) )
+		{
+			uint64 key = ( ( (uint64)(*it)->m_id.GetHomeId() ) << 8 ) | level;
+			switches[key].push_back( (*it)->m_id );
+		}
+		else if ( !Manager::Get()->SetValue( (*it)->m_id, (*it)->m_value ) )
+		{
+			res = false;
+		}
+	}
+
+	for( map<uint64,vector<ValueID> >::iterator it = switches.begin(); it != switches.end(); ++it )
+	{
+		if( !Manager::Get()->SetValueMulticast( it->second, (uint8)( it->first & 0xff ) ) )
 		{
 			res = false;
 		}
 	}
 	return res;
 }
+
+//-----------------------------------------------------------------------------
+// <Scene::GetSwitchLevel>
+// Whether a scene value is a switch state or level, and if so what level
+//-----------------------------------------------------------------------------
+bool Scene::GetSwitchLevel
+(
+	ValueID const& _id,
+	string const& _value,
+	uint8* o_level
+)
+{
+	if( ( _id.GetInstance() != 1 ) || ( _id.GetIndex() != 0 ) )
+	{
+		return false;
+	}
+
+	uint8 const ccId = _id.GetCommandClassId();
+	if( ( ccId == SwitchBinary::StaticGetCommandClassId() ) && ( ValueID::ValueType_Bool == _id.GetType() ) )
+	{
+		// Same parsing as ValueBool::SetFromString
+		if( !strcasecmp( "true", _value.c_str() ) )
+		{
+			*o_level = 0xff;
+			return true;
+		}
+		if( !strcasecmp( "false", _value.c_str() ) )
+		{
+			*o_level = 0;
+			return true;
+		}
+	}
+	else if( ( ( ccId == Basic::StaticGetCommandClassId() ) || ( ccId == SwitchMultilevel::StaticGetCommandClassId() ) ) && ( ValueID::ValueType_Byte == _id.GetType() ) )
+	{
+		// Same parsing as ValueByte::SetFromString
+		uint32 val = (uint32)atoi( _value.c_str() );
+		if( val < 256 )
+		{
+			*o_level = (uint8)val;
+			return true;
+		}
+	}
+	return false;
+}
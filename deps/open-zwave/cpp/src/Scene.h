@@ -75,6 +75,7 @@ namespace OpenZWave
 		bool GetValue( ValueID const& _valueId, string* o_value );
 		bool SetValue( ValueID const& _valueId, string const& _value );
 		bool Activate();
+		static bool GetSwitchLevel( ValueID const& _id, string const& _value, uint8* o_level );
 
 	//-----------------------------------------------------------------------------
 	// ValueID/value storage
@@ -26,7 +26,6 @@
 //-----------------------------------------------------------------------------
 
 #include <math.h>
-#include <locale.h>
 #include "tinyxml.h"
 #include "command_classes/CommandClass.h"
 #include "command_classes/Basic.h"
@@ -519,9 +518,10 @@ void CommandClass::WriteXML
 
 //-----------------------------------------------------------------------------
 // <CommandClass::ExtractValue>
-// Read a value from a variable length sequence of bytes
+// Read a value from a variable length sequence of bytes.  The result is the
+// integer as sent, to be divided by 10 to the power of the precision.
 //-----------------------------------------------------------------------------
-string CommandClass::ExtractValue
+int32 CommandClass::ExtractValue
 (
 	uint8 const* _data,
 	uint8* _scale,
@@ -551,11 +551,8 @@ string CommandClass::ExtractValue
 	}
 
 	// Deal with sign extension.  All values are signed
-	string res;
 	if( _data[_valueOffset] & 0x80 )
 	{
-		res = "-";
-
 		// MSB is signed
 		if( size == 1 )
 		{
@@ -567,54 +564,7 @@ string CommandClass::ExtractValue
 		}
 	}
 
-	// Convert the integer to a decimal string.  We avoid
-	// using floats to prevent accuracy issues.
-	char numBuf[12] = {0};
-
-	if( precision == 0 )
-	{
-		// The precision is zero, so we can just print the number directly into the string.
-		snprintf( numBuf, 12, "%d", (signed int)value );
-		res = numBuf;
-	}
-	else
-	{
-		// We'll need to insert a decimal point and include any necessary leading zeros.
-
-		// Fill the buffer with the value padded with leading zeros.
-		snprintf( numBuf, 12, "%011d", (signed int)value );
-
-		// Calculate the position of the decimal point in the buffer
-		int32 decimal = 10-precision;
-
-		// Shift the characters to make space for the decimal point.
-		// We don't worry about overwriting any minus sign since that is
-		// already written into the res string. While we're shifting, we
-		// also look for the real starting position of the number so we
-		// can copy it into the res string later.
-		int32 start = -1;
-		for( int32 i=0; i<decimal; ++i )
-		{
-			numBuf[i] = numBuf[i+1];
-			if( ( start<0 ) && ( numBuf[i] != '0' ) )
-			{
-				start = i;
-			}
-		}
-		if( start<0 )
-		{
-			start = decimal-1;
-		}
-
-		// Insert the decimal point
-		struct lconv const* locale = localeconv();
-		numBuf[decimal] = *(locale->decimal_point);
-
-		// Copy the buffer into res
-		res += &numBuf[start];
-	}
-
-	return res;
+	return (int32)value;
 }
 
 //-----------------------------------------------------------------------------
@@ -115,7 +115,7 @@ namespace OpenZWave
 		void SetSecureSupport() { m_SecureSupport = true; }
 
 		// Helper methods
-		string ExtractValue( uint8 const* _data, uint8* _scale, uint8* _precision, uint8 _valueOffset = 1 )const;
+		int32 ExtractValue( uint8 const* _data, uint8* _scale, uint8* _precision, uint8 _valueOffset = 1 )const;
 
 		/**
 		 *  Append a floating-point value to a message.
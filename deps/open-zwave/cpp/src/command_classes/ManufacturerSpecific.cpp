@@ -52,6 +52,18 @@ enum ManufacturerSpecificCmd
 map<uint16,string> ManufacturerSpecific::s_manufacturerMap;
 map<int64,ManufacturerSpecific::Product*> ManufacturerSpecific::s_productMap;
 bool ManufacturerSpecific::s_bXmlLoaded = false;
+ConfigCache* ManufacturerSpecific::s_productCache = NULL;
+
+// Record layout of the manufacturer_specific.xml cache.  Products are keyed
+// on Product::GetKey, and manufacturers on their id plus c_manufacturerKey.
+struct ProductRecord
+{
+	uint64	m_key;
+	uint32	m_name;
+	uint32	m_configPath;
+};
+
+static uint64 const c_manufacturerKey = 1ULL << 48;
 
 //-----------------------------------------------------------------------------
 // <ManufacturerSpecific::RequestState>
@@ -126,19 +138,9 @@ string ManufacturerSpecific::SetProductDetails
 	string configPath = "";
 
 	// Try to get the real manufacturer and product names
-	map<uint16,string>::iterator mit = s_manufacturerMap.find( manufacturerId );
-	if( mit != s_manufacturerMap.end() )
+	if( FindManufacturer( manufacturerId, &manufacturerName ) )
 	{
-		// Replace the id with the real name
-		manufacturerName = mit->second;
-
-		// Get the product
-		map<int64,Product*>::iterator pit = s_productMap.find( Product::GetKey( manufacturerId, productType, productId ) );
-		if( pit != s_productMap.end() )
-		{
-			productName = pit->second->GetProductName();
-			configPath = pit->second->GetConfigPath();
-		}
+		FindProduct( manufacturerId, productType, productId, &productName, &configPath );
 	}
 
 	// Set the values into the node
@@ -231,6 +233,18 @@ bool ManufacturerSpecific::LoadProductXML
 
 	string filename =  configPath + "manufacturer_specific.xml";
 
+	// Use the compiled image of the file if it is up to date
+	string userPath;
+	Options::Get()->GetOptionAsString( "UserPath", &userPath );
+	string cacheFile = userPath + "manufacturer_specific.cache";
+
+	s_productCache = ConfigCache::Open( filename, cacheFile, sizeof(ProductRecord) );
+	if( s_productCache != NULL )
+	{
+		return true;
+	}
+	ConfigCache::Writer writer( filename, sizeof(ProductRecord) );
+
 	TiXmlDocument* pDoc = new TiXmlDocument();
 	if( !pDoc->LoadFile( filename.c_str(), TIXML_ENCODING_UTF8 ) )
 	{
@@ -337,6 +351,105 @@ bool ManufacturerSpecific::LoadProductXML
 	}
 
 	delete pDoc;
+
+	// Save the maps for the next start
+	WriteProductCache( &writer );
+	writer.Write( cacheFile );
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+// <ManufacturerSpecific::WriteProductCache>
+// Add the manufacturer and product maps to a cache image
+//-----------------------------------------------------------------------------
+void ManufacturerSpecific::WriteProductCache
+(
+	ConfigCache::Writer* _writer
+)
+{
+	for( map<uint16,string>::iterator mit = s_manufacturerMap.begin(); mit != s_manufacturerMap.end(); ++mit )
+	{
+		ProductRecord record;
+		memset( &record, 0, sizeof(record) );
+		record.m_key = c_manufacturerKey | mit->first;
+		record.m_name = _writer->AddString( mit->second );
+		_writer->AddRecord( &record );
+	}
+
+	for( map<int64,Product*>::iterator pit = s_productMap.begin(); pit != s_productMap.end(); ++pit )
+	{
+		ProductRecord record;
+		memset( &record, 0, sizeof(record) );
+		record.m_key = (uint64)pit->first;
+		record.m_name = _writer->AddString( pit->second->GetProductName() );
+		record.m_configPath = _writer->AddString( pit->second->GetConfigPath() );
+		_writer->AddRecord( &record );
+	}
+}
+
+//-----------------------------------------------------------------------------
+// <ManufacturerSpecific::FindManufacturer>
+// Look up a manufacturer's name
+//-----------------------------------------------------------------------------
+bool ManufacturerSpecific::FindManufacturer
+(
+	uint16 _manufacturerId,
+	string* _manufacturerName
+)
+{
+	if( s_productCache != NULL )
+	{
+		ProductRecord const* record = (ProductRecord const*)s_productCache->Find( c_manufacturerKey | _manufacturerId );
+		if( record == NULL )
+		{
+			return false;
+		}
+		*_manufacturerName = s_productCache->GetString( record->m_name );
+		return true;
+	}
+
+	map<uint16,string>::iterator mit = s_manufacturerMap.find( _manufacturerId );
+	if( mit == s_manufacturerMap.end() )
+	{
+		return false;
+	}
+	*_manufacturerName = mit->second;
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+// <ManufacturerSpecific::FindProduct>
+// Look up a product's name and config file
+//-----------------------------------------------------------------------------
+bool ManufacturerSpecific::FindProduct
+(
+	uint16 _manufacturerId,
+	uint16 _productType,
+	uint16 _productId,
+	string* _productName,
+	string* _configPath
+)
+{
+	int64 key = Product::GetKey( _manufacturerId, _productType, _productId );
+	if( s_productCache != NULL )
+	{
+		ProductRecord const* record = (ProductRecord const*)s_productCache->Find( (uint64)key );
+		if( record == NULL )
+		{
+			return false;
+		}
+		*_productName = s_productCache->GetString( record->m_name );
+		*_configPath = s_productCache->GetString( record->m_configPath );
+		return true;
+	}
+
+	map<int64,Product*>::iterator pit = s_productMap.find( key );
+	if( pit == s_productMap.end() )
+	{
+		return false;
+	}
+	*_productName = pit->second->GetProductName();
+	*_configPath = pit->second->GetConfigPath();
 	return true;
 }
 
@@ -365,6 +478,9 @@ void ManufacturerSpecific::UnloadProductXML
 			mit = s_manufacturerMap.begin();
 		}
 
+		delete s_productCache;
+		s_productCache = NULL;
+
 		s_bXmlLoaded = false;
 	}
 }
@@ -427,18 +543,14 @@ void ManufacturerSpecific::ReLoadConfigXML
 		uint16 productType = (uint16)strtol( node->GetProductType().c_str(), NULL, 16 );
 		uint16 productId = (uint16)strtol( node->GetProductId().c_str(), NULL, 16 );
 
-		map<uint16,string>::iterator mit = s_manufacturerMap.find( manufacturerId );
-		if( mit != s_manufacturerMap.end() )
+		string manufacturerName;
+		string productName;
+		string configPath;
+		if( FindManufacturer( manufacturerId, &manufacturerName ) &&
+			FindProduct( manufacturerId, productType, productId, &productName, &configPath ) &&
+			configPath.size() > 0 )
 		{
-			map<int64,Product*>::iterator pit = s_productMap.find( Product::GetKey( manufacturerId, productType, productId ) );
-			if( pit != s_productMap.end() )
-			{
-				string configPath = pit->second->GetConfigPath();
-				if( configPath.size() > 0 )
-				{
-					LoadConfigXML( node, configPath );
-				}
-			}
+			LoadConfigXML( node, configPath );
 		}
 	}
 }
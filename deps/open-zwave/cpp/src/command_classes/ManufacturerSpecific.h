@@ -30,6 +30,7 @@
 
 #include <map>
 #include "command_classes/CommandClass.h"
+#include "ConfigCache.h"
 
 namespace OpenZWave
 {
@@ -60,6 +61,9 @@ namespace OpenZWave
 		ManufacturerSpecific( uint32 const _homeId, uint8 const _nodeId ): CommandClass( _homeId, _nodeId ){ SetStaticRequest( StaticRequest_Values ); }
 		static bool LoadProductXML();
 		static void UnloadProductXML();
+		static bool FindManufacturer( uint16 _manufacturerId, string* _manufacturerName );
+		static bool FindProduct( uint16 _manufacturerId, uint16 _productType, uint16 _productId, string* _productName, string* _configPath );
+		static void WriteProductCache( ConfigCache::Writer* _writer );
 
 		class Product
 		{
@@ -108,6 +112,7 @@ namespace OpenZWave
 		static map<uint16,string>	s_manufacturerMap;
 		static map<int64,Product*>	s_productMap;
 		static bool					s_bXmlLoaded;
+		static ConfigCache*			s_productCache;		// When set, lookups go here and the maps are empty
 	};
 
 } // namespace OpenZWave
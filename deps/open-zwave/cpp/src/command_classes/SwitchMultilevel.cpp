@@ -445,6 +445,7 @@ bool SwitchMultilevel::SetLevel
 	Log::Write( LogLevel_Info, GetNodeId(), "SwitchMultilevel::Set - Setting to level %d", _level );
 	Msg* msg = new Msg( "SwitchMultiLevel Set", GetNodeId(), REQUEST, FUNC_ID_ZW_SEND_DATA, true );
 	msg->SetInstance( this, _instance );
+	msg->SetSupersedable( GetCommandClassId(), _instance, SwitchMultilevelIndex_Level );
 	msg->Append( GetNodeId() );
 
 	if( ValueByte* durationValue = static_cast<ValueByte*>( GetValue( _instance, SwitchMultilevelIndex_Duration ) ) )
@@ -309,6 +309,7 @@ bool ThermostatFanMode::SetValue
 
 		Msg* msg = new Msg( "ThermostatFanModeCmd_Set", GetNodeId(), REQUEST, FUNC_ID_ZW_SEND_DATA, true );
 		msg->SetInstance( this, _value.GetID().GetInstance() );
+		msg->SetSupersedable( GetCommandClassId(), _value.GetID().GetInstance(), _value.GetID().GetIndex() );
 		msg->Append( GetNodeId() );
 		msg->Append( 3 );
 		msg->Append( GetCommandClassId() );
@@ -228,17 +228,14 @@ bool ThermostatSetpoint::HandleMsg
 		{
 			uint8 scale;
 			uint8 precision = 0;
-			string temperature = ExtractValue( &_data[2], &scale, &precision );
+			int32 temperature = ExtractValue( &_data[2], &scale, &precision );
 
 			value->SetUnits( scale ? "F" : "C" );
-			value->OnValueRefreshed( temperature );
-			if( value->GetPrecision() != precision )
-			{
-				value->SetPrecision( precision );
-			}
-			value->Release();
+			value->OnValueRefreshed( temperature, precision );
 
-			Log::Write( LogLevel_Info, GetNodeId(), "Received thermostat setpoint report: Setpoint %s = %s%s", value->GetLabel().c_str(), value->GetValue().c_str(), value->GetUnits().c_str() );
+			char valueStr[ValueDecimal::c_maxFormatLength];
+			Log::Write( LogLevel_Info, GetNodeId(), "Received thermostat setpoint report: Setpoint %s = %s%s", value->GetLabel().c_str(), ValueDecimal::Format( ValueDecimal::Decimal( temperature, precision ), valueStr ), value->GetUnits().c_str() );
+			value->Release();
 		}
 		return true;
 	}
@@ -292,6 +289,7 @@ bool ThermostatSetpoint::SetValue
 
 		Msg* msg = new Msg( "Set Thermostat Setpoint", GetNodeId(), REQUEST, FUNC_ID_ZW_SEND_DATA, true );
 		msg->SetInstance( this, _value.GetID().GetInstance() );
+		msg->SetSupersedable( GetCommandClassId(), _value.GetID().GetInstance(), _value.GetID().GetIndex() );
 		msg->Append( GetNodeId() );
 		msg->Append( 4 + GetAppendValueSize( value->GetValue() ) );
 		msg->Append( GetCommandClassId() );
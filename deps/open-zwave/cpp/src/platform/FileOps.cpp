@@ -82,6 +82,74 @@ bool FileOps::FolderExists
 	return false;
 }
 
+//-----------------------------------------------------------------------------
+//	<FileOps::FileInfo>
+//	Static method to get the modification time and size of a file
+//-----------------------------------------------------------------------------
+bool FileOps::FileInfo
+(
+	string const& _fileName,
+	uint64* _modified,
+	uint64* _size
+)
+{
+	if( s_instance != NULL )
+	{
+		return s_instance->m_pImpl->FileInfo( _fileName, _modified, _size );
+	}
+	return false;
+}
+
+//-----------------------------------------------------------------------------
+//	<FileOps::MapFile>
+//	Static method to map a file into memory
+//-----------------------------------------------------------------------------
+void const* FileOps::MapFile
+(
+	string const& _fileName,
+	uint32* _size
+)
+{
+	if( s_instance != NULL )
+	{
+		return s_instance->m_pImpl->MapFile( _fileName, _size );
+	}
+	return NULL;
+}
+
+//-----------------------------------------------------------------------------
+//	<FileOps::UnmapFile>
+//	Static method to release a file mapping
+//-----------------------------------------------------------------------------
+void FileOps::UnmapFile
+(
+	void const* _data,
+	uint32 const _size
+)
+{
+	if( s_instance != NULL )
+	{
+		s_instance->m_pImpl->UnmapFile( _data, _size );
+	}
+}
+
+//-----------------------------------------------------------------------------
+//	<FileOps::ReplaceFile>
+//	Static method to atomically replace one file with another
+//-----------------------------------------------------------------------------
+bool FileOps::ReplaceFile
+(
+	string const& _source,
+	string const& _target
+)
+{
+	if( s_instance != NULL )
+	{
+		return s_instance->m_pImpl->ReplaceFile( _source, _target );
+	}
+	return false;
+}
+
 //-----------------------------------------------------------------------------
 //	<FileOps::FileOps>
 //	Constructor
@@ -61,6 +61,40 @@ namespace OpenZWave
 		 */
 		static bool FolderExists( const string &_folderName );
 
+		/**
+		 * FileInfo. Get the modification time and size of a file.
+		 * \param _fileName. File name.
+		 * \param _modified. Receives the modification time, in seconds.
+		 * \param _size. Receives the size in bytes.
+		 * \return True if the file exists.
+		 */
+		static bool FileInfo( string const& _fileName, uint64* _modified, uint64* _size );
+
+		/**
+		 * MapFile. Map a whole file read-only into memory.
+		 * \param _fileName. File name.
+		 * \param _size. Receives the size of the mapping.
+		 * \return Pointer to the file contents, or NULL on failure.
+		 * \see UnmapFile.
+		 */
+		static void const* MapFile( string const& _fileName, uint32* _size );
+
+		/**
+		 * UnmapFile. Release a mapping made by MapFile.
+		 * \param _data. Pointer returned by MapFile.
+		 * \param _size. Size returned by MapFile.
+		 */
+		static void UnmapFile( void const* _data, uint32 const _size );
+
+		/**
+		 * ReplaceFile. Atomically move a file over another, so readers see
+		 * either the old contents or the new, never a partial write.
+		 * \param _source. File to move.
+		 * \param _target. File to replace.
+		 * \return True on success.
+		 */
+		static bool ReplaceFile( string const& _source, string const& _target );
+
 	private:
 		FileOps();
 		~FileOps();
@@ -60,8 +60,24 @@ char const *OpenZWave::LogLevelString[] =
 
 Log* Log::s_instance = NULL;
 i_LogImpl* Log::m_pImpl = NULL;
+LogLevel Log::s_maxLevel = LogLevel_None;
 static bool s_dologging;
 
+//-----------------------------------------------------------------------------
+//	<GetMaxLevel>
+//	The least severe level the log implementation will do anything with
+//-----------------------------------------------------------------------------
+static LogLevel GetMaxLevel
+(
+	LogLevel _queueLevel,
+	LogLevel _dumpTrigger
+)
+{
+	// LogImpl drops anything less severe than _queueLevel, except for
+	// messages that only trigger a dump of the queue.
+	return( _queueLevel > _dumpTrigger ? _queueLevel : _dumpTrigger );
+}
+
 //-----------------------------------------------------------------------------
 //	<Log::Create>
 //	Static creation of the singleton
@@ -73,12 +89,14 @@ Log* Log::Create
 	bool const _bConsoleOutput,
 	LogLevel const _saveLevel,
 	LogLevel const _queueLevel,
-	LogLevel const _dumpTrigger
+	LogLevel const _dumpTrigger,
+	uint32 const _asyncBufferSize
 )
 {
 	if( NULL == s_instance )
 	{
-		s_instance = new Log( _filename, _bAppend, _bConsoleOutput, _saveLevel, _queueLevel, _dumpTrigger );
+		s_instance = new Log( _filename, _bAppend, _bConsoleOutput, _saveLevel, _queueLevel, _dumpTrigger, _asyncBufferSize );
+		s_maxLevel = GetMaxLevel( _queueLevel, _dumpTrigger );
 		s_dologging = true; // default logging to true so no change to what people experience now
 	}
 
@@ -188,6 +206,7 @@ void Log::SetLoggingState
 	{
 	  	s_instance->m_logMutex->Lock();
 		s_instance->m_pImpl->SetLoggingState( _saveLevel, _queueLevel, _dumpTrigger );
+		s_maxLevel = GetMaxLevel( _queueLevel, _dumpTrigger );
 		s_instance->m_logMutex->Unlock();
 	}
 	
@@ -205,6 +224,23 @@ bool Log::GetLoggingState
 	return s_dologging;
 }
 
+//-----------------------------------------------------------------------------
+//	<Log::IsLevelEnabled>
+//	Return whether a message at this level would be acted upon
+//-----------------------------------------------------------------------------
+bool Log::IsLevelEnabled
+(
+	LogLevel _level
+)
+{
+	if( s_instance && s_dologging && s_instance->m_pImpl )
+	{
+		return( ( _level <= s_maxLevel ) || ( _level == LogLevel_Internal ) );
+	}
+
+	return false;
+}
+
 //-----------------------------------------------------------------------------
 //	<Log::Write>
 //	Write to the log
@@ -216,7 +252,8 @@ void Log::Write
 	...
 )
 {
-	if( s_instance && s_dologging && s_instance->m_pImpl )
+	// Filter before taking the mutex so discarded messages cost nothing
+	if( IsLevelEnabled( _level ) )
 	{
 		s_instance->m_logMutex->Lock(); // double locks if recursive
 		va_list args;
@@ -239,7 +276,8 @@ void Log::Write
 	...
 )
 {
-	if( s_instance && s_dologging && s_instance->m_pImpl )
+	// Filter before taking the mutex so discarded messages cost nothing
+	if( IsLevelEnabled( _level ) )
 	{
 		if( _level != LogLevel_Internal )
 		  	s_instance->m_logMutex->Lock();
@@ -252,6 +290,25 @@ void Log::Write
 	}
 }
 
+//-----------------------------------------------------------------------------
+//	<Log::GetDroppedLineCount>
+//	Number of lines discarded by the log implementation
+//-----------------------------------------------------------------------------
+uint32 Log::GetDroppedLineCount
+(
+)
+{
+	uint32 dropped = 0;
+	if( s_instance && s_instance->m_pImpl )
+	{
+	  	s_instance->m_logMutex->Lock();
+		dropped = s_instance->m_pImpl->GetDroppedLineCount();
+		s_instance->m_logMutex->Unlock();
+	}
+
+	return dropped;
+}
+
 //-----------------------------------------------------------------------------
 //	<Log::QueueDump>
 //	Send queued messages to the log (and empty the queue)
@@ -312,12 +369,13 @@ Log::Log
 	bool const _bConsoleOutput,
 	LogLevel const _saveLevel,
 	LogLevel const _queueLevel,
-	LogLevel const _dumpTrigger
+	LogLevel const _dumpTrigger,
+	uint32 const _asyncBufferSize
 ):
 	m_logMutex( new Mutex() )
 {
         if (NULL == m_pImpl) 
-        	m_pImpl = new LogImpl( _filename, _bAppend, _bConsoleOutput, _saveLevel, _queueLevel, _dumpTrigger );
+        	m_pImpl = new LogImpl( _filename, _bAppend, _bConsoleOutput, _saveLevel, _queueLevel, _dumpTrigger, _asyncBufferSize );
 }
 
 //-----------------------------------------------------------------------------
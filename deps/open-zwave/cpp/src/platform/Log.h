@@ -64,6 +64,7 @@ namespace OpenZWave
 		virtual void QueueClear() = 0;
 		virtual void SetLoggingState( LogLevel _saveLevel, LogLevel _queueLevel, LogLevel _dumpTrigger ) = 0;
 		virtual void SetLogFileName( const string &_filename ) = 0;
+		virtual uint32 GetDroppedLineCount() { return 0; }
 	};
 
 	/** \brief Implements a platform-independent log...written to the console and, optionally, a file.
@@ -75,10 +76,12 @@ namespace OpenZWave
 		 * Create a log.
 		 * Creates the cross-platform logging singleton.
 		 * Any previous log will be cleared.
+		 * \param _asyncBufferSize If non-zero, lines are handed to a background thread through a buffer
+		 * of this many bytes instead of being written by the caller.  Lines that do not fit are dropped.
 		 * \return a pointer to the logging object.
 		 * \see Destroy, Write
 		 */
-		static Log* Create( string const& _filename, bool const _bAppend, bool const _bConsoleOutput, LogLevel const _saveLevel, LogLevel const _queueLevel, LogLevel const _dumpTrigger );
+		static Log* Create( string const& _filename, bool const _bAppend, bool const _bConsoleOutput, LogLevel const _saveLevel, LogLevel const _queueLevel, LogLevel const _dumpTrigger, uint32 const _asyncBufferSize = 0 );
 
 		/**
 		 * Create a log.
@@ -135,6 +138,15 @@ namespace OpenZWave
 		*/
 		static void GetLoggingState( LogLevel* _saveLevel, LogLevel* _queueLevel, LogLevel* _dumpTrigger );
 
+		/**
+		 * \brief Determine whether a message at the given level would be written, queued or trigger a dump.
+		 * Write already performs this check before doing any work, but callers whose arguments are
+		 * expensive to build (packet dumps, Msg::GetAsString etc.) can use it to skip building them.
+		 * \param _level	LogLevel of the message
+		 * \return true if a message at this level would be acted upon.
+		*/
+		static bool IsLevelEnabled( LogLevel _level );
+
 		/**
 		 * \brief Change the log file name.  This will start a new log file (or potentially start appending
 		 * information to an existing one.  Developers might want to use this function, together with a timer
@@ -164,6 +176,12 @@ namespace OpenZWave
 		 */
 		static void Write( LogLevel _level, uint8 const _nodeId, char const* _format, ... );
 
+		/**
+		 * Number of lines the log implementation has had to discard.
+		 * Only the asynchronous writer drops lines, when its buffer is full.
+		 */
+		static uint32 GetDroppedLineCount();
+
 		/**
 		 * Send the queued log messages to the log output.
 		 */
@@ -175,11 +193,12 @@ namespace OpenZWave
 		static void QueueClear();
 
 	private:
-		Log( string const& _filename, bool const _bAppend, bool const _bConsoleOutput, LogLevel _saveLevel, LogLevel _queueLevel, LogLevel _dumpTrigger );
+		Log( string const& _filename, bool const _bAppend, bool const _bConsoleOutput, LogLevel _saveLevel, LogLevel _queueLevel, LogLevel _dumpTrigger, uint32 const _asyncBufferSize );
 		~Log();
 
 		static i_LogImpl*	m_pImpl;		/**< Pointer to an object that encapsulates the platform-specific logging implementation. */
 		static Log*	s_instance;
+		static LogLevel	s_maxLevel;		/**< Least severe level that is written, queued or triggers a dump */
 		Mutex*		m_logMutex;
 	};
 } // namespace OpenZWave
@@ -0,0 +1,209 @@
+//-----------------------------------------------------------------------------
+//
+//	LogRing.cpp
+//
+//	Fixed-size ring of binary log records kept for dumping on error
+//
+//	SOFTWARE NOTICE AND LICENSE
+//
+//	This file is part of OpenZWave.
+//
+//	OpenZWave is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU Lesser General Public License as published
+//	by the Free Software Foundation, either version 3 of the License,
+//	or (at your option) any later version.
+//
+//	OpenZWave is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//	GNU Lesser General Public License for more details.
+//
+//	You should have received a copy of the GNU Lesser General Public License
+//	along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+#include <string.h>
+
+#include "Defs.h"
+#include "platform/LogRing.h"
+
+using namespace OpenZWave;
+
+//-----------------------------------------------------------------------------
+//	<LogRing::LogRing>
+//	Constructor
+//-----------------------------------------------------------------------------
+LogRing::LogRing
+(
+	uint32 const _size
+):
+	m_buffer( new uint8[_size] ),
+	m_size( _size ),
+	m_head( 0 ),
+	m_tail( 0 ),
+	m_used( 0 ),
+	m_count( 0 )
+{
+}
+
+//-----------------------------------------------------------------------------
+//	<LogRing::~LogRing>
+//	Destructor
+//-----------------------------------------------------------------------------
+LogRing::~LogRing
+(
+)
+{
+	delete [] m_buffer;
+}
+
+//-----------------------------------------------------------------------------
+//	<LogRing::Push>
+//	Append a record, discarding the oldest ones to make room
+//-----------------------------------------------------------------------------
+void LogRing::Push
+(
+	Record const& _record,
+	char const* _text,
+	uint32 _length
+)
+{
+	if( m_size <= sizeof(Record) )
+	{
+		return;
+	}
+
+	// Truncate anything that could never fit
+	if( _length > m_size - sizeof(Record) )
+	{
+		_length = m_size - sizeof(Record);
+	}
+	if( _length > 0xffff )
+	{
+		_length = 0xffff;
+	}
+
+	uint32 required = sizeof(Record) + _length;
+	while( m_size - m_used < required )
+	{
+		Discard();
+	}
+
+	Record header = _record;
+	header.m_length = (uint16)_length;
+	Put( (uint8 const*)&header, sizeof(Record) );
+	Put( (uint8 const*)_text, _length );
+	++m_count;
+}
+
+//-----------------------------------------------------------------------------
+//	<LogRing::Pop>
+//	Remove the oldest record
+//-----------------------------------------------------------------------------
+bool LogRing::Pop
+(
+	Record* o_record,
+	char* o_text,
+	uint32 const _textSize
+)
+{
+	if( !m_count || !_textSize )
+	{
+		return false;
+	}
+
+	Get( (uint8*)o_record, sizeof(Record) );
+
+	uint32 length = o_record->m_length;
+	uint32 copied = ( length < _textSize ) ? length : _textSize - 1;
+	Get( (uint8*)o_text, copied );
+	o_text[copied] = 0;
+	Skip( length - copied );
+
+	--m_count;
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+//	<LogRing::Clear>
+//	Discard all records
+//-----------------------------------------------------------------------------
+void LogRing::Clear
+(
+)
+{
+	m_head = 0;
+	m_tail = 0;
+	m_used = 0;
+	m_count = 0;
+}
+
+//-----------------------------------------------------------------------------
+//	<LogRing::Put>
+//	Copy bytes in at the head, wrapping at the end of the buffer
+//-----------------------------------------------------------------------------
+void LogRing::Put
+(
+	uint8 const* _data,
+	uint32 const _length
+)
+{
+	uint32 block1 = m_size - m_head;
+	if( block1 > _length )
+	{
+		block1 = _length;
+	}
+	memcpy( m_buffer + m_head, _data, block1 );
+	memcpy( m_buffer, _data + block1, _length - block1 );
+
+	m_head = ( m_head + _length ) % m_size;
+	m_used += _length;
+}
+
+//-----------------------------------------------------------------------------
+//	<LogRing::Get>
+//	Copy bytes out from the tail, wrapping at the end of the buffer
+//-----------------------------------------------------------------------------
+void LogRing::Get
+(
+	uint8* o_data,
+	uint32 const _length
+)
+{
+	uint32 block1 = m_size - m_tail;
+	if( block1 > _length )
+	{
+		block1 = _length;
+	}
+	memcpy( o_data, m_buffer + m_tail, block1 );
+	memcpy( o_data + block1, m_buffer, _length - block1 );
+
+	Skip( _length );
+}
+
+//-----------------------------------------------------------------------------
+//	<LogRing::Skip>
+//	Advance the tail without copying
+//-----------------------------------------------------------------------------
+void LogRing::Skip
+(
+	uint32 const _length
+)
+{
+	m_tail = ( m_tail + _length ) % m_size;
+	m_used -= _length;
+}
+
+//-----------------------------------------------------------------------------
+//	<LogRing::Discard>
+//	Drop the oldest record
+//-----------------------------------------------------------------------------
+void LogRing::Discard
+(
+)
+{
+	Record header;
+	Get( (uint8*)&header, sizeof(Record) );
+	Skip( header.m_length );
+	--m_count;
+}
@@ -0,0 +1,104 @@
+//-----------------------------------------------------------------------------
+//
+//	LogRing.h
+//
+//	Fixed-size ring of binary log records kept for dumping on error
+//
+//	SOFTWARE NOTICE AND LICENSE
+//
+//	This file is part of OpenZWave.
+//
+//	OpenZWave is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU Lesser General Public License as published
+//	by the Free Software Foundation, either version 3 of the License,
+//	or (at your option) any later version.
+//
+//	OpenZWave is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//	GNU Lesser General Public License for more details.
+//
+//	You should have received a copy of the GNU Lesser General Public License
+//	along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+#ifndef _LogRing_H
+#define _LogRing_H
+
+#include "Defs.h"
+
+namespace OpenZWave
+{
+	/** \brief Fixed-size store for the "queue and dump on error" log messages.
+	 *
+	 * Each record is a small binary header followed by the message text, packed
+	 * end to end in a single buffer allocated up front.  When a new record does
+	 * not fit, the oldest records are discarded to make room, so queuing a line
+	 * never allocates.  Timestamps and thread ids are kept in binary form and
+	 * are only turned into text by the log implementation when the ring is dumped.
+	 */
+	class LogRing
+	{
+	public:
+		struct Record
+		{
+			uint64	m_time;			// Platform-specific timestamp
+			uint64	m_threadId;		// Platform-specific thread id
+			uint8	m_level;		// LogLevel of the message
+			uint8	m_nodeId;
+			uint16	m_length;		// Bytes of text following the header
+		};
+
+		/**
+		 * Constructor.
+		 * \param _size Size of the buffer in bytes, including record headers.
+		 */
+		LogRing( uint32 const _size );
+		~LogRing();
+
+		/**
+		 * Append a record, discarding the oldest records if there is no room.
+		 * Text longer than the buffer can hold is truncated.
+		 * \param _record Header for the new record.  m_length is ignored.
+		 * \param _text Message text, which need not be null-terminated.
+		 * \param _length Number of bytes in _text.
+		 */
+		void Push( Record const& _record, char const* _text, uint32 _length );
+
+		/**
+		 * Remove the oldest record.
+		 * \param o_record Filled with the record header.
+		 * \param o_text Filled with the null-terminated record text.
+		 * \param _textSize Size of o_text.  Text that does not fit is truncated.
+		 * \return false if the ring is empty.
+		 */
+		bool Pop( Record* o_record, char* o_text, uint32 const _textSize );
+
+		/**
+		 * Discard all records.
+		 */
+		void Clear();
+
+		/**
+		 * Number of records currently held.
+		 */
+		uint32 GetCount()const{ return m_count; }
+
+	private:
+		void Put( uint8 const* _data, uint32 const _length );
+		void Get( uint8* o_data, uint32 const _length );
+		void Skip( uint32 const _length );
+		void Discard();
+
+		uint8*	m_buffer;
+		uint32	m_size;
+		uint32	m_head;				// Where the next record is written
+		uint32	m_tail;				// Start of the oldest record
+		uint32	m_used;				// Bytes between m_tail and m_head
+		uint32	m_count;			// Records between m_tail and m_head
+	};
+
+} // namespace OpenZWave
+
+#endif //_LogRing_H
+
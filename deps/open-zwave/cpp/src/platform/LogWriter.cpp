@@ -0,0 +1,250 @@
+//-----------------------------------------------------------------------------
+//
+//	LogWriter.cpp
+//
+//	Background writer that takes formatted log lines off the caller's
+//	thread and writes them to the log file in batches.
+//
+//	SOFTWARE NOTICE AND LICENSE
+//
+//	This file is part of OpenZWave.
+//
+//	OpenZWave is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU Lesser General Public License as published
+//	by the Free Software Foundation, either version 3 of the License,
+//	or (at your option) any later version.
+//
+//	OpenZWave is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//	GNU Lesser General Public License for more details.
+//
+//	You should have received a copy of the GNU Lesser General Public License
+//	along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+#include <string.h>
+
+#include "Defs.h"
+#include "platform/LogWriter.h"
+#include "platform/Event.h"
+#include "platform/Mutex.h"
+#include "platform/Thread.h"
+#include "platform/Wait.h"
+
+using namespace OpenZWave;
+
+//-----------------------------------------------------------------------------
+//	<LogWriter::LogWriter>
+//	Constructor
+//-----------------------------------------------------------------------------
+LogWriter::LogWriter
+(
+	FILE* _file,
+	bool const _bConsoleOutput,
+	uint32 const _bufferSize
+):
+	m_file( _file ),
+	m_bConsoleOutput( _bConsoleOutput ),
+	m_buffer( new uint8[_bufferSize] ),
+	m_bufferSize( _bufferSize ),
+	m_head( 0 ),
+	m_tail( 0 ),
+	m_used( 0 ),
+	m_dropped( 0 ),
+	m_droppedReported( 0 ),
+	m_mutex( new Mutex() ),
+	m_dataEvent( new Event() ),
+	m_thread( new Thread( "log" ) )
+{
+	m_thread->Start( LogWriter::WriterThreadEntryPoint, this );
+}
+
+//-----------------------------------------------------------------------------
+//	<LogWriter::~LogWriter>
+//	Destructor
+//-----------------------------------------------------------------------------
+LogWriter::~LogWriter
+(
+)
+{
+	// The writer thread drains the buffer one last time before it exits
+	m_thread->Stop();
+	m_thread->Release();
+
+	m_dataEvent->Release();
+	m_mutex->Release();
+	delete [] m_buffer;
+}
+
+//-----------------------------------------------------------------------------
+//	<LogWriter::Write>
+//	Copy a line into the ring buffer, or drop it if there is no room
+//-----------------------------------------------------------------------------
+bool LogWriter::Write
+(
+	char const* _line,
+	uint32 const _length
+)
+{
+	if( !_length )
+	{
+		return true;
+	}
+
+	m_mutex->Lock();
+
+	if( _length > ( m_bufferSize - m_used ) )
+	{
+		++m_dropped;
+		m_mutex->Unlock();
+		return false;
+	}
+
+	// The free space may wrap around the end of the buffer
+	uint32 block1 = m_bufferSize - m_head;
+	if( block1 > _length )
+	{
+		block1 = _length;
+	}
+	memcpy( m_buffer + m_head, _line, block1 );
+	memcpy( m_buffer, _line + block1, _length - block1 );
+
+	m_head = ( m_head + _length ) % m_bufferSize;
+	m_used += _length;
+	m_dataEvent->Set();
+
+	m_mutex->Unlock();
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+//	<LogWriter::GetDroppedCount>
+//	Number of lines dropped because the buffer was full
+//-----------------------------------------------------------------------------
+uint32 LogWriter::GetDroppedCount
+(
+)
+{
+	m_mutex->Lock();
+	uint32 dropped = m_dropped;
+	m_mutex->Unlock();
+	return dropped;
+}
+
+//-----------------------------------------------------------------------------
+//	<LogWriter::WriterThreadEntryPoint>
+//	Entry point of the thread that writes the log
+//-----------------------------------------------------------------------------
+void LogWriter::WriterThreadEntryPoint
+(
+	Event* _exitEvent,
+	void* _context
+)
+{
+	LogWriter* writer = (LogWriter*)_context;
+	if( writer )
+	{
+		writer->WriterThreadProc( _exitEvent );
+	}
+}
+
+//-----------------------------------------------------------------------------
+//	<LogWriter::WriterThreadProc>
+//	Write out buffered lines whenever there are any
+//-----------------------------------------------------------------------------
+void LogWriter::WriterThreadProc
+(
+	Event* _exitEvent
+)
+{
+	Wait* waitObjects[2];
+	waitObjects[0] = _exitEvent;		// Thread must exit.
+	waitObjects[1] = m_dataEvent;		// Lines have been queued.
+
+	while( true )
+	{
+		int32 res = Wait::Multiple( waitObjects, 2 );
+		Drain();
+		if( res == 0 )
+		{
+			// Exit has been called
+			return;
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------
+//	<LogWriter::Drain>
+//	Write everything currently in the buffer.  Only the indices are read
+//	under the lock; the writes themselves happen with it released, since
+//	Write never touches bytes between m_tail and m_head.
+//-----------------------------------------------------------------------------
+void LogWriter::Drain
+(
+)
+{
+	m_mutex->Lock();
+	m_dataEvent->Reset();
+	uint32 tail = m_tail;
+	uint32 used = m_used;
+	uint32 dropped = m_dropped;
+	m_mutex->Unlock();
+
+	if( used )
+	{
+		uint32 block1 = m_bufferSize - tail;
+		if( block1 > used )
+		{
+			block1 = used;
+		}
+		Output( (char const*)m_buffer + tail, block1 );
+		Output( (char const*)m_buffer, used - block1 );
+	}
+
+	if( dropped != m_droppedReported )
+	{
+		char buf[64];
+		snprintf( buf, sizeof(buf), "Log buffer full - %u lines dropped\n", dropped - m_droppedReported );
+		Output( buf, (uint32)strlen( buf ) );
+		m_droppedReported = dropped;
+	}
+
+	if( m_file != NULL )
+	{
+		fflush( m_file );
+	}
+
+	if( used )
+	{
+		m_mutex->Lock();
+		m_tail = ( tail + used ) % m_bufferSize;
+		m_used -= used;
+		m_mutex->Unlock();
+	}
+}
+
+//-----------------------------------------------------------------------------
+//	<LogWriter::Output>
+//	Write a block of text to the file and the console
+//-----------------------------------------------------------------------------
+void LogWriter::Output
+(
+	char const* _data,
+	uint32 const _length
+)
+{
+	if( !_length )
+	{
+		return;
+	}
+
+	if( m_file != NULL )
+	{
+		fwrite( _data, 1, _length, m_file );
+	}
+	if( m_bConsoleOutput )
+	{
+		fwrite( _data, 1, _length, stdout );
+	}
+}
@@ -0,0 +1,102 @@
+//-----------------------------------------------------------------------------
+//
+//	LogWriter.h
+//
+//	Background writer that takes formatted log lines off the caller's
+//	thread and writes them to the log file in batches.
+//
+//	SOFTWARE NOTICE AND LICENSE
+//
+//	This file is part of OpenZWave.
+//
+//	OpenZWave is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU Lesser General Public License as published
+//	by the Free Software Foundation, either version 3 of the License,
+//	or (at your option) any later version.
+//
+//	OpenZWave is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//	GNU Lesser General Public License for more details.
+//
+//	You should have received a copy of the GNU Lesser General Public License
+//	along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+#ifndef _LogWriter_H
+#define _LogWriter_H
+
+#include <stdio.h>
+#include "Defs.h"
+
+namespace OpenZWave
+{
+	class Event;
+	class Mutex;
+	class Thread;
+
+	/** \brief Moves log output off the logging thread.
+	 *
+	 * Write copies a formatted line into a fixed-size ring buffer and returns
+	 * immediately.  A dedicated thread drains the buffer to the log file (and
+	 * optionally the console) in as few writes as possible.  If the buffer is
+	 * full the line is dropped rather than blocking the caller, and the number
+	 * of dropped lines is recorded in the log once space becomes available.
+	 */
+	class LogWriter
+	{
+	public:
+		/**
+		 * Constructor.
+		 * Starts the writer thread.
+		 * \param _file The file to write to, or NULL.  The file is not closed by the LogWriter.
+		 * \param _bConsoleOutput If true, lines are also copied to stdout.
+		 * \param _bufferSize Size of the ring buffer in bytes.
+		 */
+		LogWriter( FILE* _file, bool const _bConsoleOutput, uint32 const _bufferSize );
+
+		/**
+		 * Destructor.
+		 * Writes out anything still buffered and stops the writer thread.
+		 */
+		~LogWriter();
+
+		/**
+		 * Queue a line for writing.  The line should already contain its trailing newline.
+		 * \param _line The formatted text.
+		 * \param _length Number of bytes in _line.
+		 * \return false if there was no room and the line was dropped.
+		 */
+		bool Write( char const* _line, uint32 const _length );
+
+		/**
+		 * Total number of lines dropped because the buffer was full.
+		 */
+		uint32 GetDroppedCount();
+
+	private:
+		static void WriterThreadEntryPoint( Event* _exitEvent, void* _context );
+		void WriterThreadProc( Event* _exitEvent );
+		void Drain();
+		void Output( char const* _data, uint32 const _length );
+
+		FILE*		m_file;
+		bool		m_bConsoleOutput;
+
+		uint8*		m_buffer;
+		uint32		m_bufferSize;
+		uint32		m_head;				// Next byte to be written by Write
+		uint32		m_tail;				// Next byte to be read by the writer thread
+		uint32		m_used;				// Bytes between m_tail and m_head
+		uint32		m_dropped;			// Lines dropped since construction
+		uint32		m_droppedReported;	// Value of m_dropped last noted in the log
+
+		Mutex*		m_mutex;			// Guards the ring indices only; never held during I/O
+		Event*		m_dataEvent;		// Set when the buffer has data for the writer thread
+		Thread*		m_thread;
+	};
+
+} // namespace OpenZWave
+
+#endif //_LogWriter_H
+
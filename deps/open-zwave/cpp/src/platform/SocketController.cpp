@@ -0,0 +1,130 @@
+//-----------------------------------------------------------------------------
+//
+//	SocketController.cpp
+//
+//	Cross-platform socket connection to a Z-Wave controller
+//
+//	SOFTWARE NOTICE AND LICENSE
+//
+//	This file is part of OpenZWave.
+//
+//	OpenZWave is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU Lesser General Public License as published
+//	by the Free Software Foundation, either version 3 of the License,
+//	or (at your option) any later version.
+//
+//	OpenZWave is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//	GNU Lesser General Public License for more details.
+//
+//	You should have received a copy of the GNU Lesser General Public License
+//	along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+
+#include "Defs.h"
+
+#ifdef WIN32
+#include "platform/windows/SocketControllerImpl.h"	// Platform-specific implementation of a socket
+#else
+#include "platform/unix/SocketControllerImpl.h"	// Platform-specific implementation of a socket
+#endif
+
+#include "platform/SocketController.h"
+#include "platform/Log.h"
+
+using namespace OpenZWave;
+
+//-----------------------------------------------------------------------------
+//	<SocketController::SocketController>
+//	Constructor
+//-----------------------------------------------------------------------------
+SocketController::SocketController
+(
+):
+	m_bOpen( false )
+{
+	m_pImpl = new SocketControllerImpl( this );
+}
+
+//-----------------------------------------------------------------------------
+//	<SocketController::~SocketController>
+//	Destructor
+//-----------------------------------------------------------------------------
+SocketController::~SocketController
+(
+)
+{
+	delete m_pImpl;
+}
+
+//-----------------------------------------------------------------------------
+//	<SocketController::IsSocketPath>
+//	Test whether a controller path names a socket
+//-----------------------------------------------------------------------------
+bool SocketController::IsSocketPath
+(
+	string const& _path
+)
+{
+	return( ( _path.compare( 0, 6, "tcp://" ) == 0 ) || ( _path.compare( 0, 7, "unix://" ) == 0 ) );
+}
+
+//-----------------------------------------------------------------------------
+//	<SocketController::Open>
+//	Connect to the socket
+//-----------------------------------------------------------------------------
+bool SocketController::Open
+(
+	string const& _socketPath
+)
+{
+	if( m_bOpen )
+	{
+		return false;
+	}
+
+	m_socketPath = _socketPath;
+	m_bOpen = m_pImpl->Open();
+	return m_bOpen;
+}
+
+//-----------------------------------------------------------------------------
+//	<SocketController::Close>
+//	Close the socket
+//-----------------------------------------------------------------------------
+bool SocketController::Close
+(
+)
+{
+	if( !m_bOpen )
+	{
+		return false;
+	}
+
+	m_pImpl->Close();
+	m_bOpen = false;
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+//	<SocketController::Write>
+//	Write data to the socket
+//-----------------------------------------------------------------------------
+uint32 SocketController::Write
+(
+	uint8* _buffer,
+	uint32 _length
+)
+{
+	if( !m_bOpen )
+	{
+		return 0;
+	}
+
+	Log::Write( LogLevel_StreamDetail, "      SocketController::Write (sent to controller)" );
+	LogData(_buffer, _length, "      Write: ");
+
+	return( m_pImpl->Write( _buffer, _length ) );
+}
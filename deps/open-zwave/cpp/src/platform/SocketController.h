@@ -0,0 +1,100 @@
+//-----------------------------------------------------------------------------
+//
+//	SocketController.h
+//
+//	Cross-platform socket connection to a Z-Wave controller
+//
+//	SOFTWARE NOTICE AND LICENSE
+//
+//	This file is part of OpenZWave.
+//
+//	OpenZWave is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU Lesser General Public License as published
+//	by the Free Software Foundation, either version 3 of the License,
+//	or (at your option) any later version.
+//
+//	OpenZWave is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//	GNU Lesser General Public License for more details.
+//
+//	You should have received a copy of the GNU Lesser General Public License
+//	along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+
+#ifndef _SocketController_H
+#define _SocketController_H
+
+#include <string>
+#include "Defs.h"
+#include "platform/Controller.h"
+
+namespace OpenZWave
+{
+	class SocketControllerImpl;
+
+	/** \brief A Z-Wave controller reached over a stream socket rather than a serial port.
+	 *
+	 * The controller path selects the socket: tcp://host:port for a serial-to-network
+	 * bridge or a simulated stick, or unix:///path/to/socket for a local simulator.
+	 * The Z-Wave serial protocol is carried over the socket unchanged.
+	 */
+	class SocketController: public Controller
+	{
+		friend class SocketControllerImpl;
+
+	public:
+		/**
+		 * Constructor.
+		 * Creates an object that represents a socket connection to a controller.
+		 */
+		SocketController();
+
+		/**
+		 * Destructor.
+		 * Destroys the socket connection object.
+		 */
+		virtual ~SocketController();
+
+		/**
+		 * Test whether a controller path names a socket.
+		 * @param _path The controller path passed to Manager::AddDriver.
+		 * @return True if the path starts with tcp:// or unix://.
+		 */
+		static bool IsSocketPath( string const& _path );
+
+		/**
+		 * Open a socket connection.
+		 * @param _socketPath The socket to connect to, as tcp://host:port or unix:///path.
+		 * @return True if the connection was made.
+		 * @see Close, Read, Write
+		 */
+		bool Open( string const& _socketPath );
+
+		/**
+		 * Close the socket connection.
+		 * @return True if the connection was closed, or false if it was already closed.
+		 * @see Open
+		 */
+		bool Close();
+
+		/**
+		 * Write to the socket.
+		 * @param _buffer Pointer to a block of memory containing the data to be written.
+		 * @param _length Length in bytes of the data.
+		 * @return The number of bytes written.
+		 * @see Read, Open, Close
+		 */
+		uint32 Write( uint8* _buffer, uint32 _length );
+
+	private:
+		string					m_socketPath;
+
+		SocketControllerImpl*	m_pImpl;	// Pointer to an object that encapsulates the platform-specific implementation of the socket.
+		bool					m_bOpen;
+	};
+
+} // namespace OpenZWave
+
+#endif //_SocketController_H
@@ -50,7 +50,10 @@ Stream::Stream
 	m_tail(0),
 	m_mutex( new Mutex() )
 {
-	m_buffer = new uint8[m_bufferSize];
+	// The padding after the end of the circular buffer is never written, so
+	// a view that ends close to the end is still followed by zeros.
+	m_buffer = new uint8[m_bufferSize + ViewPadding];
+	memset( m_buffer, 0, m_bufferSize + ViewPadding );
 }
 
 //-----------------------------------------------------------------------------
@@ -124,6 +127,129 @@ bool Stream::Get
 	return true;
 }
 
+//-----------------------------------------------------------------------------
+//	<Stream::GetView>
+//	Access data at the front of the buffer without removing it
+//-----------------------------------------------------------------------------
+uint8* Stream::GetView
+(
+	uint32 _size,
+	uint8* _scratch
+)
+{
+	if( m_dataSize < _size )
+	{
+		// There is not enough data in the buffer to fulfill the request
+		Log::Write( LogLevel_Error, "ERROR: Not enough data in stream buffer");
+		return NULL;
+	}
+
+	uint8* view;
+	m_mutex->Lock();
+	if( (m_tail + _size) > m_bufferSize )
+	{
+		// The data wraps around, so it has to be copied
+		uint32 block1 = m_bufferSize - m_tail;
+		uint32 block2 = _size - block1;
+
+		memcpy( _scratch, &m_buffer[m_tail], block1 );
+		memcpy( &_scratch[block1], m_buffer, block2 );
+		view = _scratch;
+	}
+	else
+	{
+		// Requested data is in a contiguous block
+		view = &m_buffer[m_tail];
+	}
+
+	LogData( view, _size, "      Read (buffer->application): ");
+	m_mutex->Unlock();
+	return view;
+}
+
+//-----------------------------------------------------------------------------
+//	<Stream::GetPaddedView>
+//	Access data at the front of the buffer, followed by zeros, and lock it
+//-----------------------------------------------------------------------------
+uint8* Stream::GetPaddedView
+(
+	uint32 _size,
+	uint8* _scratch
+)
+{
+	m_mutex->Lock();
+	if( m_dataSize < _size )
+	{
+		// There is not enough data in the buffer to fulfill the request
+		Log::Write( LogLevel_Error, "ERROR: Not enough data in stream buffer");
+		m_mutex->Unlock();
+		return NULL;
+	}
+
+	uint8* view;
+	if( ( m_dataSize == _size ) && ( (m_tail + _size) <= m_bufferSize ) )
+	{
+		// Nothing is waiting behind the data, so the space after it is free
+		// up to the end of the buffer, and the padding beyond that is zero.
+		view = &m_buffer[m_tail];
+		uint32 end = m_tail + _size;
+		uint32 clear = m_bufferSize - end;
+		if( clear > ViewPadding )
+		{
+			clear = ViewPadding;
+		}
+		memset( &m_buffer[end], 0, clear );
+	}
+	else
+	{
+		// The data wraps around, or the next message is already behind it
+		uint32 block1 = _size;
+		if( (m_tail + _size) > m_bufferSize )
+		{
+			block1 = m_bufferSize - m_tail;
+		}
+		memcpy( _scratch, &m_buffer[m_tail], block1 );
+		memcpy( &_scratch[block1], m_buffer, _size - block1 );
+		memset( &_scratch[_size], 0, ViewPadding );
+		view = _scratch;
+	}
+
+	LogData( view, _size, "      Read (buffer->application): ");
+	return view;
+}
+
+//-----------------------------------------------------------------------------
+//	<Stream::ReleaseView>
+//	Remove the data returned by GetPaddedView and unlock the buffer
+//-----------------------------------------------------------------------------
+void Stream::ReleaseView
+(
+	uint32 _size
+)
+{
+	Skip( _size );
+	m_mutex->Unlock();
+}
+
+//-----------------------------------------------------------------------------
+//	<Stream::Skip>
+//	Remove data from the buffer without copying it
+//-----------------------------------------------------------------------------
+void Stream::Skip
+(
+	uint32 _size
+)
+{
+	m_mutex->Lock();
+	if( _size > m_dataSize )
+	{
+		_size = m_dataSize;
+	}
+	m_tail = ( m_tail + _size ) % m_bufferSize;
+	m_dataSize -= _size;
+	m_mutex->Unlock();
+}
+
 //-----------------------------------------------------------------------------
 //	<Stream::Put>
 //	Add data to the buffer
@@ -209,7 +335,7 @@ void Stream::LogData
 	const string &_function
 )
 {
-	if( !_length ) return;
+	if( !_length || !Log::IsLevelEnabled( LogLevel_StreamDetail ) ) return;
 
 	string str = "";
 	for( uint32 i=0; i<_length; ++i ) 
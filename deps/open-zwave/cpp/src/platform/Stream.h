@@ -71,6 +71,51 @@ namespace OpenZWave
 		 */
 		bool Get( uint8* _buffer, uint32 _size );
 
+		/**
+		 * Gives direct access to data at the front of the stream, without removing it.
+		 * If the requested data is contiguous in the circular buffer, the returned pointer refers to
+		 * the buffer itself and nothing is copied.  Otherwise the data is copied into _scratch.
+		 * Either way the data stays valid until it is removed with Skip (or the stream is purged).
+		 * \param _size the amount of data in bytes required.
+		 * \param _scratch pointer to at least _size bytes, used only if the data wraps around.
+		 * \return pointer to the data, or NULL if there was not enough data in the stream.
+		 * \see Skip, Get
+		 */
+		uint8* GetView( uint32 _size, uint8* _scratch );
+
+		/**
+		 * Removes data from the front of the stream without copying it.
+		 * \param _size the amount of data in bytes to remove.
+		 * \see GetView
+		 */
+		void Skip( uint32 _size );
+
+		enum
+		{
+			ViewPadding = 512		// Zero bytes that follow the data returned by GetPaddedView
+		};
+
+		/**
+		 * As GetView, but the data is followed by ViewPadding zero bytes, so a parser that reads
+		 * past the end of a short message finds zeros rather than stale data.  When nothing else is
+		 * waiting behind the data, the padding is zeroed in the circular buffer and the pointer
+		 * refers to the buffer itself.  Otherwise the data and padding are built in _scratch.
+		 * The stream stays locked, so nothing can be written into the padding, until the data is
+		 * removed with ReleaseView.
+		 * \param _size the amount of data in bytes required.
+		 * \param _scratch pointer to at least _size + ViewPadding bytes.
+		 * \return pointer to the data, or NULL (with the stream unlocked) if there was not enough data.
+		 * \see ReleaseView, GetView
+		 */
+		uint8* GetPaddedView( uint32 _size, uint8* _scratch );
+
+		/**
+		 * Removes the data returned by GetPaddedView from the front of the stream, and unlocks it.
+		 * \param _size the amount of data in bytes to remove.
+		 * \see GetPaddedView
+		 */
+		void ReleaseView( uint32 _size );
+
 		/**
 		 * Copies the requested amount of data from the buffer into the stream.
 		 * If there is insufficient room available in the stream's circular buffer, and no data is transferred.
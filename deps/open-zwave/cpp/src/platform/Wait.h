@@ -41,6 +41,7 @@ namespace OpenZWave
 	class Wait: public Ref
 	{
 		friend class WaitImpl;
+		friend class WaitSet;
 		friend class ThreadImpl;
 
 	public:
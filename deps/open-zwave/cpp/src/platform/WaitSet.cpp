@@ -0,0 +1,155 @@
+//-----------------------------------------------------------------------------
+//
+//	WaitSet.cpp
+//
+//	Cross-platform set of Wait objects that is registered once and can
+//	then be waited on repeatedly without any per-wait allocation.
+//
+//	SOFTWARE NOTICE AND LICENSE
+//
+//	This file is part of OpenZWave.
+//
+//	OpenZWave is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU Lesser General Public License as published
+//	by the Free Software Foundation, either version 3 of the License,
+//	or (at your option) any later version.
+//
+//	OpenZWave is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//	GNU Lesser General Public License for more details.
+//
+//	You should have received a copy of the GNU Lesser General Public License
+//	along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+#include "Defs.h"
+#include "platform/Wait.h"
+#include "platform/WaitSet.h"
+#include "platform/TimeStamp.h"
+
+#ifdef WIN32
+#include "platform/windows/WaitSetImpl.h"	// Platform-specific implementation of a wait set
+#else
+#include "platform/unix/WaitSetImpl.h"	// Platform-specific implementation of a wait set
+#endif
+
+using namespace OpenZWave;
+
+//-----------------------------------------------------------------------------
+//	<WaitSet::WaitSet>
+//	Constructor
+//-----------------------------------------------------------------------------
+WaitSet::WaitSet
+(
+):
+	m_numObjects( 0 ),
+	m_pImpl( new WaitSetImpl() )
+{
+}
+
+//-----------------------------------------------------------------------------
+//	<WaitSet::~WaitSet>
+//	Destructor
+//-----------------------------------------------------------------------------
+WaitSet::~WaitSet
+(
+)
+{
+	// Remove our watchers before the impl goes away, since the
+	// callback context points at it.
+	for( uint32 i=0; i<m_numObjects; ++i )
+	{
+		m_objects[i]->RemoveWatcher( WaitSetCallback, m_pImpl );
+	}
+
+	delete m_pImpl;
+}
+
+//-----------------------------------------------------------------------------
+//	<WaitSet::Add>
+//	Add an object to the set and start watching it
+//-----------------------------------------------------------------------------
+int32 WaitSet::Add
+(
+	Wait* _object
+)
+{
+	if( m_numObjects >= MaxObjects )
+	{
+		assert(0);
+		return -1;
+	}
+
+	m_objects[m_numObjects] = _object;
+	_object->AddWatcher( WaitSetCallback, m_pImpl );
+	return (int32)(m_numObjects++);
+}
+
+//-----------------------------------------------------------------------------
+//	<WaitSet::Select>
+//	Wait for one of the first _numObjects objects to become signalled.
+//-----------------------------------------------------------------------------
+int32 WaitSet::Select
+(
+	uint32 _numObjects,
+	int32 _timeout // = -1
+)
+{
+	if( _numObjects > m_numObjects )
+	{
+		_numObjects = m_numObjects;
+	}
+
+	TimeStamp deadline;
+	if( _timeout > 0 )
+	{
+		deadline.SetTime( _timeout );
+	}
+
+	while( true )
+	{
+		// Any notification that arrives after this scan is latched by
+		// the impl, so the wait below cannot miss it.
+		for( uint32 i=0; i<_numObjects; ++i )
+		{
+			if( m_objects[i]->IsSignalled() )
+			{
+				return (int32)i;
+			}
+		}
+
+		int32 remaining = _timeout;
+		if( _timeout > 0 )
+		{
+			remaining = deadline.TimeRemaining();
+			if( remaining <= 0 )
+			{
+				return -1;
+			}
+		}
+		else if( _timeout == 0 )
+		{
+			return -1;
+		}
+
+		if( !m_pImpl->Wait( remaining ) )
+		{
+			// Timed out.
+			return -1;
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------
+//	<WaitSet::WaitSetCallback>
+//	Watcher callback added to every object in the set
+//-----------------------------------------------------------------------------
+void WaitSet::WaitSetCallback
+(
+	void* _context
+)
+{
+	WaitSetImpl* impl = (WaitSetImpl*)_context;
+	impl->Signal();
+}
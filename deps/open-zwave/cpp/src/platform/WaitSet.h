@@ -0,0 +1,92 @@
+//-----------------------------------------------------------------------------
+//
+//	WaitSet.h
+//
+//	Cross-platform set of Wait objects that is registered once and can
+//	then be waited on repeatedly without any per-wait allocation.
+//
+//	SOFTWARE NOTICE AND LICENSE
+//
+//	This file is part of OpenZWave.
+//
+//	OpenZWave is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU Lesser General Public License as published
+//	by the Free Software Foundation, either version 3 of the License,
+//	or (at your option) any later version.
+//
+//	OpenZWave is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//	GNU Lesser General Public License for more details.
+//
+//	You should have received a copy of the GNU Lesser General Public License
+//	along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+#ifndef _WaitSet_H
+#define _WaitSet_H
+
+#include "Defs.h"
+
+namespace OpenZWave
+{
+	class Wait;
+	class WaitSetImpl;
+
+	/** \brief Persistent alternative to Wait::Multiple.
+	 *
+	 * Wait::Multiple creates an Event and adds (then removes) a watcher on
+	 * every object each time it is called.  A WaitSet adds its watcher to
+	 * each object once, when the object is added, and keeps it until the set
+	 * is destroyed.  Waiting on the set is then just a scan of the objects
+	 * followed by a block on a single platform primitive (an eventfd watched
+	 * by epoll on Linux).
+	 */
+	class WaitSet
+	{
+	public:
+		enum
+		{
+			MaxObjects = 16
+		};
+
+		WaitSet();
+		~WaitSet();
+
+		/**
+		 * Add an object to the set.  The object is watched until the set is destroyed.
+		 * \param _object pointer to the object to add.
+		 * \return the index of the object within the set, or -1 if the set is full.
+		 */
+		int32 Add( Wait* _object );
+
+		/**
+		 * Wait for one of the first _numObjects objects in the set to become signalled.
+		 * If more than one object is in a signalled state, the lowest index will be returned,
+		 * exactly as with Wait::Multiple.
+		 * \param _numObjects number of objects, counting from the first one added, to wait on.
+		 * \param _timeout optional maximum time to wait.  Defaults to -1, which means wait forever.
+		 * \return index of the object that was signalled, -1 if the wait timed out.
+		 */
+		int32 Select( uint32 _numObjects, int32 _timeout = -1 );
+
+		/**
+		 * Get the number of objects in the set.
+		 */
+		uint32 GetCount()const{ return m_numObjects; }
+
+	private:
+		WaitSet( WaitSet const& );					// prevent copy
+		WaitSet& operator = ( WaitSet const& );		// prevent assignment
+
+		static void WaitSetCallback( void* _context );
+
+		Wait*			m_objects[MaxObjects];
+		uint32			m_numObjects;
+		WaitSetImpl*	m_pImpl;					// Pointer to an object that encapsulates the platform-specific wakeup primitive.
+	};
+
+} // namespace OpenZWave
+
+#endif //_WaitSet_H
+
@@ -27,6 +27,11 @@
 //-----------------------------------------------------------------------------
 
 #include <dirent.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 #include "FileOpsImpl.h"
 
 using namespace OpenZWave;
@@ -69,3 +74,87 @@ bool FileOpsImpl::FolderExists
 	else
 		return false;
 }
+
+//-----------------------------------------------------------------------------
+//	<FileOpsImpl::FileInfo>
+//	Get the modification time and size of a file
+//-----------------------------------------------------------------------------
+bool FileOpsImpl::FileInfo
+(
+	string const& _fileName,
+	uint64* _modified,
+	uint64* _size
+)
+{
+	struct stat st;
+	if( stat( _fileName.c_str(), &st ) != 0 || !S_ISREG( st.st_mode ) )
+	{
+		return false;
+	}
+
+	*_modified = (uint64)st.st_mtime;
+	*_size = (uint64)st.st_size;
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+//	<FileOpsImpl::MapFile>
+//	Map a file read-only into memory
+//-----------------------------------------------------------------------------
+void const* FileOpsImpl::MapFile
+(
+	string const& _fileName,
+	uint32* _size
+)
+{
+	int fd = open( _fileName.c_str(), O_RDONLY );
+	if( fd < 0 )
+	{
+		return NULL;
+	}
+
+	void* data = NULL;
+	struct stat st;
+	if( fstat( fd, &st ) == 0 && st.st_size > 0 && st.st_size <= 0x7fffffff )
+	{
+		data = mmap( NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0 );
+		if( data == MAP_FAILED )
+		{
+			data = NULL;
+		}
+		else
+		{
+			*_size = (uint32)st.st_size;
+		}
+	}
+
+	// The mapping stays valid after the descriptor is closed
+	close( fd );
+	return data;
+}
+
+//-----------------------------------------------------------------------------
+//	<FileOpsImpl::UnmapFile>
+//	Release a mapping made by MapFile
+//-----------------------------------------------------------------------------
+void FileOpsImpl::UnmapFile
+(
+	void const* _data,
+	uint32 const _size
+)
+{
+	munmap( const_cast<void*>( _data ), _size );
+}
+
+//-----------------------------------------------------------------------------
+//	<FileOpsImpl::ReplaceFile>
+//	Atomically replace one file with another
+//-----------------------------------------------------------------------------
+bool FileOpsImpl::ReplaceFile
+(
+	string const& _source,
+	string const& _target
+)
+{
+	return( rename( _source.c_str(), _target.c_str() ) == 0 );
+}
@@ -44,6 +44,10 @@ namespace OpenZWave
 		~FileOpsImpl();
 
 		bool FolderExists( string _filename );
+		bool FileInfo( string const& _fileName, uint64* _modified, uint64* _size );
+		void const* MapFile( string const& _fileName, uint32* _size );
+		void UnmapFile( void const* _data, uint32 const _size );
+		bool ReplaceFile( string const& _source, string const& _target );
 	};
 
 } // namespace OpenZWave
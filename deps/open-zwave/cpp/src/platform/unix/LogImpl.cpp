@@ -45,14 +45,17 @@ LogImpl::LogImpl
 	bool const _bConsoleOutput,
 	LogLevel const _saveLevel,
 	LogLevel const _queueLevel,
-	LogLevel const _dumpTrigger
+	LogLevel const _dumpTrigger,
+	uint32 const _asyncBufferSize
 ):
 	m_filename( _filename ),					// name of log file
 	m_bConsoleOutput( _bConsoleOutput ),		// true to provide a copy of output to console
 	m_bAppendLog( _bAppendLog ),				// true to append (and not overwrite) any existing log
+	m_logQueue( 128 * 1024 ),					// room for roughly a thousand typical queued messages
 	m_saveLevel( _saveLevel ),					// level of messages to log to file
 	m_queueLevel( _queueLevel ),				// level of messages to log to queue
-	m_dumpTrigger( _dumpTrigger )				// dump queued messages when this level is seen
+	m_dumpTrigger( _dumpTrigger ),				// dump queued messages when this level is seen
+	m_writer( NULL )
 {
 	if ( !m_bAppendLog )
 	{
@@ -65,6 +68,11 @@ LogImpl::LogImpl
 		std::cerr << "Could Not Open OZW Log File." << std::endl;
 	}
 	setlinebuf(stdout);	// To prevent buffering and lock contention issues
+
+	if( _asyncBufferSize )
+	{
+		m_writer = new LogWriter( this->pFile, m_bConsoleOutput, _asyncBufferSize );
+	}
 }
 
 //-----------------------------------------------------------------------------
@@ -75,7 +83,11 @@ LogImpl::~LogImpl
 (
 )
 {
-	fclose( this->pFile );
+	delete m_writer;	// flushes anything still buffered
+	if( this->pFile != NULL )
+	{
+		fclose( this->pFile );
+	}
 }
 
 //-----------------------------------------------------------------------------
@@ -90,14 +102,13 @@ void LogImpl::Write
 	va_list _args
 )
 {
-	// create a timestamp string
-	string timeStr = GetTimeStampString();
-	string nodeStr = GetNodeString( _nodeId );
-	string loglevelStr = GetLogLevelString(_logLevel);
-
 	// handle this message
 	if( (_logLevel <= m_queueLevel) || (_logLevel == LogLevel_Internal) )	// we're going to do something with this message...
 	{
+		// take the time now, but only format it if the message is written out
+		struct timeval tv;
+		gettimeofday( &tv, NULL );
+
 		char lineBuf[1024] = {0};
 		//int lineLen = 0;
 		if( _format != NULL && _format[0] != '\0' )
@@ -118,32 +129,40 @@ void LogImpl::Write
 			{
 				if( _logLevel != LogLevel_Internal )						// don't add a second timestamp to display of queued messages
 				{
-					outBuf.append(timeStr);
-					outBuf.append(loglevelStr);
-					outBuf.append(nodeStr);
-					outBuf.append(lineBuf);
-					outBuf.append("\n");
-
+					outBuf.append(GetTimeStampString( tv ));
+					outBuf.append(GetLogLevelString(_logLevel));
+					outBuf.append(GetNodeString( _nodeId ));
 				}
+				outBuf.append(lineBuf);
+				outBuf.append("\n");
 
 				// print message to file (and possibly screen)
-				if( this->pFile != NULL )
+				if( m_writer )
 				{
-					fputs( outBuf.c_str(), pFile );
+					m_writer->Write( outBuf.c_str(), (uint32)outBuf.size() );
 				}
-				if( m_bConsoleOutput )
+				else
 				{
-					fputs( outBuf.c_str(), stdout );
+					if( this->pFile != NULL )
+					{
+						fputs( outBuf.c_str(), pFile );
+					}
+					if( m_bConsoleOutput )
+					{
+						fputs( outBuf.c_str(), stdout );
+					}
 				}
 			}
 		}
 
 		if( _logLevel != LogLevel_Internal )
 		{
-			char queueBuf[1024];
-			string threadStr = GetThreadId();
-			snprintf( queueBuf, sizeof(queueBuf), "%s%s%s", timeStr.c_str(), threadStr.c_str(), lineBuf );
-			Queue( queueBuf );
+			LogRing::Record record;
+			record.m_time = ( (uint64)tv.tv_sec * 1000000 ) + tv.tv_usec;
+			record.m_threadId = (uint64)pthread_self();
+			record.m_level = (uint8)_logLevel;
+			record.m_nodeId = _nodeId;
+			m_logQueue.Push( record, lineBuf, (uint32)strlen( lineBuf ) );
 		}
 	}
 
@@ -152,25 +171,6 @@ void LogImpl::Write
 		QueueDump();
 }
 
-//-----------------------------------------------------------------------------
-//	<LogImpl::Queue>
-//	Write to the log queue
-//-----------------------------------------------------------------------------
-void LogImpl::Queue
-(
-	char const* _buffer
-)
-{
-	string bufStr = _buffer;
-	m_logQueue.push_back( bufStr );
-
-	// rudimentary queue size management
-	if( m_logQueue.size() > 500 )
-	{
-		m_logQueue.pop_front();
-	}
-}
-
 //-----------------------------------------------------------------------------
 //	<LogImpl::QueueDump>
 //	Dump the LogQueue to output device
@@ -179,20 +179,32 @@ void LogImpl::QueueDump
 (
 )
 {
+	// The banner lines below are queued too, so only dump what is there now
+	uint32 count = m_logQueue.GetCount();
+
 	Log::Write( LogLevel_Always, "" );
 	Log::Write( LogLevel_Always, "Dumping queued log messages");
 	Log::Write( LogLevel_Always, "" );
-	list<string>::iterator it = m_logQueue.begin();
-	while( it != m_logQueue.end() )
+
+	LogRing::Record record;
+	char text[1024];
+	while( count-- && m_logQueue.Pop( &record, text, sizeof(text) ) )
 	{
-		string strTemp = *it;
-		Log::Write( LogLevel_Internal, strTemp.c_str() );
-		it++;
+		struct timeval tv;
+		tv.tv_sec = (time_t)( record.m_time / 1000000 );
+		tv.tv_usec = (suseconds_t)( record.m_time % 1000000 );
+
+		string line = GetTimeStampString( tv );
+		line.append( GetThreadId( record.m_threadId ) );
+		line.append( GetLogLevelString( (LogLevel)record.m_level ) );
+		line.append( GetNodeString( record.m_nodeId ) );
+		line.append( text );
+		Log::Write( LogLevel_Internal, "%s", line.c_str() );
 	}
-	m_logQueue.clear();
 	Log::Write( LogLevel_Always, "" );
 	Log::Write( LogLevel_Always, "End of queued log message dump");
 	Log::Write( LogLevel_Always, "" );
+	m_logQueue.Clear();
 }
 
 //-----------------------------------------------------------------------------
@@ -203,7 +215,7 @@ void LogImpl::QueueClear
 (
 )
 {
-	m_logQueue.clear();
+	m_logQueue.Clear();
 }
 
 //-----------------------------------------------------------------------------
@@ -224,15 +236,14 @@ void LogImpl::SetLoggingState
 
 //-----------------------------------------------------------------------------
 //	<LogImpl::GetTimeStampString>
-//	Generate a string with formatted current time
+//	Generate a string with formatted time
 //-----------------------------------------------------------------------------
 string LogImpl::GetTimeStampString
 (
+	struct timeval const& _time
 )
 {
-	// Get a timestamp
-	struct timeval tv;
-	gettimeofday(&tv, NULL);
+	struct timeval tv = _time;
 	struct tm *tm;
 	tm = localtime( &tv.tv_sec );
 
@@ -277,10 +288,11 @@ string LogImpl::GetNodeString
 //-----------------------------------------------------------------------------
 string LogImpl::GetThreadId
 (
+	uint64 const _threadId
 )
 {
 	char buf[20];
-	snprintf( buf, sizeof(buf), "%08lx ", (long unsigned int)pthread_self() );
+	snprintf( buf, sizeof(buf), "%08lx ", (long unsigned int)_threadId );
 	string str = buf;
 	return str;
 }
@@ -297,6 +309,17 @@ void LogImpl::SetLogFileName
 	m_filename = _filename;
 }
 
+//-----------------------------------------------------------------------------
+//	<LogImpl::GetDroppedLineCount>
+//	Number of lines dropped by the background writer
+//-----------------------------------------------------------------------------
+uint32 LogImpl::GetDroppedLineCount
+(
+)
+{
+	return m_writer ? m_writer->GetDroppedCount() : 0;
+}
+
 
 //-----------------------------------------------------------------------------
 //	<LogImpl::GetLogLevelString>
@@ -26,7 +26,7 @@
 //
 //-----------------------------------------------------------------------------
 #include <unistd.h>
-#include <pthread.h>
+#include <poll.h>
 #include "Defs.h"
 #include "platform/Thread.h"
 #include "platform/Event.h"
@@ -35,6 +35,7 @@
 
 #ifdef __linux__
 #include <libudev.h>
+#include <sys/eventfd.h>
 #endif
 
 using namespace OpenZWave;
@@ -48,7 +49,10 @@ SerialControllerImpl::SerialControllerImpl
 	SerialController* _owner
 ):
 	m_owner( _owner ),
-	m_hSerialController( -1 )
+	m_hSerialController( -1 ),
+	m_hWakeRead( -1 ),
+	m_hWakeWrite( -1 ),
+	m_pThread( NULL )
 {
 }
 
@@ -63,6 +67,10 @@ SerialControllerImpl::~SerialControllerImpl
 	flock(m_hSerialController, LOCK_UN);
 	if(m_hSerialController >= 0)
 		close( m_hSerialController );
+	if( m_hWakeWrite != m_hWakeRead )
+		close( m_hWakeWrite );
+	if( m_hWakeRead >= 0 )
+		close( m_hWakeRead );
 }
 
 //-----------------------------------------------------------------------------
@@ -81,6 +89,24 @@ bool SerialControllerImpl::Open
 		return false;
 	}
 
+	// The read thread waits on the port and on this, so it can be told to stop
+	// without cancelling it part way through a read.
+	if( m_hWakeRead < 0 )
+	{
+#ifdef __linux__
+		m_hWakeRead = m_hWakeWrite = eventfd( 0, EFD_NONBLOCK );
+#else
+		int fds[2];
+		if( pipe( fds ) == 0 )
+		{
+			fcntl( fds[0], F_SETFL, O_NONBLOCK );
+			fcntl( fds[1], F_SETFL, O_NONBLOCK );
+			m_hWakeRead = fds[0];
+			m_hWakeWrite = fds[1];
+		}
+#endif
+	}
+
 	// Start the read thread
 	m_pThread = new Thread( "SerialController" );
 	m_pThread->Start( SerialReadThreadEntryPoint, this );
@@ -98,12 +124,32 @@ void SerialControllerImpl::Close
 {
 	if( m_pThread )
 	{
+		Wake();
 		m_pThread->Stop();
 		m_pThread->Release();
 		m_pThread = NULL;
 	}
 	close( m_hSerialController );
 	m_hSerialController = -1;
+
+	// Discard the wake-up, so the port can be opened again
+	uint64 count;
+	while( m_hWakeRead >= 0 && read( m_hWakeRead, &count, sizeof(count) ) > 0 );
+}
+
+//-----------------------------------------------------------------------------
+// <SerialControllerImpl::Wake>
+// Make the read thread return from Read
+//-----------------------------------------------------------------------------
+void SerialControllerImpl::Wake
+(
+)
+{
+	uint64 one = 1;
+	if( m_hWakeWrite >= 0 && write( m_hWakeWrite, &one, sizeof(one) ) < 0 )
+	{
+		Log::Write( LogLevel_Warning, "WARNING: Failed to wake the serial read thread. Error code %d", errno );
+	}
 }
 
 //-----------------------------------------------------------------------------
@@ -239,7 +285,7 @@ bool SerialControllerImpl::Init
 	for( int i = 0; i < NCCS; i++ )
 		tios.c_cc[i] = 0;
 	tios.c_cc[VMIN] = 0;
-	tios.c_cc[VTIME] = 1;
+	tios.c_cc[VTIME] = 0;			// poll() does the waiting, so reads just take what has arrived
 	switch( m_owner->m_baud )
 	{
 		case 300:
@@ -306,43 +352,76 @@ SerialOpenFailure:
 
 //-----------------------------------------------------------------------------
 // <SerialControllerImpl::Read>
-// Read data from the serial port
+// Read data from the serial port until woken, or the port fails
 //-----------------------------------------------------------------------------
 void SerialControllerImpl::Read
 (
 )
 {
+	// Room for a maximum-size frame, which is handed on in one Put
 	uint8 buffer[256];
 
+	struct pollfd fds[2];
+	fds[0].fd = m_hSerialController;
+	fds[0].events = POLLIN;
+	fds[1].fd = m_hWakeRead;
+	fds[1].events = POLLIN;
+
 	while( 1 )
-        {
-		int32 bytesRead;
-		int err;
+	{
+		int err = poll( fds, ( m_hWakeRead >= 0 ) ? 2 : 1, -1 );
+		if( err < 0 )
+		{
+			if( errno == EINTR )
+			{
+				continue;
+			}
+			Log::Write( LogLevel_Error, "ERROR: Waiting on the serial port failed. Error code %d", errno );
+			break;
+		}
+
+		if( fds[1].revents & POLLIN )
+		{
+			// Close has been called
+			return;
+		}
 
-		do
+		uint32 size = 0;
+		if( fds[0].revents & POLLIN )
 		{
-			bytesRead = read( m_hSerialController, buffer, sizeof(buffer) );
-			if( bytesRead > 0 )
-				m_owner->Put( buffer, bytesRead );
-		} while( bytesRead > 0 );
+			// Take everything that has arrived, then pass it on with a single notification
+			int32 bytesRead;
+			do
+			{
+				bytesRead = read( m_hSerialController, &buffer[size], sizeof(buffer) - size );
+				if( bytesRead > 0 )
+				{
+					size += bytesRead;
+				}
+			}
+			while( bytesRead > 0 && size < sizeof(buffer) );
 
-		do
+			if( size > 0 )
+			{
+				m_owner->Put( buffer, size );
+			}
+			else if( bytesRead < 0 && errno != EAGAIN && errno != EINTR )
+			{
+				Log::Write( LogLevel_Error, "ERROR: Reading from the serial port failed. Error code %d", errno );
+				break;
+			}
+		}
+		if( ( size == 0 ) && ( fds[0].revents & ( POLLERR | POLLHUP | POLLNVAL ) ) )
 		{
-			struct timeval *whenp;
-			fd_set rds, eds;
-			int oldstate;
-
-			FD_ZERO( &rds );
-			FD_SET( m_hSerialController, &rds );
-			FD_ZERO( &eds );
-			FD_SET( m_hSerialController, &eds );
-			whenp = NULL;
-
-			pthread_setcancelstate(PTHREAD_CANCEL_ENABLE, &oldstate);
-			err = select( m_hSerialController + 1, &rds, NULL, &eds, whenp );
-			pthread_setcancelstate(PTHREAD_CANCEL_DISABLE, &oldstate);
-		} while( err <= 0 );
+			Log::Write( LogLevel_Error, "ERROR: The serial port has been disconnected" );
+			break;
+		}
 	}
+
+	// Give up on this descriptor; the read thread will try to open the port again
+	flock( m_hSerialController, LOCK_UN );
+	close( m_hSerialController );
+	m_hSerialController = -1;
 }
 
 //-----------------------------------------------------------------------------
@@ -60,9 +60,12 @@ namespace OpenZWave
 
 		bool Init( uint32 const _attempts );
 		void Read();
+		void Wake();
 
 		SerialController*	m_owner;
 		int			m_hSerialController;
+		int			m_hWakeRead;		// becomes readable when the read thread must stop waiting on the port
+		int			m_hWakeWrite;		// the same descriptor as m_hWakeRead where eventfd is available
 		Thread*			m_pThread;
 
 		static void SerialReadThreadEntryPoint( Event* _exitEvent, void* _content );
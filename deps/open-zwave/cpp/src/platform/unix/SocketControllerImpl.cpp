@@ -0,0 +1,452 @@
+//-----------------------------------------------------------------------------
+//
+//	SocketControllerImpl.cpp
+//
+//	POSIX implementation of a socket connection to a Z-Wave controller
+//
+//	SOFTWARE NOTICE AND LICENSE
+//
+//	This file is part of OpenZWave.
+//
+//	OpenZWave is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU Lesser General Public License as published
+//	by the Free Software Foundation, either version 3 of the License,
+//	or (at your option) any later version.
+//
+//	OpenZWave is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//	GNU Lesser General Public License for more details.
+//
+//	You should have received a copy of the GNU Lesser General Public License
+//	along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+#include <unistd.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <string.h>
+#include <netdb.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include "Defs.h"
+#include "platform/Thread.h"
+#include "platform/Event.h"
+#include "platform/Mutex.h"
+#include "SocketControllerImpl.h"
+#include "platform/Log.h"
+
+#ifdef __linux__
+#include <sys/eventfd.h>
+#endif
+
+using namespace OpenZWave;
+
+//-----------------------------------------------------------------------------
+// <SocketControllerImpl::SocketControllerImpl>
+// Constructor
+//-----------------------------------------------------------------------------
+SocketControllerImpl::SocketControllerImpl
+(
+	SocketController* _owner
+):
+	m_owner( _owner ),
+	m_hSocket( -1 ),
+	m_socketMutex( new Mutex() ),
+	m_hWakeRead( -1 ),
+	m_hWakeWrite( -1 ),
+	m_pThread( NULL )
+{
+}
+
+//-----------------------------------------------------------------------------
+// <SocketControllerImpl::~SocketControllerImpl>
+// Destructor
+//-----------------------------------------------------------------------------
+SocketControllerImpl::~SocketControllerImpl
+(
+)
+{
+	if( m_hSocket >= 0 )
+		close( m_hSocket );
+	if( m_hWakeWrite != m_hWakeRead )
+		close( m_hWakeWrite );
+	if( m_hWakeRead >= 0 )
+		close( m_hWakeRead );
+	m_socketMutex->Release();
+}
+
+//-----------------------------------------------------------------------------
+// <SocketControllerImpl::Open>
+// Connect to the socket
+//-----------------------------------------------------------------------------
+bool SocketControllerImpl::Open
+( 
+)
+{
+	// Try to connect
+	if( !Init( 1 ) )
+	{
+		// Failed.  We bail to allow the app a chance to take over, rather than retry
+		// automatically.  Automatic retries only occur after a successful init.
+		return false;
+	}
+
+	// The read thread waits on the socket and on this, so it can be told to stop
+	if( m_hWakeRead < 0 )
+	{
+#ifdef __linux__
+		m_hWakeRead = m_hWakeWrite = eventfd( 0, EFD_NONBLOCK );
+#else
+		int fds[2];
+		if( pipe( fds ) == 0 )
+		{
+			fcntl( fds[0], F_SETFL, O_NONBLOCK );
+			fcntl( fds[1], F_SETFL, O_NONBLOCK );
+			m_hWakeRead = fds[0];
+			m_hWakeWrite = fds[1];
+		}
+#endif
+	}
+
+	// Start the read thread
+	m_pThread = new Thread( "SocketController" );
+	m_pThread->Start( SocketReadThreadEntryPoint, this );
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+// <SocketControllerImpl::Close>
+// Close the socket
+//-----------------------------------------------------------------------------
+void SocketControllerImpl::Close
+( 
+)
+{
+	if( m_pThread )
+	{
+		Wake();
+		m_pThread->Stop();
+		m_pThread->Release();
+		m_pThread = NULL;
+	}
+	m_socketMutex->Lock();
+	if( m_hSocket >= 0 )
+	{
+		close( m_hSocket );
+		m_hSocket = -1;
+	}
+	m_socketMutex->Unlock();
+
+	// Discard the wake-up, so the socket can be opened again
+	uint64 count;
+	while( m_hWakeRead >= 0 && read( m_hWakeRead, &count, sizeof(count) ) > 0 );
+}
+
+//-----------------------------------------------------------------------------
+// <SocketControllerImpl::Wake>
+// Make the read thread return from Read
+//-----------------------------------------------------------------------------
+void SocketControllerImpl::Wake
+(
+)
+{
+	uint64 one = 1;
+	if( m_hWakeWrite >= 0 && write( m_hWakeWrite, &one, sizeof(one) ) < 0 )
+	{
+		Log::Write( LogLevel_Warning, "WARNING: Failed to wake the socket read thread. Error code %d", errno );
+	}
+}
+
+//-----------------------------------------------------------------------------
+// <SocketReadThreadEntryPoint>
+// Entry point of the thread for receiving data from the socket
+//-----------------------------------------------------------------------------
+void SocketControllerImpl::SocketReadThreadEntryPoint
+(
+	Event* _exitEvent,
+	void* _context
+)
+{
+	SocketControllerImpl* impl = (SocketControllerImpl*)_context;
+	if( impl )
+	{
+		impl->ReadThreadProc( _exitEvent );
+	}
+}
+
+//-----------------------------------------------------------------------------
+// <SocketControllerImpl::ReadThreadProc>
+// Handle receiving data
+//-----------------------------------------------------------------------------
+void SocketControllerImpl::ReadThreadProc
+(
+	Event* _exitEvent
+)
+{  
+	uint32 attempts = 0;
+	while( true )
+	{
+		// Init must have been called successfully during Open, so we
+		// don't do it again until the end of the loop
+		if( -1 != m_hSocket )
+		{
+			// Enter read loop.  Call will only return if
+			// an exit is requested or an error occurs
+			Read();
+
+			// Reset the attempts, so we get a rapid retry for temporary errors
+			attempts = 0;
+		}
+
+		if( attempts < 25 )		
+		{
+			// Retry every 5 seconds for the first two minutes...
+			if( Wait::Single( _exitEvent, 5000 ) >= 0 )
+			{
+				// Exit signalled.
+				break;
+			}
+		}
+		else
+		{
+			// ...retry every 30 seconds after that
+			if( Wait::Single( _exitEvent, 30000 ) >= 0 )
+			{
+				// Exit signalled.
+				break;
+			}
+		}
+
+		Init( ++attempts );
+	}
+}
+
+//-----------------------------------------------------------------------------
+// <SocketControllerImpl::Init>
+// Connect to the socket named by the controller path
+//-----------------------------------------------------------------------------
+bool SocketControllerImpl::Init
+(
+	uint32 const _attempts
+)
+{
+	string path = m_owner->m_socketPath;
+
+	Log::Write( LogLevel_Info, "Trying to connect to %s (attempt %d)", path.c_str(), _attempts );
+	int sock = Connect( path );
+	if( sock < 0 )
+	{
+		Log::Write( LogLevel_Error, "ERROR: Failed to connect to %s", path.c_str() );
+		return false;
+	}
+
+	// Only publish the descriptor once it is connected, so Write never sees a half-made socket
+	m_socketMutex->Lock();
+	m_hSocket = sock;
+	m_socketMutex->Unlock();
+
+	Log::Write( LogLevel_Info, "Connected to %s (attempt %d)", path.c_str(), _attempts );
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+// <SocketControllerImpl::Connect>
+// Parse a tcp://host:port or unix:///path name and return a socket connected
+// to it, or -1 on failure
+//-----------------------------------------------------------------------------
+int SocketControllerImpl::Connect
+(
+	string const& _path
+)
+{
+	if( _path.compare( 0, 7, "unix://" ) == 0 )
+	{
+		string file = _path.substr( 7 );
+
+		struct sockaddr_un addr;
+		memset( &addr, 0, sizeof(addr) );
+		addr.sun_family = AF_UNIX;
+		if( file.empty() || file.size() >= sizeof(addr.sun_path) )
+		{
+			Log::Write( LogLevel_Error, "ERROR: Socket path %s is not valid", file.c_str() );
+			return -1;
+		}
+		strncpy( addr.sun_path, file.c_str(), sizeof(addr.sun_path) - 1 );
+
+		int sock = socket( AF_UNIX, SOCK_STREAM, 0 );
+		if( sock < 0 )
+		{
+			Log::Write( LogLevel_Error, "ERROR: Cannot create socket. Error code %d", errno );
+			return -1;
+		}
+		if( connect( sock, (struct sockaddr*)&addr, sizeof(addr) ) < 0 )
+		{
+			Log::Write( LogLevel_Error, "ERROR: Cannot connect to %s. Error code %d", file.c_str(), errno );
+			close( sock );
+			return -1;
+		}
+		return sock;
+	}
+
+	// tcp://host:port, where an IPv6 host is written in brackets
+	string hostPort = _path.substr( 6 );
+	size_t colon = hostPort.rfind( ':' );
+	if( colon == string::npos || colon == 0 || colon + 1 == hostPort.size() )
+	{
+		Log::Write( LogLevel_Error, "ERROR: %s is not of the form tcp://host:port", _path.c_str() );
+		return -1;
+	}
+	string host = hostPort.substr( 0, colon );
+	string port = hostPort.substr( colon + 1 );
+	if( host.size() > 2 && host[0] == '[' && host[host.size()-1] == ']' )
+	{
+		host = host.substr( 1, host.size() - 2 );
+	}
+
+	struct addrinfo hints;
+	memset( &hints, 0, sizeof(hints) );
+	hints.ai_family = AF_UNSPEC;
+	hints.ai_socktype = SOCK_STREAM;
+
+	struct addrinfo* addrs = NULL;
+	int err = getaddrinfo( host.c_str(), port.c_str(), &hints, &addrs );
+	if( err != 0 )
+	{
+		Log::Write( LogLevel_Error, "ERROR: Cannot resolve %s: %s", host.c_str(), gai_strerror( err ) );
+		return -1;
+	}
+
+	int sock = -1;
+	for( struct addrinfo* ai = addrs; ai != NULL; ai = ai->ai_next )
+	{
+		sock = socket( ai->ai_family, ai->ai_socktype, ai->ai_protocol );
+		if( sock < 0 )
+		{
+			continue;
+		}
+		if( connect( sock, ai->ai_addr, ai->ai_addrlen ) == 0 )
+		{
+			break;
+		}
+		close( sock );
+		sock = -1;
+	}
+	freeaddrinfo( addrs );
+
+	if( sock < 0 )
+	{
+		Log::Write( LogLevel_Error, "ERROR: Cannot connect to %s port %s. Error code %d", host.c_str(), port.c_str(), errno );
+		return -1;
+	}
+
+	// Frames are small and each one waits for an ACK, so don't let Nagle hold them back
+	int one = 1;
+	setsockopt( sock, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one) );
+#ifdef SO_NOSIGPIPE
+	setsockopt( sock, SOL_SOCKET, SO_NOSIGPIPE, &one, sizeof(one) );
+#endif
+	return sock;
+}
+
+//-----------------------------------------------------------------------------
+// <SocketControllerImpl::Read>
+// Read data from the socket until woken, or the connection is lost
+//-----------------------------------------------------------------------------
+void SocketControllerImpl::Read
+(
+)
+{
+	// Room for a maximum-size frame, which is handed on in one Put
+	uint8 buffer[256];
+
+	struct pollfd fds[2];
+	fds[0].fd = m_hSocket;
+	fds[0].events = POLLIN;
+	fds[1].fd = m_hWakeRead;
+	fds[1].events = POLLIN;
+
+	while( 1 )
+	{
+		int err = poll( fds, ( m_hWakeRead >= 0 ) ? 2 : 1, -1 );
+		if( err < 0 )
+		{
+			if( errno == EINTR )
+			{
+				continue;
+			}
+			Log::Write( LogLevel_Error, "ERROR: Waiting on the socket failed. Error code %d", errno );
+			break;
+		}
+
+		if( fds[1].revents & POLLIN )
+		{
+			// Close has been called
+			return;
+		}
+
+		if( fds[0].revents & ( POLLIN | POLLERR | POLLHUP ) )
+		{
+			int32 bytesRead = recv( m_hSocket, buffer, sizeof(buffer), 0 );
+			if( bytesRead > 0 )
+			{
+				m_owner->Put( buffer, bytesRead );
+			}
+			else if( bytesRead == 0 )
+			{
+				Log::Write( LogLevel_Error, "ERROR: The controller closed the connection" );
+				break;
+			}
+			else if( errno != EAGAIN && errno != EINTR )
+			{
+				Log::Write( LogLevel_Error, "ERROR: Reading from the socket failed. Error code %d", errno );
+				break;
+			}
+		}
+	}
+
+	// Give up on this connection; the read thread will try to connect again.
+	// Close under the lock, so a Write in progress cannot end up on a reused descriptor.
+	m_socketMutex->Lock();
+	close( m_hSocket );
+	m_hSocket = -1;
+	m_socketMutex->Unlock();
+}
+
+//-----------------------------------------------------------------------------
+// <SocketControllerImpl::Write>
+// Send data to the socket
+//-----------------------------------------------------------------------------
+uint32 SocketControllerImpl::Write
+(
+	uint8* _buffer,
+	uint32 _length
+)
+{
+	m_socketMutex->Lock();
+	if( -1 == m_hSocket )
+	{
+		//Error
+		m_socketMutex->Unlock();
+		Log::Write( LogLevel_Error, "ERROR: Socket must be connected before writing" );
+		return 0;
+	}
+
+#ifdef MSG_NOSIGNAL
+	int flags = MSG_NOSIGNAL;			// a lost connection is reported by the read thread, not SIGPIPE
+#else
+	int flags = 0;
+#endif
+	int32 bytesWritten = send( m_hSocket, _buffer, _length, flags );
+	m_socketMutex->Unlock();
+	if( bytesWritten < 0 )
+	{
+		Log::Write( LogLevel_Error, "ERROR: Writing to the socket failed. Error code %d", errno );
+		return 0;
+	}
+	return (uint32)bytesWritten;
+}
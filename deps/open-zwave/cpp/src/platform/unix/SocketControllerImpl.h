@@ -0,0 +1,71 @@
+//-----------------------------------------------------------------------------
+//
+//	SocketControllerImpl.h
+//
+//	POSIX implementation of a socket connection to a Z-Wave controller
+//
+//	SOFTWARE NOTICE AND LICENSE
+//
+//	This file is part of OpenZWave.
+//
+//	OpenZWave is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU Lesser General Public License as published
+//	by the Free Software Foundation, either version 3 of the License,
+//	or (at your option) any later version.
+//
+//	OpenZWave is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//	GNU Lesser General Public License for more details.
+//
+//	You should have received a copy of the GNU Lesser General Public License
+//	along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+
+#ifndef _SocketControllerImpl_H
+#define _SocketControllerImpl_H
+
+#include "Defs.h"
+#include "platform/SocketController.h"
+
+namespace OpenZWave
+{
+	class Event;
+	class Mutex;
+	class Thread;
+
+	class SocketControllerImpl
+	{
+	public:
+		void ReadThreadProc( Event* _exitEvent );
+
+	private:
+		friend class SocketController;
+
+		SocketControllerImpl( SocketController* _owner );
+		~SocketControllerImpl();
+
+		bool Open();
+		void Close();
+
+		uint32 Write( uint8* _buffer, uint32 _length );
+
+		bool Init( uint32 const _attempts );
+		int Connect( string const& _path );
+		void Read();
+		void Wake();
+
+		SocketController*	m_owner;
+		int			m_hSocket;
+		Mutex*			m_socketMutex;		// held while m_hSocket is changed, or used outside the read thread
+		int			m_hWakeRead;		// becomes readable when the read thread must stop waiting on the socket
+		int			m_hWakeWrite;		// the same descriptor as m_hWakeRead where eventfd is available
+		Thread*			m_pThread;
+
+		static void SocketReadThreadEntryPoint( Event* _exitEvent, void* _content );
+	};
+
+} // namespace OpenZWave
+
+#endif //_SocketControllerImpl_H
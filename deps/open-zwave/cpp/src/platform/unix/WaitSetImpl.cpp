@@ -0,0 +1,201 @@
+//-----------------------------------------------------------------------------
+//
+//	WaitSetImpl.cpp
+//
+//	POSIX implementation of the wakeup primitive behind a WaitSet
+//	(eventfd and epoll on Linux, a condition variable elsewhere)
+//
+//	SOFTWARE NOTICE AND LICENSE
+//
+//	This file is part of OpenZWave.
+//
+//	OpenZWave is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU Lesser General Public License as published
+//	by the Free Software Foundation, either version 3 of the License,
+//	or (at your option) any later version.
+//
+//	OpenZWave is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//	GNU Lesser General Public License for more details.
+//
+//	You should have received a copy of the GNU Lesser General Public License
+//	along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+#include "Defs.h"
+#include "WaitSetImpl.h"
+
+#include <stdio.h>
+#include <errno.h>
+#include <unistd.h>
+#include <sys/time.h>
+#ifdef __linux__
+#include <sys/eventfd.h>
+#include <sys/epoll.h>
+#endif
+
+using namespace OpenZWave;
+
+//-----------------------------------------------------------------------------
+//	<WaitSetImpl::WaitSetImpl>
+//	Constructor
+//-----------------------------------------------------------------------------
+WaitSetImpl::WaitSetImpl
+(
+)
+{
+#ifdef __linux__
+	m_eventFd = eventfd( 0, EFD_NONBLOCK | EFD_CLOEXEC );
+	m_epollFd = epoll_create1( EPOLL_CLOEXEC );
+	if( m_eventFd < 0 || m_epollFd < 0 )
+	{
+		fprintf(stderr, "WaitSetImpl::WaitSetImpl eventfd/epoll error %d\n", errno );
+		assert( 0 );
+	}
+
+	struct epoll_event ev;
+	ev.events = EPOLLIN;
+	ev.data.fd = m_eventFd;
+	if( epoll_ctl( m_epollFd, EPOLL_CTL_ADD, m_eventFd, &ev ) != 0 )
+	{
+		fprintf(stderr, "WaitSetImpl::WaitSetImpl epoll_ctl error %d\n", errno );
+		assert( 0 );
+	}
+#else
+	m_isSignaled = false;
+	pthread_mutex_init( &m_lock, NULL );
+	pthread_cond_init( &m_condition, NULL );
+#endif
+}
+
+//-----------------------------------------------------------------------------
+//	<WaitSetImpl::~WaitSetImpl>
+//	Destructor
+//-----------------------------------------------------------------------------
+WaitSetImpl::~WaitSetImpl
+(
+)
+{
+#ifdef __linux__
+	close( m_epollFd );
+	close( m_eventFd );
+#else
+	pthread_cond_destroy( &m_condition );
+	pthread_mutex_destroy( &m_lock );
+#endif
+}
+
+//-----------------------------------------------------------------------------
+//	<WaitSetImpl::Signal>
+//	Wake up the thread waiting on the set
+//-----------------------------------------------------------------------------
+void WaitSetImpl::Signal
+(
+)
+{
+#ifdef __linux__
+	uint64_t one = 1;
+	// EAGAIN just means the counter is already non-zero, which is all we need.
+	if( write( m_eventFd, &one, sizeof(one) ) < 0 && errno != EAGAIN )
+	{
+		fprintf(stderr, "WaitSetImpl::Signal write error %d\n", errno );
+	}
+#else
+	pthread_mutex_lock( &m_lock );
+	m_isSignaled = true;
+	pthread_cond_signal( &m_condition );
+	pthread_mutex_unlock( &m_lock );
+#endif
+}
+
+//-----------------------------------------------------------------------------
+//	<WaitSetImpl::Wait>
+//	Wait for Signal to be called
+//-----------------------------------------------------------------------------
+bool WaitSetImpl::Wait
+(
+	int32 const _timeout /* milliseconds */
+)
+{
+#ifdef __linux__
+	struct epoll_event ev;
+	int oldstate;
+	pthread_setcancelstate( PTHREAD_CANCEL_ENABLE, &oldstate );
+	int res = epoll_wait( m_epollFd, &ev, 1, _timeout );
+	pthread_setcancelstate( PTHREAD_CANCEL_DISABLE, &oldstate );
+
+	if( res == 0 )
+	{
+		return false;
+	}
+	if( res < 0 )
+	{
+		if( errno != EINTR )
+		{
+			fprintf(stderr, "WaitSetImpl::Wait epoll_wait error %d\n", errno );
+		}
+		// Treat as a spurious wakeup; the caller rescans and recomputes its timeout.
+		return true;
+	}
+
+	// Drain the counter so the next wait blocks until the next Signal.
+	uint64_t count;
+	if( read( m_eventFd, &count, sizeof(count) ) < 0 && errno != EAGAIN )
+	{
+		fprintf(stderr, "WaitSetImpl::Wait read error %d\n", errno );
+	}
+	return true;
+#else
+	bool result = true;
+	pthread_mutex_lock( &m_lock );
+	if( !m_isSignaled )
+	{
+		if( _timeout == 0 )
+		{
+			result = false;
+		}
+		else if( _timeout > 0 )
+		{
+			struct timeval now;
+			struct timespec abstime;
+
+			gettimeofday( &now, NULL );
+			abstime.tv_sec = now.tv_sec + ( _timeout / 1000 );
+			now.tv_usec += ( _timeout % 1000 ) * 1000;
+			while( now.tv_usec >= ( 1000 * 1000 ) )
+			{
+				now.tv_usec -= ( 1000 * 1000 );
+				abstime.tv_sec++;
+			}
+			abstime.tv_nsec = now.tv_usec * 1000;
+
+			while( !m_isSignaled )
+			{
+				int oldstate;
+				pthread_setcancelstate( PTHREAD_CANCEL_ENABLE, &oldstate );
+				int err = pthread_cond_timedwait( &m_condition, &m_lock, &abstime );
+				pthread_setcancelstate( PTHREAD_CANCEL_DISABLE, &oldstate );
+				if( err == ETIMEDOUT )
+				{
+					result = false;
+					break;
+				}
+			}
+		}
+		else
+		{
+			while( !m_isSignaled )
+			{
+				int oldstate;
+				pthread_setcancelstate( PTHREAD_CANCEL_ENABLE, &oldstate );
+				pthread_cond_wait( &m_condition, &m_lock );
+				pthread_setcancelstate( PTHREAD_CANCEL_DISABLE, &oldstate );
+			}
+		}
+	}
+	m_isSignaled = false;
+	pthread_mutex_unlock( &m_lock );
+	return result;
+#endif
+}
@@ -67,3 +67,93 @@ bool FileOpsImpl::FolderExists(
 
 	return false;
 }
+
+//-----------------------------------------------------------------------------
+//	<FileOpsImpl::FileInfo>
+//	Get the modification time and size of a file
+//-----------------------------------------------------------------------------
+bool FileOpsImpl::FileInfo
+(
+	string const& _fileName,
+	uint64* _modified,
+	uint64* _size
+)
+{
+	WIN32_FILE_ATTRIBUTE_DATA attributes;
+	if( !GetFileAttributesExA( _fileName.c_str(), GetFileExInfoStandard, &attributes ) ||
+		( attributes.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY ) )
+	{
+		return false;
+	}
+
+	// FILETIME counts 100ns intervals since 1601
+	uint64 modified = ( ( (uint64)attributes.ftLastWriteTime.dwHighDateTime ) << 32 ) | attributes.ftLastWriteTime.dwLowDateTime;
+	*_modified = modified / 10000000;
+	*_size = ( ( (uint64)attributes.nFileSizeHigh ) << 32 ) | attributes.nFileSizeLow;
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+//	<FileOpsImpl::MapFile>
+//	Map a file read-only into memory
+//-----------------------------------------------------------------------------
+void const* FileOpsImpl::MapFile
+(
+	string const& _fileName,
+	uint32* _size
+)
+{
+	HANDLE hFile = CreateFileA( _fileName.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_DELETE, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL );
+	if( hFile == INVALID_HANDLE_VALUE )
+	{
+		return NULL;
+	}
+
+	void const* data = NULL;
+	DWORD sizeHigh = 0;
+	DWORD size = GetFileSize( hFile, &sizeHigh );
+	if( size != INVALID_FILE_SIZE && size > 0 && sizeHigh == 0 )
+	{
+		HANDLE hMapping = CreateFileMappingA( hFile, NULL, PAGE_READONLY, 0, 0, NULL );
+		if( hMapping != NULL )
+		{
+			data = MapViewOfFile( hMapping, FILE_MAP_READ, 0, 0, 0 );
+			if( data != NULL )
+			{
+				*_size = size;
+			}
+
+			// The view keeps the mapping alive
+			CloseHandle( hMapping );
+		}
+	}
+
+	CloseHandle( hFile );
+	return data;
+}
+
+//-----------------------------------------------------------------------------
+//	<FileOpsImpl::UnmapFile>
+//	Release a mapping made by MapFile
+//-----------------------------------------------------------------------------
+void FileOpsImpl::UnmapFile
+(
+	void const* _data,
+	uint32 const _size
+)
+{
+	UnmapViewOfFile( _data );
+}
+
+//-----------------------------------------------------------------------------
+//	<FileOpsImpl::ReplaceFile>
+//	Atomically replace one file with another
+//-----------------------------------------------------------------------------
+bool FileOpsImpl::ReplaceFile
+(
+	string const& _source,
+	string const& _target
+)
+{
+	return( MoveFileExA( _source.c_str(), _target.c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH ) != 0 );
+}
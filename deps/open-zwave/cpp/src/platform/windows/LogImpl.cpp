@@ -72,19 +72,25 @@ LogImpl::LogImpl
 	bool const _bConsoleOutput,
 	LogLevel const _saveLevel,
 	LogLevel const _queueLevel,
-	LogLevel const _dumpTrigger
+	LogLevel const _dumpTrigger,
+	uint32 const _asyncBufferSize
 ):
 	m_filename( _filename ),					// name of log file
 	m_bAppendLog( _bAppendLog ),				// true to append (and not overwrite) any existing log
 	m_bConsoleOutput( _bConsoleOutput ),		// true to provide a copy of output to console
+	m_logQueue( 128 * 1024 ),					// room for roughly a thousand typical queued messages
 	m_saveLevel( _saveLevel ),					// level of messages to log to file
 	m_queueLevel( _queueLevel ),				// level of messages to log to queue
-	m_dumpTrigger( _dumpTrigger )				// dump queued messages when this level is seen
+	m_dumpTrigger( _dumpTrigger ),				// dump queued messages when this level is seen
+	m_writer( NULL ),
+	m_file( NULL )
 {
 	string accessType;
 
 	// create an adjusted file name and timestamp string
-	string timeStr = GetTimeStampString();
+	SYSTEMTIME time;
+	::GetLocalTime( &time );
+	string timeStr = GetTimeStampString( time );
 
 	if ( m_bAppendLog )
 	{
@@ -101,6 +107,16 @@ LogImpl::LogImpl
 		fprintf( pFile, "\nLogging started %s\n\n", timeStr.c_str() );
 		fclose( pFile );
 	}
+
+	if( _asyncBufferSize )
+	{
+		// The background writer keeps the file open rather than reopening it for every line
+		if( fopen_s( &m_file, m_filename.c_str(), "a" ) )
+		{
+			m_file = NULL;
+		}
+		m_writer = new LogWriter( m_file, m_bConsoleOutput, _asyncBufferSize );
+	}
 }
 
 //-----------------------------------------------------------------------------
@@ -111,6 +127,11 @@ LogImpl::~LogImpl
 (
 )
 {
+	delete m_writer;	// flushes anything still buffered
+	if( m_file != NULL )
+	{
+		fclose( m_file );
+	}
 }
 
 //-----------------------------------------------------------------------------
@@ -125,14 +146,18 @@ void LogImpl::Write
 	va_list _args
 )
 {
-	// create a timestamp string
-	string timeStr = GetTimeStampString();
-	string nodeStr = GetNodeString( _nodeId );
-	string logLevelStr = GetLogLevelString(_logLevel);
-
 	// handle this message
 	if( (_logLevel <= m_queueLevel) || (_logLevel == LogLevel_Internal) )	// we're going to do something with this message...
 	{
+		// take the time now, but only format it if the message is written out
+		SYSTEMTIME time;
+		::GetLocalTime( &time );
+		string timeStr;
+		if( (_logLevel <= m_saveLevel) && (_logLevel != LogLevel_Internal) )
+		{
+			timeStr = GetTimeStampString( time );
+		}
+
 		char lineBuf[1024];
 		if( !_format || ( _format[0] == 0 ) )
 		{
@@ -144,7 +169,21 @@ void LogImpl::Write
 		}
 
 		// should this message be saved to file (and possibly written to console?)
-		if( (_logLevel <= m_saveLevel) || (_logLevel == LogLevel_Internal) )
+		if( m_writer && ( (_logLevel <= m_saveLevel) || (_logLevel == LogLevel_Internal) ) )
+		{
+			// hand the whole line to the background writer
+			string outBuf;
+			if( _logLevel != LogLevel_Internal )						// don't add a second timestamp to display of queued messages
+			{
+				outBuf.append( timeStr );
+				outBuf.append( GetLogLevelString( _logLevel ) );
+				outBuf.append( GetNodeString( _nodeId ) );
+			}
+			outBuf.append( lineBuf );
+			outBuf.append( "\n" );
+			m_writer->Write( outBuf.c_str(), (uint32)outBuf.size() );
+		}
+		else if( (_logLevel <= m_saveLevel) || (_logLevel == LogLevel_Internal) )
 		{
 			// save to file
 			FILE* pFile = NULL;
@@ -152,6 +191,8 @@ void LogImpl::Write
 			{
 				if( _logLevel != LogLevel_Internal )						// don't add a second timestamp to display of queued messages
 				{
+					string nodeStr = GetNodeString( _nodeId );
+					string logLevelStr = GetLogLevelString(_logLevel);
 					if( pFile != NULL )
 					{
 						fprintf( pFile, "%s%s%s", timeStr.c_str(), logLevelStr.c_str(), nodeStr.c_str() );
@@ -180,10 +221,15 @@ void LogImpl::Write
 
 		if( _logLevel != LogLevel_Internal )
 		{
-			char queueBuf[1024];
-			string threadStr = GetThreadId();
-			sprintf_s( queueBuf, sizeof(queueBuf), "%s%s%s", timeStr.c_str(), threadStr.c_str(), lineBuf );
-			Queue( queueBuf );
+			FILETIME fileTime;
+			::SystemTimeToFileTime( &time, &fileTime );
+
+			LogRing::Record record;
+			record.m_time = ( (uint64)fileTime.dwHighDateTime << 32 ) | fileTime.dwLowDateTime;
+			record.m_threadId = ::GetCurrentThreadId();
+			record.m_level = (uint8)_logLevel;
+			record.m_nodeId = _nodeId;
+			m_logQueue.Push( record, lineBuf, (uint32)strlen( lineBuf ) );
 		}
 	}
 
@@ -194,25 +240,6 @@ void LogImpl::Write
 	}
 }
 
-//-----------------------------------------------------------------------------
-//	<LogImpl::Queue>
-//	Write to the log queue
-//-----------------------------------------------------------------------------
-void LogImpl::Queue
-(
-	char const* _buffer
-)
-{
-	string bufStr = _buffer;
-	m_logQueue.push_back( bufStr );
-
-	// rudimentary queue size management
-	if( m_logQueue.size() > 500 )
-	{
-		m_logQueue.pop_front();
-	}
-}
-
 //-----------------------------------------------------------------------------
 //	<LogImpl::QueueDump>
 //	Dump the LogQueue to output device
@@ -222,14 +249,24 @@ void LogImpl::QueueDump
 )
 {
 	Log::Write( LogLevel_Internal, "\n\nDumping queued log messages\n");
-	list<string>::iterator it = m_logQueue.begin();
-	while( it != m_logQueue.end() )
+
+	LogRing::Record record;
+	char text[1024];
+	while( m_logQueue.Pop( &record, text, sizeof(text) ) )
 	{
-		string strTemp = *it;
-		Log::Write( LogLevel_Internal, strTemp.c_str() );
-		++it;
+		FILETIME fileTime;
+		fileTime.dwHighDateTime = (DWORD)( record.m_time >> 32 );
+		fileTime.dwLowDateTime = (DWORD)record.m_time;
+		SYSTEMTIME time;
+		::FileTimeToSystemTime( &fileTime, &time );
+
+		string line = GetTimeStampString( time );
+		line.append( GetThreadId( record.m_threadId ) );
+		line.append( GetLogLevelString( (LogLevel)record.m_level ) );
+		line.append( GetNodeString( record.m_nodeId ) );
+		line.append( text );
+		Log::Write( LogLevel_Internal, "%s", line.c_str() );
 	}
-	m_logQueue.clear();
 	Log::Write( LogLevel_Internal, "\nEnd of queued log message dump\n\n");
 }
 
@@ -241,7 +278,7 @@ void LogImpl::QueueClear
 (
 )
 {
-	m_logQueue.clear();
+	m_logQueue.Clear();
 }
 
 //-----------------------------------------------------------------------------
@@ -266,15 +303,12 @@ void LogImpl::SetLoggingState
 //-----------------------------------------------------------------------------
 string LogImpl::GetTimeStampString
 (
+	SYSTEMTIME const& _time
 )
 {
-	// Get a timestamp
-	SYSTEMTIME time;
-	::GetLocalTime( &time );
-
 	// create a time stamp string for the log message
 	char buf[100];
-	sprintf_s( buf, sizeof(buf), "%04d-%02d-%02d %02d:%02d:%02d.%03d ", time.wYear, time.wMonth, time.wDay, time.wHour, time.wMinute, time.wSecond, time.wMilliseconds );
+	sprintf_s( buf, sizeof(buf), "%04d-%02d-%02d %02d:%02d:%02d.%03d ", _time.wYear, _time.wMonth, _time.wDay, _time.wHour, _time.wMinute, _time.wSecond, _time.wMilliseconds );
 	string str = buf;
 	return str;
 }
@@ -311,10 +345,11 @@ string LogImpl::GetNodeString
 //-----------------------------------------------------------------------------
 string LogImpl::GetThreadId
 (
+	uint64 const _threadId
 )
 {
 	char buf[20];
-	DWORD dwThread = ::GetCurrentThreadId();
+	DWORD dwThread = (DWORD)_threadId;
 	sprintf_s( buf, sizeof(buf), "%04d ", dwThread );
 	string str = buf;
 	return str;
@@ -331,6 +366,17 @@ void LogImpl::SetLogFileName
 {
 	m_filename = _filename;
 }
+
+//-----------------------------------------------------------------------------
+//	<LogImpl::GetDroppedLineCount>
+//	Number of lines dropped by the background writer
+//-----------------------------------------------------------------------------
+uint32 LogImpl::GetDroppedLineCount
+(
+)
+{
+	return m_writer ? m_writer->GetDroppedCount() : 0;
+}
 //-----------------------------------------------------------------------------
 //	<LogImpl::GetLogLevelString>
 //	Provide a new log file name (applicable to future writes)
@@ -31,6 +31,8 @@
 #include "Defs.h"
 #include <string>
 #include "platform/Log.h"
+#include "platform/LogRing.h"
+#include "platform/LogWriter.h"
 #include "Windows.h"
 
 namespace OpenZWave
@@ -42,28 +44,30 @@ namespace OpenZWave
 	private:
 		friend class Log;
 
-		LogImpl( string const& _filename, bool const _bAppendLog, bool const _bConsoleOutput, LogLevel const _saveLevel, LogLevel const _queueLevel, LogLevel const _dumpTrigger );
+		LogImpl( string const& _filename, bool const _bAppendLog, bool const _bConsoleOutput, LogLevel const _saveLevel, LogLevel const _queueLevel, LogLevel const _dumpTrigger, uint32 const _asyncBufferSize );
 		~LogImpl();
 
 		void Write( LogLevel _level, uint8 const _nodeId, char const* _format, va_list _args );
-		void Queue( char const* _buffer );
 		void QueueDump();
 		void QueueClear();
 		void SetLoggingState( LogLevel _saveLevel, LogLevel _queueLevel, LogLevel _dumpTrigger );
 		void SetLogFileName( const string &_filename );
+		uint32 GetDroppedLineCount();
 
-		string GetTimeStampString();
+		string GetTimeStampString( SYSTEMTIME const& _time );
 		string GetNodeString( uint8 const _nodeId );
-		string GetThreadId();
+		string GetThreadId( uint64 const _threadId );
 		string GetLogLevelString(LogLevel _level);
 
 		string m_filename;						/**< filename specified by user (default is ozw_log.txt) */
 		bool m_bConsoleOutput;					/**< if true, send log output to console as well as to the file */
 		bool m_bAppendLog;						/**< if true, the log file should be appended to any with the same name */
-		list<string> m_logQueue;				/**< list of queued log messages */
+		LogRing m_logQueue;						/**< queued log messages */
 		LogLevel m_saveLevel;
 		LogLevel m_queueLevel;
 		LogLevel m_dumpTrigger;
+		LogWriter* m_writer;					/**< background writer, if logging asynchronously */
+		FILE* m_file;							/**< log file kept open for the background writer */
 	};
 
 } // namespace OpenZWave
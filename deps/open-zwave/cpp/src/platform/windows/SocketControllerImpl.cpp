@@ -0,0 +1,376 @@
+//-----------------------------------------------------------------------------
+//
+//	SocketControllerImpl.cpp
+//
+//	Windows implementation of a socket connection to a Z-Wave controller
+//
+//	SOFTWARE NOTICE AND LICENSE
+//
+//	This file is part of OpenZWave.
+//
+//	OpenZWave is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU Lesser General Public License as published
+//	by the Free Software Foundation, either version 3 of the License,
+//	or (at your option) any later version.
+//
+//	OpenZWave is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//	GNU Lesser General Public License for more details.
+//
+//	You should have received a copy of the GNU Lesser General Public License
+//	along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+
+#include "SocketControllerImpl.h"
+#include "Defs.h"
+
+#include "platform/Log.h"
+
+#pragma comment( lib, "ws2_32.lib" )
+
+using namespace OpenZWave;
+
+DWORD WINAPI SocketReadThreadEntryPoint( void* _context );
+
+//-----------------------------------------------------------------------------
+// <SocketControllerImpl::SocketControllerImpl>
+// Constructor
+//-----------------------------------------------------------------------------
+SocketControllerImpl::SocketControllerImpl
+(
+	SocketController* _owner
+):
+	m_owner( _owner ),
+	m_hThread( INVALID_HANDLE_VALUE ),
+	m_hExit( INVALID_HANDLE_VALUE ),
+	m_hSocket( INVALID_SOCKET ),
+	m_bWinsock( false )
+{
+	WSADATA wsaData;
+	m_bWinsock = ( WSAStartup( MAKEWORD( 2, 2 ), &wsaData ) == 0 );
+}
+
+//-----------------------------------------------------------------------------
+// <SocketControllerImpl::~SocketControllerImpl>
+// Destructor
+//-----------------------------------------------------------------------------
+SocketControllerImpl::~SocketControllerImpl
+(
+)
+{
+	if( INVALID_SOCKET != m_hSocket )
+	{
+		closesocket( m_hSocket );
+	}
+	if( m_bWinsock )
+	{
+		WSACleanup();
+	}
+}
+
+//-----------------------------------------------------------------------------
+// <SocketControllerImpl::Open>
+// Connect to the socket
+//-----------------------------------------------------------------------------
+bool SocketControllerImpl::Open
+( 
+)
+{
+	// Try to connect
+	if( !Init( 1 ) )
+	{
+		// Failed.  We bail to allow the app a chance to take over, rather than retry
+		// automatically.  Automatic retries only occur after a successful init.
+		return false;
+	}
+
+	// Create an event to trigger exiting the read thread
+	m_hExit = ::CreateEvent( NULL, TRUE, FALSE, NULL );
+
+	// Start the read thread
+	m_hThread = ::CreateThread( NULL, 0, SocketReadThreadEntryPoint, this, CREATE_SUSPENDED, NULL );
+	::ResumeThread( m_hThread );
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+// <SocketControllerImpl::Close>
+// Close the socket
+//-----------------------------------------------------------------------------
+void SocketControllerImpl::Close
+( 
+)
+{
+	::SetEvent( m_hExit );
+	::WaitForSingleObject( m_hThread, INFINITE );
+
+	CloseHandle( m_hThread );
+	m_hThread = INVALID_HANDLE_VALUE;
+
+	CloseHandle( m_hExit );
+	m_hExit = INVALID_HANDLE_VALUE;
+
+	if( INVALID_SOCKET != m_hSocket )
+	{
+		closesocket( m_hSocket );
+		m_hSocket = INVALID_SOCKET;
+	}
+}
+
+//-----------------------------------------------------------------------------
+// <SocketReadThreadEntryPoint>
+// Entry point of the thread for receiving data from the socket
+//-----------------------------------------------------------------------------
+DWORD WINAPI SocketReadThreadEntryPoint
+(
+	void* _context
+)
+{
+	SocketControllerImpl* impl = (SocketControllerImpl*)_context;
+	if( impl )
+	{
+		impl->ReadThreadProc();
+	}
+
+	return 0;
+}
+
+//-----------------------------------------------------------------------------
+// <SocketControllerImpl::ReadThreadProc>
+// Handle receiving data
+//-----------------------------------------------------------------------------
+void SocketControllerImpl::ReadThreadProc
+(
+)
+{  
+	uint32 attempts = 0;
+	while( true )
+	{
+		// Init must have been called successfully during Open, so we
+		// don't do it again until the end of the loop
+		if( INVALID_SOCKET != m_hSocket )
+		{
+			// Enter read loop.  Call will only return if
+			// an exit is requested or an error occurs
+			Read();
+
+			// Reset the attempts, so we get a rapid retry for temporary errors
+			attempts = 0;
+		}
+
+		if( attempts < 25 )		
+		{
+			// Retry every 5 seconds for the first two minutes...
+			if( WAIT_OBJECT_0 == ::WaitForSingleObject( m_hExit, 5000 ) )
+			{
+				// Exit signalled.
+				break;
+			}
+		}
+		else
+		{
+			// ...retry every 30 seconds after that
+			if( WAIT_OBJECT_0 == ::WaitForSingleObject( m_hExit, 30000 ) )
+			{
+				// Exit signalled.
+				break;
+			}
+		}
+
+		Init( ++attempts );
+	}
+}
+
+//-----------------------------------------------------------------------------
+// <SocketControllerImpl::Init>
+// Connect to the socket named by the controller path
+//-----------------------------------------------------------------------------
+bool SocketControllerImpl::Init
+(
+	uint32 const _attempts
+)
+{
+	string path = m_owner->m_socketPath;
+
+	Log::Write( LogLevel_Info, "Trying to connect to %s (attempt %d)", path.c_str(), _attempts );
+	if( !Connect( path ) )
+	{
+		Log::Write( LogLevel_Error, "ERROR: Failed to connect to %s", path.c_str() );
+		return false;
+	}
+
+	Log::Write( LogLevel_Info, "Connected to %s (attempt %d)", path.c_str(), _attempts );
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+// <SocketControllerImpl::Connect>
+// Parse a tcp://host:port name and connect to it
+//-----------------------------------------------------------------------------
+bool SocketControllerImpl::Connect
+(
+	string const& _path
+)
+{
+	if( !m_bWinsock )
+	{
+		Log::Write( LogLevel_Error, "ERROR: Winsock is not available" );
+		return false;
+	}
+
+	if( _path.compare( 0, 6, "tcp://" ) != 0 )
+	{
+		Log::Write( LogLevel_Error, "ERROR: Only tcp:// controller sockets are supported on Windows" );
+		return false;
+	}
+
+	// tcp://host:port, where an IPv6 host is written in brackets
+	string hostPort = _path.substr( 6 );
+	size_t colon = hostPort.rfind( ':' );
+	if( colon == string::npos || colon == 0 || colon + 1 == hostPort.size() )
+	{
+		Log::Write( LogLevel_Error, "ERROR: %s is not of the form tcp://host:port", _path.c_str() );
+		return false;
+	}
+	string host = hostPort.substr( 0, colon );
+	string port = hostPort.substr( colon + 1 );
+	if( host.size() > 2 && host[0] == '[' && host[host.size()-1] == ']' )
+	{
+		host = host.substr( 1, host.size() - 2 );
+	}
+
+	struct addrinfo hints;
+	memset( &hints, 0, sizeof(hints) );
+	hints.ai_family = AF_UNSPEC;
+	hints.ai_socktype = SOCK_STREAM;
+	hints.ai_protocol = IPPROTO_TCP;
+
+	struct addrinfo* addrs = NULL;
+	if( getaddrinfo( host.c_str(), port.c_str(), &hints, &addrs ) != 0 )
+	{
+		Log::Write( LogLevel_Error, "ERROR: Cannot resolve %s. Error code %d", host.c_str(), WSAGetLastError() );
+		return false;
+	}
+
+	for( struct addrinfo* ai = addrs; ai != NULL; ai = ai->ai_next )
+	{
+		m_hSocket = socket( ai->ai_family, ai->ai_socktype, ai->ai_protocol );
+		if( INVALID_SOCKET == m_hSocket )
+		{
+			continue;
+		}
+		if( connect( m_hSocket, ai->ai_addr, (int)ai->ai_addrlen ) == 0 )
+		{
+			break;
+		}
+		closesocket( m_hSocket );
+		m_hSocket = INVALID_SOCKET;
+	}
+	freeaddrinfo( addrs );
+
+	if( INVALID_SOCKET == m_hSocket )
+	{
+		Log::Write( LogLevel_Error, "ERROR: Cannot connect to %s port %s. Error code %d", host.c_str(), port.c_str(), WSAGetLastError() );
+		return false;
+	}
+
+	// Frames are small and each one waits for an ACK, so don't let Nagle hold them back
+	BOOL noDelay = TRUE;
+	setsockopt( m_hSocket, IPPROTO_TCP, TCP_NODELAY, (char const*)&noDelay, sizeof(noDelay) );
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+// <SocketControllerImpl::Read>
+// Read data from the socket until the exit event is set, or the connection is lost
+//-----------------------------------------------------------------------------
+void SocketControllerImpl::Read
+(
+)
+{
+	// Room for a maximum-size frame, which is handed on in one Put
+	uint8 buffer[256];
+
+	WSAEVENT hRead = WSACreateEvent();
+	WSAEventSelect( m_hSocket, hRead, FD_READ | FD_CLOSE );
+
+	HANDLE handles[2];
+	handles[0] = hRead;
+	handles[1] = m_hExit;
+
+	while( true )
+	{
+		DWORD res = WaitForMultipleObjects( 2, handles, FALSE, INFINITE );
+		if( (WAIT_OBJECT_0+1) == res )
+		{
+			// Exit signalled.
+			WSACloseEvent( hRead );
+			return;
+		}
+
+		WSANETWORKEVENTS events;
+		WSAEnumNetworkEvents( m_hSocket, hRead, &events );
+
+		int bytesRead;
+		if( events.lNetworkEvents & FD_CLOSE )
+		{
+			// Pass on whatever arrived before the connection closed
+			while( ( bytesRead = recv( m_hSocket, (char*)buffer, sizeof(buffer), 0 ) ) > 0 )
+			{
+				m_owner->Put( buffer, bytesRead );
+			}
+			Log::Write( LogLevel_Error, "ERROR: The controller closed the connection" );
+			break;
+		}
+
+		bytesRead = recv( m_hSocket, (char*)buffer, sizeof(buffer), 0 );
+		if( bytesRead > 0 )
+		{
+			m_owner->Put( buffer, bytesRead );
+		}
+		else if( bytesRead == 0 )
+		{
+			Log::Write( LogLevel_Error, "ERROR: The controller closed the connection" );
+			break;
+		}
+		else if( WSAGetLastError() != WSAEWOULDBLOCK )
+		{
+			Log::Write( LogLevel_Error, "ERROR: Reading from the socket failed. Error code %d", WSAGetLastError() );
+			break;
+		}
+	}
+
+	// Give up on this connection; the read thread will try to connect again
+	WSACloseEvent( hRead );
+	closesocket( m_hSocket );
+	m_hSocket = INVALID_SOCKET;
+}
+
+//-----------------------------------------------------------------------------
+// <SocketControllerImpl::Write>
+// Send data to the socket
+//-----------------------------------------------------------------------------
+uint32 SocketControllerImpl::Write
+(
+	uint8* _buffer,
+	uint32 _length
+)
+{
+	if( INVALID_SOCKET == m_hSocket )
+	{
+		//Error
+		Log::Write( LogLevel_Error, "ERROR: Socket must be connected before writing\n" );
+		return 0;
+	}
+
+	int bytesWritten = send( m_hSocket, (char const*)_buffer, (int)_length, 0 );
+	if( SOCKET_ERROR == bytesWritten )
+	{
+		Log::Write( LogLevel_Error, "ERROR: Writing to the socket failed. Error code %d", WSAGetLastError() );
+		return 0;
+	}
+	return (uint32)bytesWritten;
+}
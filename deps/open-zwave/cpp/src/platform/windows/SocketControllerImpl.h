@@ -0,0 +1,67 @@
+//-----------------------------------------------------------------------------
+//
+//	SocketControllerImpl.h
+//
+//	Windows implementation of a socket connection to a Z-Wave controller
+//
+//	SOFTWARE NOTICE AND LICENSE
+//
+//	This file is part of OpenZWave.
+//
+//	OpenZWave is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU Lesser General Public License as published
+//	by the Free Software Foundation, either version 3 of the License,
+//	or (at your option) any later version.
+//
+//	OpenZWave is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//	GNU Lesser General Public License for more details.
+//
+//	You should have received a copy of the GNU Lesser General Public License
+//	along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+
+#ifndef _SocketControllerImpl_H
+#define _SocketControllerImpl_H
+
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#include <Windows.h>
+
+#include "Defs.h"
+#include "platform/SocketController.h"
+
+namespace OpenZWave
+{
+	class SocketControllerImpl
+	{
+	public:
+		void ReadThreadProc();
+
+	private:
+		friend class SocketController;
+
+		SocketControllerImpl( SocketController* _owner );
+		~SocketControllerImpl();
+
+		bool Open();
+		void Close();
+
+		uint32 Write( uint8* _buffer, uint32 _length );
+
+		bool Init( uint32 const _attempts );
+		bool Connect( string const& _path );
+		void Read();
+
+		SocketController*			m_owner;
+		HANDLE						m_hThread;
+		HANDLE						m_hExit;
+		SOCKET						m_hSocket;
+		bool						m_bWinsock;		// true once WSAStartup has succeeded
+	};
+
+} // namespace OpenZWave
+
+#endif //_SocketControllerImpl_H
@@ -0,0 +1,77 @@
+//-----------------------------------------------------------------------------
+//
+//	WaitSetImpl.cpp
+//
+//	Windows implementation of the wakeup primitive behind a WaitSet
+//
+//	SOFTWARE NOTICE AND LICENSE
+//
+//	This file is part of OpenZWave.
+//
+//	OpenZWave is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU Lesser General Public License as published
+//	by the Free Software Foundation, either version 3 of the License,
+//	or (at your option) any later version.
+//
+//	OpenZWave is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//	GNU Lesser General Public License for more details.
+//
+//	You should have received a copy of the GNU Lesser General Public License
+//	along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+#include <windows.h>
+
+#include "Defs.h"
+#include "WaitSetImpl.h"
+
+using namespace OpenZWave;
+
+//-----------------------------------------------------------------------------
+//	<WaitSetImpl::WaitSetImpl>
+//	Constructor
+//-----------------------------------------------------------------------------
+WaitSetImpl::WaitSetImpl
+(
+)
+{
+	// Auto-reset, so that a successful wait consumes the signal
+	m_hEvent = ::CreateEvent( NULL, FALSE, FALSE, NULL );
+}
+
+//-----------------------------------------------------------------------------
+//	<WaitSetImpl::~WaitSetImpl>
+//	Destructor
+//-----------------------------------------------------------------------------
+WaitSetImpl::~WaitSetImpl
+(
+)
+{
+	::CloseHandle( m_hEvent );
+}
+
+//-----------------------------------------------------------------------------
+//	<WaitSetImpl::Signal>
+//	Wake up the thread waiting on the set
+//-----------------------------------------------------------------------------
+void WaitSetImpl::Signal
+(
+)
+{
+	::SetEvent( m_hEvent );
+}
+
+//-----------------------------------------------------------------------------
+//	<WaitSetImpl::Wait>
+//	Wait for Signal to be called
+//-----------------------------------------------------------------------------
+bool WaitSetImpl::Wait
+(
+	int32 const _timeout
+)
+{
+	DWORD timeout = ( _timeout < 0 ) ? INFINITE : (DWORD)_timeout;
+	return( WAIT_OBJECT_0 == ::WaitForSingleObject( m_hEvent, timeout ) );
+}
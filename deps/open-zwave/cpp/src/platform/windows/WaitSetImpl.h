@@ -0,0 +1,55 @@
+//-----------------------------------------------------------------------------
+//
+//	WaitSetImpl.h
+//
+//	Windows implementation of the wakeup primitive behind a WaitSet
+//
+//	SOFTWARE NOTICE AND LICENSE
+//
+//	This file is part of OpenZWave.
+//
+//	OpenZWave is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU Lesser General Public License as published
+//	by the Free Software Foundation, either version 3 of the License,
+//	or (at your option) any later version.
+//
+//	OpenZWave is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//	GNU Lesser General Public License for more details.
+//
+//	You should have received a copy of the GNU Lesser General Public License
+//	along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+#ifndef _WaitSetImpl_H
+#define _WaitSetImpl_H
+
+#include <windows.h>
+#include "Defs.h"
+
+namespace OpenZWave
+{
+	/** \brief Windows specific implementation of the WaitSet wakeup primitive.
+	 */
+	class WaitSetImpl
+	{
+	private:
+		friend class WaitSet;
+
+		WaitSetImpl();
+		~WaitSetImpl();
+
+		void Signal();					// Called from the watcher callbacks of the objects in the set
+		bool Wait( int32 _timeout );	// Returns true if Signal was called since the last Wait, false on timeout
+
+		WaitSetImpl( WaitSetImpl const& );					// prevent copy
+		WaitSetImpl& operator = ( WaitSetImpl const& );		// prevent assignment
+
+		HANDLE	m_hEvent;
+	};
+
+} // namespace OpenZWave
+
+#endif //_WaitSetImpl_H
+
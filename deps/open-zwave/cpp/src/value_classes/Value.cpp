@@ -32,6 +32,7 @@
 #include "Notification.h"
 #include "Msg.h"
 #include "value_classes/Value.h"
+#include "value_classes/ValueDecimal.h"
 #include "platform/Log.h"
 #include "command_classes/CommandClass.h"
 #include <ctime>
@@ -432,6 +433,21 @@ void Value::OnValueRefreshed
 }
 
 
+//-----------------------------------------------------------------------------
+// <Value::CheckMulticastLevel>
+// A device has reported its level, which may answer a multicast Set
+//-----------------------------------------------------------------------------
+void Value::CheckMulticastLevel
+(
+	uint8 const _level
+)
+{
+	if( Driver* driver = Manager::Get()->GetDriver( m_id.GetHomeId() ) )
+	{
+		driver->CheckMulticastLevel( m_id, _level );
+	}
+}
+
 //-----------------------------------------------------------------------------
 // <Value::OnValueChanged>
 // A value in a device has changed
@@ -607,6 +623,13 @@ int Value::VerifyRefreshedValue
 				Log::Write( LogLevel_Detail, m_id.GetNodeId(), "Refreshed Value: old value=%x, new value=%x, type=raw", _originalValue, _newValue );
 				break;
 			}
+			case 7:			// decimal
+			{
+				char originalBuf[ValueDecimal::c_maxFormatLength];
+				char newBuf[ValueDecimal::c_maxFormatLength];
+				Log::Write( LogLevel_Detail, m_id.GetNodeId(), "Refreshed Value: old value=%s, new value=%s, type=%s", ValueDecimal::Format( *((ValueDecimal::Decimal*)_originalValue), originalBuf ), ValueDecimal::Format( *((ValueDecimal::Decimal*)_newValue), newBuf ), "decimal" );
+				break;
+			}
 			default:
 			{
 				break;
@@ -648,6 +671,9 @@ int Value::VerifyRefreshedValue
 	case 6:			// raw
 		bOriginalEqual = ( memcmp( _originalValue, _newValue, _length ) == 0 );
 		break;
+	case 7:			// decimal
+		bOriginalEqual = ( *((ValueDecimal::Decimal*)_originalValue) == *((ValueDecimal::Decimal*)_newValue) );
+		break;
 	}
 
 		// if this is the first refresh of the value, test to see if the value has changed
@@ -690,6 +716,9 @@ int Value::VerifyRefreshedValue
 		case 6:
 			bCheckEqual = ( memcmp( _checkValue, _newValue, _length ) == 0 );
 			break;
+		case 7:			// decimal
+			bCheckEqual = ( *((ValueDecimal::Decimal*)_checkValue) == *((ValueDecimal::Decimal*)_newValue) );
+			break;
 		}
 		if( bCheckEqual )
 		{
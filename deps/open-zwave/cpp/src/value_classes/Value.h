@@ -31,6 +31,7 @@
 #include <string>
 #include "Defs.h"
 #include "platform/Ref.h"
+#include "InternedString.h"
 #include "value_classes/ValueID.h"
 
 class TiXmlElement;
@@ -96,6 +97,7 @@ namespace OpenZWave
 		void OnValueRefreshed();			// A value in a device has been refreshed
 		void OnValueChanged();				// The refreshed value actually changed
 		int VerifyRefreshedValue( void* _originalValue, void* _checkValue, void* _newValue, int _type, int _length = 0 );
+		void CheckMulticastLevel( uint8 const _level );	// Lets the driver confirm a multicast Set against the reported level
 
 		int32		m_min;
 		int32		m_max;
@@ -105,9 +107,9 @@ namespace OpenZWave
 
 	private:
 		ValueID		m_id;
-		string		m_label;
-		string		m_units;
-		string		m_help;
+		InternedString	m_label;
+		InternedString	m_units;
+		InternedString	m_help;
 		bool		m_readOnly;
 		bool		m_writeOnly;
 		bool		m_isSet;
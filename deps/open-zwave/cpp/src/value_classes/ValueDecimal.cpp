@@ -31,9 +31,23 @@
 #include "platform/Log.h"
 #include "Manager.h"
 #include <ctime>
+#include <ctype.h>
+#include <locale.h>
+#include <string.h>
 
 using namespace OpenZWave;
 
+// The precision field of a Z-Wave value is three bits wide
+static uint8 const c_maxPrecision = 7;
+
+// Any more digits and the scaled integer would no longer fit in an int32
+static uint32 const c_maxParseValue = 214748363;
+
+static double const c_powersOfTen[c_maxPrecision+1] =
+{
+	1.0, 10.0, 100.0, 1000.0, 10000.0, 100000.0, 1000000.0, 10000000.0
+};
+
 
 //-----------------------------------------------------------------------------
 // <ValueDecimal::ValueDecimal>
@@ -55,10 +69,7 @@ ValueDecimal::ValueDecimal
 	uint8 const _pollIntensity
 ):
   	Value( _homeId, _nodeId, _genre, _commandClassId, _instance, _index, ValueID::ValueType_Decimal, _label, _units, _readOnly, _writeOnly, false, _pollIntensity ),
-	m_value( _value ),
-	m_valueCheck( "" ),
-	m_newValue( "" ),
-	m_precision( 0 )
+	m_value( Parse( _value.c_str() ) )
 {
 }
 
@@ -79,7 +90,7 @@ void ValueDecimal::ReadXML
 	char const* str = _valueElement->Attribute( "value" );
 	if( str )
 	{
-		m_value = str;
+		m_value = Parse( str );
 	}
 	else
 	{
@@ -97,7 +108,9 @@ void ValueDecimal::WriteXML
 )
 {
 	Value::WriteXML( _valueElement );
-	_valueElement->SetAttribute( "value", m_value.c_str() );
+
+	char str[c_maxFormatLength];
+	_valueElement->SetAttribute( "value", Format( m_value, str ) );
 }
 
 //-----------------------------------------------------------------------------
@@ -111,7 +124,7 @@ bool ValueDecimal::Set
 {
 	// create a temporary copy of this value to be submitted to the Set() call and set its value to the function param
   	ValueDecimal* tempValue = new ValueDecimal( *this );
-	tempValue->m_value = _value;
+	tempValue->m_value = Parse( _value.c_str() );
 
 	// Set the value in the device.
 	bool ret = ((Value*)tempValue)->Set();
@@ -128,20 +141,140 @@ bool ValueDecimal::Set
 //-----------------------------------------------------------------------------
 void ValueDecimal::OnValueRefreshed
 (
-	string const& _value
+	int32 const _value,
+	uint8 const _precision
 )
 {
-	switch( VerifyRefreshedValue( (void*) &m_value, (void*) &m_valueCheck, (void*) &_value, 1) )
+	Decimal value( _value, _precision );
+	switch( VerifyRefreshedValue( (void*) &m_value, (void*) &m_valueCheck, (void*) &value, 7) )
 	{
 	case 0:		// value hasn't changed, nothing to do
 		break;
-	case 1:		// value has changed (not confirmed yet), save _value in m_valueCheck
-		m_valueCheck = _value;
+	case 1:		// value has changed (not confirmed yet), save value in m_valueCheck
+		m_valueCheck = value;
 		break;
-	case 2:		// value has changed (confirmed), save _value in m_value
-		m_value = _value;
+	case 2:		// value has changed (confirmed), save value in m_value
+		m_value = value;
 		break;
 	case 3:		// all three values are different, so wait for next refresh to try again
 		break;
 	}
 }
+
+//-----------------------------------------------------------------------------
+// <ValueDecimal::GetValue>
+// Format the value as a decimal string
+//-----------------------------------------------------------------------------
+string ValueDecimal::GetValue
+(
+)const
+{
+	char str[c_maxFormatLength];
+	return string( Format( m_value, str ) );
+}
+
+//-----------------------------------------------------------------------------
+// <ValueDecimal::GetAsFloat>
+// Get the value as a floating point number without going through a string
+//-----------------------------------------------------------------------------
+float ValueDecimal::GetAsFloat
+(
+)const
+{
+	uint8 precision = ( m_value.m_precision > c_maxPrecision ) ? c_maxPrecision : m_value.m_precision;
+	return (float)( (double)m_value.m_value / c_powersOfTen[precision] );
+}
+
+//-----------------------------------------------------------------------------
+// <ValueDecimal::Parse>
+// Convert a decimal string such as "-21.5" into a scaled integer.  Either
+// '.' or ',' is accepted as the decimal point, and digits beyond the
+// precision or range that Z-Wave can carry are dropped.
+//-----------------------------------------------------------------------------
+ValueDecimal::Decimal ValueDecimal::Parse
+(
+	char const* _str
+)
+{
+	Decimal res;
+	bool negative = false;
+	bool point = false;
+	uint32 value = 0;
+
+	while( isspace( (unsigned char)*_str ) )
+	{
+		++_str;
+	}
+
+	if( ( *_str == '-' ) || ( *_str == '+' ) )
+	{
+		negative = ( *_str == '-' );
+		++_str;
+	}
+
+	for( ; *_str; ++_str )
+	{
+		if( !point && ( ( *_str == '.' ) || ( *_str == ',' ) ) )
+		{
+			point = true;
+			continue;
+		}
+
+		if( ( *_str < '0' ) || ( *_str > '9' ) || ( value > c_maxParseValue ) )
+		{
+			break;
+		}
+
+		if( point )
+		{
+			if( res.m_precision == c_maxPrecision )
+			{
+				break;
+			}
+			++res.m_precision;
+		}
+		value = ( value * 10 ) + (uint32)( *_str - '0' );
+	}
+
+	res.m_value = negative ? -(int32)value : (int32)value;
+	return res;
+}
+
+//-----------------------------------------------------------------------------
+// <ValueDecimal::Format>
+// Write a scaled integer into a buffer of at least c_maxFormatLength chars
+// as a decimal string, using the locale's decimal point.
+//-----------------------------------------------------------------------------
+char const* ValueDecimal::Format
+(
+	Decimal const& _value,
+	char* o_buffer
+)
+{
+	// Work with the magnitude so that a leading zero can be padded in front
+	// of the digits without disturbing the sign.
+	uint32 magnitude = ( _value.m_value < 0 ) ? ( 0u - (uint32)_value.m_value ) : (uint32)_value.m_value;
+	uint32 precision = ( _value.m_precision > c_maxPrecision ) ? c_maxPrecision : _value.m_precision;
+
+	char digits[16];
+	snprintf( digits, sizeof(digits), "%0*u", (int)precision+1, magnitude );
+	uint32 whole = (uint32)strlen( digits ) - precision;
+
+	char* pos = o_buffer;
+	if( _value.m_value < 0 )
+	{
+		*pos++ = '-';
+	}
+	memcpy( pos, digits, whole );
+	pos += whole;
+
+	if( precision )
+	{
+		*pos++ = *(localeconv()->decimal_point);
+		memcpy( pos, &digits[whole], precision );
+		pos += precision;
+	}
+	*pos = 0;
+
+	return o_buffer;
+}
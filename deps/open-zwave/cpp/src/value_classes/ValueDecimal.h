@@ -40,6 +40,10 @@ namespace OpenZWave
 	class Node;
 
 	/** \brief Decimal value sent to/received from a node.
+	 *
+	 * The value is held as it travels over the air: a signed integer and the
+	 * number of digits after the decimal point.  A string is only built when
+	 * one is asked for.
 	 */
 	class ValueDecimal: public Value
 	{
@@ -49,12 +53,28 @@ namespace OpenZWave
 		friend class ThermostatSetpoint;
 
 	public:
+		/** \brief A scaled integer and its precision, e.g. 215 and 1 for 21.5.
+		 */
+		struct Decimal
+		{
+			Decimal( int32 const _value = 0, uint8 const _precision = 0 ): m_value( _value ), m_precision( _precision ){}
+
+			bool operator == ( Decimal const& _other )const{ return( ( m_value == _other.m_value ) && ( m_precision == _other.m_precision ) ); }
+			bool operator != ( Decimal const& _other )const{ return !( *this == _other ); }
+
+			int32	m_value;
+			uint8	m_precision;
+		};
+
+		// Longest string produced by Format, including the terminator
+		enum { c_maxFormatLength = 16 };
+
 		ValueDecimal( uint32 const _homeId, uint8 const _nodeId, ValueID::ValueGenre const _genre, uint8 const _commandClassId, uint8 const _instance, uint8 const _index, string const& _label, string const& _units, bool const _readOnly, bool const _writeOnly, string const& _value, uint8 const _pollIntensity );
-		ValueDecimal(): m_precision( 0 ){}
+		ValueDecimal(){}
 		virtual ~ValueDecimal(){}
 
 		bool Set( string const& _value );
-		void OnValueRefreshed( string const& _value );
+		void OnValueRefreshed( int32 const _value, uint8 const _precision );
 
 		// From Value
 		virtual string const GetAsString() const { return GetValue(); }
@@ -62,16 +82,18 @@ namespace OpenZWave
 		virtual void ReadXML( uint32 const _homeId, uint8 const _nodeId, uint8 const _commandClassId, TiXmlElement const* _valueElement );
 		virtual void WriteXML( TiXmlElement* _valueElement );
 
-		string GetValue()const{ return m_value; }
-		uint8 GetPrecision()const{ return m_precision; }
+		string GetValue()const;
+		float GetAsFloat()const;
+		int32 GetScaledValue()const{ return m_value.m_value; }
+		uint8 GetPrecision()const{ return m_value.m_precision; }
 
-	private:
-		void SetPrecision( uint8 _precision ){ m_precision = _precision; }
+		static Decimal Parse( char const* _str );
+		static char const* Format( Decimal const& _value, char* o_buffer );
 
-		string	m_value;				// the current value
-		string	m_valueCheck;			// the previous value (used for double-checking spurious value reads)
-		string	m_newValue;				// a new value to be set on the appropriate device
-	        uint8	m_precision;
+	private:
+		Decimal	m_value;				// the current value
+		Decimal	m_valueCheck;			// the previous value (used for double-checking spurious value reads)
+		Decimal	m_newValue;				// a new value to be set on the appropriate device
 	};
 
 } // namespace OpenZWave
@@ -49,8 +49,8 @@ namespace OpenZWave
 		*/
 		struct Item
 		{
-			string	m_label;
-			int32	m_value;
+			InternedString	m_label;
+			int32			m_value;
 		};
 
 		ValueList( uint32 const _homeId, uint8 const _nodeId, ValueID::ValueGenre const _genre, uint8 const _commandClassId, uint8 const _instance, uint8 const _index, string const& _label, string const& _units, bool const _readOnly, bool const _writeOnly, vector<Item> const& _items, int32 const _valueIdx, uint8 const _pollIntensity, uint8 const _size = 4 );
@@ -69,6 +69,7 @@ namespace OpenZWave
 		virtual void WriteXML( TiXmlElement* _valueElement );
 
 		Item const& GetItem()const{ return m_items[m_valueIdx]; }
+		bool HasItem()const{ return( ( m_valueIdx >= 0 ) && ( (uint32)m_valueIdx < m_items.size() ) ); }	// false if no item is selected yet
 		Item const& GetNewItem()const{ return m_items[m_newValueIdx]; }
 
 		int32 const GetItemIdxByLabel( string const& _label );
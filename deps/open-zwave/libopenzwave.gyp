@@ -81,14 +81,22 @@
         'cpp/src/platform/FileOps.cpp',
         'cpp/src/platform/HidController.cpp',
         'cpp/src/platform/Log.cpp',
+        'cpp/src/platform/LogRing.cpp',
+        'cpp/src/platform/LogWriter.cpp',
         'cpp/src/platform/Mutex.cpp',
         'cpp/src/platform/SerialController.cpp',
+        'cpp/src/platform/SocketController.cpp',
         'cpp/src/platform/Stream.cpp',
         'cpp/src/platform/Thread.cpp',
         'cpp/src/platform/TimeStamp.cpp',
         'cpp/src/platform/Wait.cpp',
+        'cpp/src/platform/WaitSet.cpp',
+        'cpp/src/ConfigCache.cpp',
+        'cpp/src/ConfigSnapshot.cpp',
+        'cpp/src/ConfigWriter.cpp',
         'cpp/src/Driver.cpp',
         'cpp/src/Group.cpp',
+        'cpp/src/InternedString.cpp',
         'cpp/src/Manager.cpp',
         'cpp/src/Msg.cpp',
         'cpp/src/Node.cpp',
@@ -115,9 +123,11 @@
         'cpp/src/platform/unix/LogImpl.cpp',
         'cpp/src/platform/unix/MutexImpl.cpp',
         'cpp/src/platform/unix/SerialControllerImpl.cpp',
+        'cpp/src/platform/unix/SocketControllerImpl.cpp',
         'cpp/src/platform/unix/ThreadImpl.cpp',
         'cpp/src/platform/unix/TimeStampImpl.cpp',
-        'cpp/src/platform/unix/WaitImpl.cpp'
+        'cpp/src/platform/unix/WaitImpl.cpp',
+        'cpp/src/platform/unix/WaitSetImpl.cpp'
         ],
 		'include_dirs': [ 'cpp/src/platform/unix' ],
         }],
@@ -129,9 +139,11 @@
         'cpp/src/platform/windows/LogImpl.cpp',
         'cpp/src/platform/windows/MutexImpl.cpp',
         'cpp/src/platform/windows/SerialControllerImpl.cpp',
+        'cpp/src/platform/windows/SocketControllerImpl.cpp',
         'cpp/src/platform/windows/ThreadImpl.cpp',
         'cpp/src/platform/windows/TimeStampImpl.cpp',
-        'cpp/src/platform/windows/WaitImpl.cpp'
+        'cpp/src/platform/windows/WaitImpl.cpp',
+        'cpp/src/platform/windows/WaitSetImpl.cpp'
           ],
 		'include_dirs': [ 'cpp/src/platform/windows' ],
 		'defines': ['BUILDING_NODE_EXTENSION']
@@ -144,9 +156,11 @@
         'cpp/src/platform/unix/LogImpl.cpp',
         'cpp/src/platform/unix/MutexImpl.cpp',
         'cpp/src/platform/unix/SerialControllerImpl.cpp',
+        'cpp/src/platform/unix/SocketControllerImpl.cpp',
         'cpp/src/platform/unix/ThreadImpl.cpp',
         'cpp/src/platform/unix/TimeStampImpl.cpp',
-        'cpp/src/platform/unix/WaitImpl.cpp'
+        'cpp/src/platform/unix/WaitImpl.cpp',
+        'cpp/src/platform/unix/WaitSetImpl.cpp'
           ],
 		  'include_dirs': [ 'cpp/src/platform/unix' ],
           'defines': ['DARWIN']
@@ -36,6 +36,7 @@ var _options = {
 	driverattempts: 3,
 	pollinterval: 500,
 	suppressrefresh: true,
+	batchnotifications: false,
 }
 var ZWave = function(path, options) {
 	options = options || {};
@@ -46,14 +47,25 @@ var ZWave = function(path, options) {
 	options.driverattempts = options.driverattempts || _options.driverattempts;
 	options.pollinterval = options.pollinterval || _options.pollinterval;
 	options.suppressrefresh = options.suppressrefresh || _options.suppressrefresh;
+	options.batchnotifications = options.batchnotifications || _options.batchnotifications;
 	this.path = path;
 	this.addon = new addon(options);
 	this.addon.emit = this.emit.bind(this);
+	this.addon.emitBatch = this.emitBatch.bind(this);
 }
 
 inherits(ZWave, events.EventEmitter);
 inherits(ZWave, addon);
 
+/*
+ * In batched mode the addon hands over every pending event at once, each as
+ * an array of emit() arguments.
+ */
+ZWave.prototype.emitBatch = function(events) {
+	for (var i = 0; i < events.length; i++)
+		this.emit.apply(this, events[i]);
+}
+
 ZWave.prototype.connect = function() {
 	this.addon.connect(this.path);
 }
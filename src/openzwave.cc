@@ -18,7 +18,13 @@
 
 
 #include <list>
-#include <queue>
+#include <vector>
+
+#ifdef WIN32
+#include <unordered_map>
+#else
+#include <tr1/unordered_map>
+#endif
 
 #include <node.h>
 #include <v8.h>
@@ -127,14 +133,22 @@ namespace {
 		uint8_t buttonid;
 		uint8_t sceneid;
 		uint8_t notification;
-		std::list<OpenZWave::ValueID> values;
+		uint64 valueid;
 	} NotifInfo;
 
+	/*
+	* Node values are hashed on (class, instance, index), which is unique
+	* within a node.  classvalues holds the first value seen for each command
+	* class, which is what enablePoll/disablePoll operate on.
+	*/
+	typedef std::tr1::unordered_map<uint32_t, OpenZWave::ValueID> ValueMap;
+
 	typedef struct {
 		uint32_t homeid;
 		uint8_t nodeid;
 		bool polled;
-		std::list<OpenZWave::ValueID> values;
+		ValueMap values;
+		ValueMap classvalues;
 	} NodeInfo;
 
 	typedef struct {
@@ -145,15 +159,26 @@ namespace {
 
 	/*
 	* Message passing queue between OpenZWave callback and v8 async handler.
+	* Notifications are copied into zqueue, which the async handler swaps
+	* with zdrain under the lock and then processes unlocked.  Both buffers
+	* keep their capacity, so after warm-up no notification allocates.
 	*/
+	static const size_t ZQUEUE_CAPACITY = 1024;
 	static mutex zqueue_mutex;
-	static std::queue<NotifInfo *> zqueue;
+	static std::vector<NotifInfo> zqueue;
+	static std::vector<NotifInfo> zdrain;
+
+	/*
+	* When set, each async wakeup delivers every pending event to JS in a
+	* single array instead of one emit() call per event.
+	*/
+	static bool zbatch = false;
 
 	/*
 	* Node state.
 	*/
 	static mutex znodes_mutex;
-	static std::list<NodeInfo *> znodes;
+	static NodeInfo *znodes[256];
 
 	static mutex zscenes_mutex;
 
@@ -167,17 +192,36 @@ namespace {
 	* Return the node for this request.
 	*/
 	NodeInfo *get_node_info(uint8_t nodeid) {
-		std::list<NodeInfo *>::iterator it;
+		return znodes[nodeid];
+	}
 
-		NodeInfo *node;
+	uint32_t get_value_key(uint8_t comclass, uint8_t instance, uint8_t index) {
+		return ((uint32_t)comclass << 16) | ((uint32_t)instance << 8) | index;
+	}
 
-		for (it = znodes.begin(); it != znodes.end(); ++it) {
-			node = *it;
-			if (node->nodeid == nodeid)
-				return node;
-		}
+	uint32_t get_value_key(OpenZWave::ValueID const &value) {
+		return get_value_key(value.GetCommandClassId(), value.GetInstance(), value.GetIndex());
+	}
 
-		return NULL;
+	/*
+	* Return the value of a node for this request.
+	*/
+	OpenZWave::ValueID *get_value_info(NodeInfo *node, uint8_t comclass, uint8_t instance, uint8_t index) {
+		ValueMap::iterator it = node->values.find(get_value_key(comclass, instance, index));
+
+		if (it == node->values.end())
+			return NULL;
+
+		return &it->second;
+	}
+
+	OpenZWave::ValueID *get_class_value_info(NodeInfo *node, uint8_t comclass) {
+		ValueMap::iterator it = node->classvalues.find(comclass);
+
+		if (it == node->classvalues.end())
+			return NULL;
+
+		return &it->second;
 	}
 
 	SceneInfo *get_scene_info(uint8_t sceneid) {
@@ -213,12 +257,13 @@ namespace {
 	* in v8 land.
 	*/
 	void cb(OpenZWave::Notification const *cb, void *ctx) {
-		NotifInfo *notif = new NotifInfo();
+		NotifInfo info = NotifInfo();
+		NotifInfo *notif = &info;
 
 		notif->type = cb->GetType();
 		notif->homeid = cb->GetHomeId();
 		notif->nodeid = cb->GetNodeId();
-		notif->values.push_front(cb->GetValueID());
+		notif->valueid = cb->GetValueID().GetId();
 
 		/*
 		* Some values are only set on particular notifications, and
@@ -248,232 +293,278 @@ namespace {
 
 		{
 			mutex::scoped_lock sl(zqueue_mutex);
-			zqueue.push(notif);
+			zqueue.push_back(info);
 		}
 		uv_async_send(&async);
 	}
 
 	/*
-	* Async handler, triggered by the OpenZWave callback.
+	* Update node state for a notification and fill in the arguments of the
+	* event it maps to.  Returns the argument count, or 0 if there is nothing
+	* to emit.
 	*/
-	void async_cb_handler(uv_async_t *handle, int status) {
+	int zwaveNotif2v8Args(NotifInfo *notif, Local<Value> *args) {
 		NodeInfo *node;
-		NotifInfo *notif;
-		Local < Value > args[16];
-
+		int argc = 0;
 
-		mutex::scoped_lock sl(zqueue_mutex);
-
-		while (!zqueue.empty()) {
-			notif = zqueue.front();
-
-			switch (notif->type) {
-			case OpenZWave::Notification::Type_DriverReady:
-				homeid = notif->homeid;
-				args[0] = String::New("driver ready");
-				args[1] = Integer::New(homeid);
-				MakeCallback(context_obj, "emit", 2, args);
-				break;
-			case OpenZWave::Notification::Type_DriverFailed:
-				args[0] = String::New("driver failed");
-				MakeCallback(context_obj, "emit", 1, args);
-				break;
-				/*
-				* NodeNew is triggered when a node is discovered which is not
-				* found in the OpenZWave XML file.  As we do not use that file
-				* simply ignore those notifications for now.
-				*
-				* NodeAdded is when we actually have a new node to set up.
-				*/
-			case OpenZWave::Notification::Type_NodeNew:
-				break;
-			case OpenZWave::Notification::Type_NodeAdded:
-				node = new NodeInfo();
-				node->homeid = notif->homeid;
-				node->nodeid = notif->nodeid;
-				node->polled = false;
-				{
-					mutex::scoped_lock sl(znodes_mutex);
-					znodes.push_back(node);
-				}
-				args[0] = String::New("node added");
-				args[1] = Integer::New(notif->nodeid);
-				MakeCallback(context_obj, "emit", 2, args);
-				break;
-				/*
-				* Ignore intermediate notifications about a node status, we
-				* wait until the node is ready before retrieving information.
-				*/
-			case OpenZWave::Notification::Type_NodeProtocolInfo:
-				break;
-			case OpenZWave::Notification::Type_NodeNaming: {
-				Local < Object > info = Object::New();
-				info->Set(String::NewSymbol("manufacturer"), String::New(OpenZWave::Manager::Get()->GetNodeManufacturerName(notif->homeid, notif->nodeid).c_str()));
-				info->Set(String::NewSymbol("manufacturerid"), String::New(OpenZWave::Manager::Get()->GetNodeManufacturerId(notif->homeid, notif->nodeid).c_str()));
-				info->Set(String::NewSymbol("product"), String::New(OpenZWave::Manager::Get()->GetNodeProductName(notif->homeid, notif->nodeid).c_str()));
-				info->Set(String::NewSymbol("producttype"), String::New(OpenZWave::Manager::Get()->GetNodeProductType(notif->homeid, notif->nodeid).c_str()));
-				info->Set(String::NewSymbol("productid"), String::New(OpenZWave::Manager::Get()->GetNodeProductId(notif->homeid, notif->nodeid).c_str()));
-				info->Set(String::NewSymbol("type"), String::New(OpenZWave::Manager::Get()->GetNodeType(notif->homeid, notif->nodeid).c_str()));
-				info->Set(String::NewSymbol("name"), String::New(OpenZWave::Manager::Get()->GetNodeName(notif->homeid, notif->nodeid).c_str()));
-				info->Set(String::NewSymbol("loc"), String::New(OpenZWave::Manager::Get()->GetNodeLocation(notif->homeid, notif->nodeid).c_str()));
-				args[0] = String::New("node naming");
-				args[1] = Integer::New(notif->nodeid);
-				args[2] = info;
-				MakeCallback(context_obj, "emit", 3, args);
-				break;
+		switch (notif->type) {
+		case OpenZWave::Notification::Type_DriverReady:
+			homeid = notif->homeid;
+			args[0] = String::New("driver ready");
+			args[1] = Integer::New(homeid);
+			argc = 2;
+			break;
+		case OpenZWave::Notification::Type_DriverFailed:
+			args[0] = String::New("driver failed");
+			argc = 1;
+			break;
+			/*
+			* NodeNew is triggered when a node is discovered which is not
+			* found in the OpenZWave XML file.  As we do not use that file
+			* simply ignore those notifications for now.
+			*
+			* NodeAdded is when we actually have a new node to set up.
+			*/
+		case OpenZWave::Notification::Type_NodeNew:
+			break;
+		case OpenZWave::Notification::Type_NodeAdded:
+			node = new NodeInfo();
+			node->homeid = notif->homeid;
+			node->nodeid = notif->nodeid;
+			node->polled = false;
+			{
+				mutex::scoped_lock sl(znodes_mutex);
+				delete znodes[notif->nodeid];
+				znodes[notif->nodeid] = node;
 			}
-														   // XXX: these should be supported correctly.
-			case OpenZWave::Notification::Type_PollingEnabled:
-			case OpenZWave::Notification::Type_PollingDisabled:
-				break;
+			args[0] = String::New("node added");
+			args[1] = Integer::New(notif->nodeid);
+			argc = 2;
+			break;
+			/*
+			* Ignore intermediate notifications about a node status, we
+			* wait until the node is ready before retrieving information.
+			*/
+		case OpenZWave::Notification::Type_NodeProtocolInfo:
+			break;
+		case OpenZWave::Notification::Type_NodeNaming: {
+			Local < Object > info = Object::New();
+			info->Set(String::NewSymbol("manufacturer"), String::New(OpenZWave::Manager::Get()->GetNodeManufacturerName(notif->homeid, notif->nodeid).c_str()));
+			info->Set(String::NewSymbol("manufacturerid"), String::New(OpenZWave::Manager::Get()->GetNodeManufacturerId(notif->homeid, notif->nodeid).c_str()));
+			info->Set(String::NewSymbol("product"), String::New(OpenZWave::Manager::Get()->GetNodeProductName(notif->homeid, notif->nodeid).c_str()));
+			info->Set(String::NewSymbol("producttype"), String::New(OpenZWave::Manager::Get()->GetNodeProductType(notif->homeid, notif->nodeid).c_str()));
+			info->Set(String::NewSymbol("productid"), String::New(OpenZWave::Manager::Get()->GetNodeProductId(notif->homeid, notif->nodeid).c_str()));
+			info->Set(String::NewSymbol("type"), String::New(OpenZWave::Manager::Get()->GetNodeType(notif->homeid, notif->nodeid).c_str()));
+			info->Set(String::NewSymbol("name"), String::New(OpenZWave::Manager::Get()->GetNodeName(notif->homeid, notif->nodeid).c_str()));
+			info->Set(String::NewSymbol("loc"), String::New(OpenZWave::Manager::Get()->GetNodeLocation(notif->homeid, notif->nodeid).c_str()));
+			args[0] = String::New("node naming");
+			args[1] = Integer::New(notif->nodeid);
+			args[2] = info;
+			argc = 3;
+			break;
+		}
+													   // XXX: these should be supported correctly.
+		case OpenZWave::Notification::Type_PollingEnabled:
+		case OpenZWave::Notification::Type_PollingDisabled:
+			break;
+			/*
+			* Node values.
+			*/
+		case OpenZWave::Notification::Type_ValueAdded: {
+			OpenZWave::ValueID value = OpenZWave::ValueID(notif->homeid, notif->valueid);
+			Local<Object> valobj = zwaveValue2v8Value(value);
+
+			if ((node = get_node_info(notif->nodeid))) {
+				mutex::scoped_lock sl(znodes_mutex);
+				node->values.insert(ValueMap::value_type(get_value_key(value), value));
+				node->classvalues.insert(ValueMap::value_type(value.GetCommandClassId(), value));
+			}
+
+			args[0] = String::New("value added");
+			args[1] = Integer::New(notif->nodeid);
+			args[2] = Integer::New(value.GetCommandClassId());
+			args[3] = valobj;
+			argc = 4;
+			break;
+		}
+		case OpenZWave::Notification::Type_ValueChanged: {
+			OpenZWave::ValueID value = OpenZWave::ValueID(notif->homeid, notif->valueid);
+			Local<Object> valobj = zwaveValue2v8Value(value);
+
+			args[0] = String::New("value changed");
+			args[1] = Integer::New(notif->nodeid);
+			args[2] = Integer::New(value.GetCommandClassId());
+			args[3] = valobj;
+			argc = 4;
+			break;
+		}
+		case OpenZWave::Notification::Type_ValueRefreshed: {
+			OpenZWave::ValueID value = OpenZWave::ValueID(notif->homeid, notif->valueid);
+			Local<Object> valobj = zwaveValue2v8Value(value);
+
+			args[0] = String::New("value refreshed");
+			args[1] = Integer::New(notif->nodeid);
+			args[2] = Integer::New(value.GetCommandClassId());
+			args[3] = valobj;
+			argc = 4;
+			break;
+		}
+		case OpenZWave::Notification::Type_ValueRemoved: {
+			OpenZWave::ValueID value = OpenZWave::ValueID(notif->homeid, notif->valueid);
+			OpenZWave::ValueID *classvalue;
+			if ((node = get_node_info(notif->nodeid))) {
+				mutex::scoped_lock sl(znodes_mutex);
+				node->values.erase(get_value_key(value));
 				/*
-				* Node values.
+				* If this value stood in for its command class, hand
+				* that role to another value of the same class.
 				*/
-			case OpenZWave::Notification::Type_ValueAdded: {
-				OpenZWave::ValueID value = notif->values.front();
-				Local<Object> valobj = zwaveValue2v8Value(value);
-
-				if ((node = get_node_info(notif->nodeid))) {
-					mutex::scoped_lock sl(znodes_mutex);
-					//pthread_mutex_lock(&znodes_mutex);
-					node->values.push_back(value);
-					//pthread_mutex_unlock(&znodes_mutex);
-				}
-
-				args[0] = String::New("value added");
-				args[1] = Integer::New(notif->nodeid);
-				args[2] = Integer::New(value.GetCommandClassId());
-				args[3] = valobj;
-				MakeCallback(context_obj, "emit", 4, args);
-				break;
-			}
-			case OpenZWave::Notification::Type_ValueChanged: {
-				OpenZWave::ValueID value = notif->values.front();
-				Local<Object> valobj = zwaveValue2v8Value(value);
-
-				args[0] = String::New("value changed");
-				args[1] = Integer::New(notif->nodeid);
-				args[2] = Integer::New(value.GetCommandClassId());
-				args[3] = valobj;
-				MakeCallback(context_obj, "emit", 4, args);
-				break;
-			}
-			case OpenZWave::Notification::Type_ValueRefreshed: {
-				OpenZWave::ValueID value = notif->values.front();
-				Local<Object> valobj = zwaveValue2v8Value(value);
-
-				args[0] = String::New("value refreshed");
-				args[1] = Integer::New(notif->nodeid);
-				args[2] = Integer::New(value.GetCommandClassId());
-				args[3] = valobj;
-				MakeCallback(context_obj, "emit", 4, args);
-				break;
-			}
-			case OpenZWave::Notification::Type_ValueRemoved: {
-				OpenZWave::ValueID value = notif->values.front();
-				std::list<OpenZWave::ValueID>::iterator vit;
-				if ((node = get_node_info(notif->nodeid))) {
-					for (vit = node->values.begin(); vit != node->values.end(); ++vit) {
-						if ((*vit) == notif->values.front()) {
-							node->values.erase(vit);
+				if ((classvalue = get_class_value_info(node, value.GetCommandClassId())) && (*classvalue == value)) {
+					node->classvalues.erase(value.GetCommandClassId());
+					for (ValueMap::iterator vit = node->values.begin(); vit != node->values.end(); ++vit) {
+						if (vit->second.GetCommandClassId() == value.GetCommandClassId()) {
+							node->classvalues.insert(ValueMap::value_type(value.GetCommandClassId(), vit->second));
 							break;
 						}
 					}
 				}
-				args[0] = String::New("value removed");
-				args[1] = Integer::New(notif->nodeid);
-				args[2] = Integer::New(value.GetCommandClassId());
-				args[3] = Integer::New(value.GetInstance());
-				args[4] = Integer::New(value.GetIndex());
-				MakeCallback(context_obj, "emit", 5, args);
-				break;
 			}
-			
+			args[0] = String::New("value removed");
+			args[1] = Integer::New(notif->nodeid);
+			args[2] = Integer::New(value.GetCommandClassId());
+			args[3] = Integer::New(value.GetInstance());
+			args[4] = Integer::New(value.GetIndex());
+			argc = 5;
+			break;
+		}
+		
+		/*
+		 *Now node can accept commands.
+		 */
+		case OpenZWave::Notification::Type_EssentialNodeQueriesComplete: {
+			Local < Object > info = Object::New();
+			info->Set(String::NewSymbol("manufacturer"), String::New(OpenZWave::Manager::Get()->GetNodeManufacturerName(notif->homeid, notif->nodeid).c_str()));
+			info->Set(String::NewSymbol("manufacturerid"), String::New(OpenZWave::Manager::Get()->GetNodeManufacturerId(notif->homeid, notif->nodeid).c_str()));
+			info->Set(String::NewSymbol("product"), String::New(OpenZWave::Manager::Get()->GetNodeProductName(notif->homeid, notif->nodeid).c_str()));
+			info->Set(String::NewSymbol("producttype"), String::New(OpenZWave::Manager::Get()->GetNodeProductType(notif->homeid, notif->nodeid).c_str()));
+			info->Set(String::NewSymbol("productid"), String::New(OpenZWave::Manager::Get()->GetNodeProductId(notif->homeid, notif->nodeid).c_str()));
+			info->Set(String::NewSymbol("type"), String::New(OpenZWave::Manager::Get()->GetNodeType(notif->homeid, notif->nodeid).c_str()));
+			info->Set(String::NewSymbol("name"), String::New(OpenZWave::Manager::Get()->GetNodeName(notif->homeid, notif->nodeid).c_str()));
+			info->Set(String::NewSymbol("loc"), String::New(OpenZWave::Manager::Get()->GetNodeLocation(notif->homeid, notif->nodeid).c_str()));
+			args[0] = String::New("node available");
+			args[1] = Integer::New(notif->nodeid);
+			args[2] = info;
+			argc = 3;
+			break;
+		}
 			/*
-			 *Now node can accept commands.
-			 */
-			case OpenZWave::Notification::Type_EssentialNodeQueriesComplete: {
-				Local < Object > info = Object::New();
-				info->Set(String::NewSymbol("manufacturer"), String::New(OpenZWave::Manager::Get()->GetNodeManufacturerName(notif->homeid, notif->nodeid).c_str()));
-				info->Set(String::NewSymbol("manufacturerid"), String::New(OpenZWave::Manager::Get()->GetNodeManufacturerId(notif->homeid, notif->nodeid).c_str()));
-				info->Set(String::NewSymbol("product"), String::New(OpenZWave::Manager::Get()->GetNodeProductName(notif->homeid, notif->nodeid).c_str()));
-				info->Set(String::NewSymbol("producttype"), String::New(OpenZWave::Manager::Get()->GetNodeProductType(notif->homeid, notif->nodeid).c_str()));
-				info->Set(String::NewSymbol("productid"), String::New(OpenZWave::Manager::Get()->GetNodeProductId(notif->homeid, notif->nodeid).c_str()));
-				info->Set(String::NewSymbol("type"), String::New(OpenZWave::Manager::Get()->GetNodeType(notif->homeid, notif->nodeid).c_str()));
-				info->Set(String::NewSymbol("name"), String::New(OpenZWave::Manager::Get()->GetNodeName(notif->homeid, notif->nodeid).c_str()));
-				info->Set(String::NewSymbol("loc"), String::New(OpenZWave::Manager::Get()->GetNodeLocation(notif->homeid, notif->nodeid).c_str()));
-				args[0] = String::New("node available");
-				args[1] = Integer::New(notif->nodeid);
-				args[2] = info;
-				MakeCallback(context_obj, "emit", 3, args);
-				break;
-			}
-				/*
-				* The node is now fully ready for operation.
-				*/
-			case OpenZWave::Notification::Type_NodeQueriesComplete: {
-				Local < Object > info = Object::New();
-				info->Set(String::NewSymbol("manufacturer"), String::New(OpenZWave::Manager::Get()->GetNodeManufacturerName(notif->homeid, notif->nodeid).c_str()));
-				info->Set(String::NewSymbol("manufacturerid"), String::New(OpenZWave::Manager::Get()->GetNodeManufacturerId(notif->homeid, notif->nodeid).c_str()));
-				info->Set(String::NewSymbol("product"), String::New(OpenZWave::Manager::Get()->GetNodeProductName(notif->homeid, notif->nodeid).c_str()));
-				info->Set(String::NewSymbol("producttype"), String::New(OpenZWave::Manager::Get()->GetNodeProductType(notif->homeid, notif->nodeid).c_str()));
-				info->Set(String::NewSymbol("productid"), String::New(OpenZWave::Manager::Get()->GetNodeProductId(notif->homeid, notif->nodeid).c_str()));
-				info->Set(String::NewSymbol("type"), String::New(OpenZWave::Manager::Get()->GetNodeType(notif->homeid, notif->nodeid).c_str()));
-				info->Set(String::NewSymbol("name"), String::New(OpenZWave::Manager::Get()->GetNodeName(notif->homeid, notif->nodeid).c_str()));
-				info->Set(String::NewSymbol("loc"), String::New(OpenZWave::Manager::Get()->GetNodeLocation(notif->homeid, notif->nodeid).c_str()));
-				args[0] = String::New("node ready");
-				args[1] = Integer::New(notif->nodeid);
-				args[2] = info;
-				MakeCallback(context_obj, "emit", 3, args);
-				break;
-			}
-																	/*
-																	* The network scan has been completed.  Currently we do not
-																	* care about dead nodes - is there anything we can do anyway?
-																	*/
-			case OpenZWave::Notification::Type_AwakeNodesQueried:
-			case OpenZWave::Notification::Type_AllNodesQueried:
-			case OpenZWave::Notification::Type_AllNodesQueriedSomeDead:
-				args[0] = String::New("scan complete");
-				MakeCallback(context_obj, "emit", 1, args);
-				break;
-			case OpenZWave::Notification::Type_NodeEvent: {
-				args[0] = String::New("node event");
-				args[1] = Integer::New(notif->nodeid);
-				args[2] = Integer::New(notif->event);
-				MakeCallback(context_obj, "emit", 3, args);
-				break;
+			* The node is now fully ready for operation.
+			*/
+		case OpenZWave::Notification::Type_NodeQueriesComplete: {
+			Local < Object > info = Object::New();
+			info->Set(String::NewSymbol("manufacturer"), String::New(OpenZWave::Manager::Get()->GetNodeManufacturerName(notif->homeid, notif->nodeid).c_str()));
+			info->Set(String::NewSymbol("manufacturerid"), String::New(OpenZWave::Manager::Get()->GetNodeManufacturerId(notif->homeid, notif->nodeid).c_str()));
+			info->Set(String::NewSymbol("product"), String::New(OpenZWave::Manager::Get()->GetNodeProductName(notif->homeid, notif->nodeid).c_str()));
+			info->Set(String::NewSymbol("producttype"), String::New(OpenZWave::Manager::Get()->GetNodeProductType(notif->homeid, notif->nodeid).c_str()));
+			info->Set(String::NewSymbol("productid"), String::New(OpenZWave::Manager::Get()->GetNodeProductId(notif->homeid, notif->nodeid).c_str()));
+			info->Set(String::NewSymbol("type"), String::New(OpenZWave::Manager::Get()->GetNodeType(notif->homeid, notif->nodeid).c_str()));
+			info->Set(String::NewSymbol("name"), String::New(OpenZWave::Manager::Get()->GetNodeName(notif->homeid, notif->nodeid).c_str()));
+			info->Set(String::NewSymbol("loc"), String::New(OpenZWave::Manager::Get()->GetNodeLocation(notif->homeid, notif->nodeid).c_str()));
+			args[0] = String::New("node ready");
+			args[1] = Integer::New(notif->nodeid);
+			args[2] = info;
+			argc = 3;
+			break;
+		}
+																/*
+																* The network scan has been completed.  Currently we do not
+																* care about dead nodes - is there anything we can do anyway?
+																*/
+		case OpenZWave::Notification::Type_AwakeNodesQueried:
+		case OpenZWave::Notification::Type_AllNodesQueried:
+		case OpenZWave::Notification::Type_AllNodesQueriedSomeDead:
+			args[0] = String::New("scan complete");
+			argc = 1;
+			break;
+		case OpenZWave::Notification::Type_NodeEvent: {
+			args[0] = String::New("node event");
+			args[1] = Integer::New(notif->nodeid);
+			args[2] = Integer::New(notif->event);
+			argc = 3;
+			break;
+		}
+		case OpenZWave::Notification::Type_SceneEvent:{
+			args[0] = String::New("scene event");
+			args[1] = Integer::New(notif->nodeid);
+			args[2] = Integer::New(notif->sceneid);
+			argc = 3;
+			break;
+		}
+													  /*
+													  * A general notification.
+													  */
+		case OpenZWave::Notification::Type_Notification:
+			args[0] = String::New("notification");
+			args[1] = Integer::New(notif->nodeid);
+			args[2] = Integer::New(notif->notification);
+			argc = 3;
+			break;
+		case OpenZWave::Notification::Type_Group:
+			// Leave it for now
+			break;
+			/*
+			* Send unhandled events to stderr so we can monitor them if
+			* necessary.
+			*/
+		default:
+			fprintf(stderr, "Unhandled notification: %d\n", notif->type);
+			break;
+		}
+
+		return argc;
+	}
+
+	/*
+	* Async handler, triggered by the OpenZWave callback.
+	*/
+	void async_cb_handler(uv_async_t *handle, int status) {
+		HandleScope scope;
+		Local < Value > args[16];
+		int argc;
+
+		{
+			mutex::scoped_lock sl(zqueue_mutex);
+			zqueue.swap(zdrain);
+		}
+
+		if (zbatch) {
+			Local < Array > events = Array::New();
+			unsigned n = 0;
+
+			for (size_t i = 0; i < zdrain.size(); i++) {
+				if ((argc = zwaveNotif2v8Args(&zdrain[i], args)) > 0) {
+					Local < Array > event = Array::New(argc);
+					for (int j = 0; j < argc; j++) {
+						event->Set(Number::New(j), args[j]);
+					}
+					events->Set(Number::New(n++), event);
+				}
 			}
-			case OpenZWave::Notification::Type_SceneEvent:{
-				args[0] = String::New("scene event");
-				args[1] = Integer::New(notif->nodeid);
-				args[2] = Integer::New(notif->sceneid);
-				MakeCallback(context_obj, "emit", 3, args);
-				break;
+
+			if (n > 0) {
+				args[0] = events;
+				MakeCallback(context_obj, "emitBatch", 1, args);
 			}
-														  /*
-														  * A general notification.
-														  */
-			case OpenZWave::Notification::Type_Notification:
-				args[0] = String::New("notification");
-				args[1] = Integer::New(notif->nodeid);
-				args[2] = Integer::New(notif->notification);
-				MakeCallback(context_obj, "emit", 3, args);
-				break;
-			case OpenZWave::Notification::Type_Group:
-				// Leave it for now
-				break;
-				/*
-				* Send unhandled events to stderr so we can monitor them if
-				* necessary.
-				*/
-			default:
-				fprintf(stderr, "Unhandled notification: %d\n", notif->type);
-				break;
+		}
+		else {
+			for (size_t i = 0; i < zdrain.size(); i++) {
+				if ((argc = zwaveNotif2v8Args(&zdrain[i], args)) > 0) {
+					MakeCallback(context_obj, "emit", argc, args);
+				}
 			}
-
-			zqueue.pop();
 		}
+
+		zdrain.clear();
 	}
 
 	Local<Object> zwaveValue2v8Value(OpenZWave::ValueID value) {
@@ -495,66 +586,57 @@ namespace {
 		valobj->Set(String::NewSymbol("genre"), String::New(OpenZWave::Value::GetGenreNameFromEnum(value.GetGenre())));
 		valobj->Set(String::NewSymbol("instance"), Integer::New(value.GetInstance()));
 		valobj->Set(String::NewSymbol("index"), Integer::New(value.GetIndex()));
-		valobj->Set(String::NewSymbol("label"), String::New(OpenZWave::Manager::Get()->GetValueLabel(value).c_str()));
-		valobj->Set(String::NewSymbol("units"), String::New(OpenZWave::Manager::Get()->GetValueUnits(value).c_str()));
-		valobj->Set(String::NewSymbol("read_only"), Boolean::New(OpenZWave::Manager::Get()->IsValueReadOnly(value))->ToBoolean());
-		valobj->Set(String::NewSymbol("write_only"), Boolean::New(OpenZWave::Manager::Get()->IsValueWriteOnly(value))->ToBoolean());
+		/*
+		* Fetch everything about the value with a single node lock.
+		*/
+		OpenZWave::Manager::ValueSnapshot snapshot;
+		OpenZWave::Manager::Get()->GetValueSnapshot(value, &snapshot);
+
+		valobj->Set(String::NewSymbol("label"), String::New(snapshot.m_label.c_str()));
+		valobj->Set(String::NewSymbol("units"), String::New(snapshot.m_units.c_str()));
+		valobj->Set(String::NewSymbol("read_only"), Boolean::New(snapshot.m_readOnly)->ToBoolean());
+		valobj->Set(String::NewSymbol("write_only"), Boolean::New(snapshot.m_writeOnly)->ToBoolean());
 		// XXX: verify_changes=
 		// XXX: poll_intensity=
-		valobj->Set(String::NewSymbol("min"), Integer::New(OpenZWave::Manager::Get()->GetValueMin(value)));
-		valobj->Set(String::NewSymbol("max"), Integer::New(OpenZWave::Manager::Get()->GetValueMax(value)));
+		valobj->Set(String::NewSymbol("min"), Integer::New(snapshot.m_min));
+		valobj->Set(String::NewSymbol("max"), Integer::New(snapshot.m_max));
 
 		/*
 		* The value itself is type-specific.
 		*/
 		switch (value.GetType()) {
 		case OpenZWave::ValueID::ValueType_Bool: {
-			bool val;
-			OpenZWave::Manager::Get()->GetValueAsBool(value, &val);
-			valobj->Set(String::NewSymbol("value"), Boolean::New(val)->ToBoolean());
+			valobj->Set(String::NewSymbol("value"), Boolean::New(snapshot.m_valueAsBool)->ToBoolean());
 			break;
 		}
 		case OpenZWave::ValueID::ValueType_Byte: {
-			uint8_t val;
-			OpenZWave::Manager::Get()->GetValueAsByte(value, &val);
-			valobj->Set(String::NewSymbol("value"), Integer::New(val));
+			valobj->Set(String::NewSymbol("value"), Integer::New(snapshot.m_valueAsByte));
 			break;
 		}
 		case OpenZWave::ValueID::ValueType_Decimal: {
-			float val;
-			OpenZWave::Manager::Get()->GetValueAsFloat(value, &val);
-			valobj->Set(String::NewSymbol("value"), Integer::New(val));
+			valobj->Set(String::NewSymbol("value"), Number::New(snapshot.m_valueAsFloat));
 			break;
 		}
 		case OpenZWave::ValueID::ValueType_Int: {
-			int32_t val;
-			OpenZWave::Manager::Get()->GetValueAsInt(value, &val);
-			valobj->Set(String::NewSymbol("value"), Integer::New(val));
+			valobj->Set(String::NewSymbol("value"), Integer::New(snapshot.m_valueAsInt));
 			break;
 		}
 		case OpenZWave::ValueID::ValueType_List: {
-			std::vector < std::string > items;
-			OpenZWave::Manager::Get()->GetValueListItems(value, &items);
+			std::vector < std::string > &items = snapshot.m_listItems;
 			Local < Array > values = Array::New(items.size());
 			for (unsigned i = 0; i < items.size(); i++) {
 				values->Set(Number::New(i), String::New(&items[i][0], items[i].size()));
 			}
 			valobj->Set(String::NewSymbol("values"), values);
-			std::string val;
-			OpenZWave::Manager::Get()->GetValueListSelection(value, &val);
-			valobj->Set(String::NewSymbol("value"), String::New(val.c_str()));
+			valobj->Set(String::NewSymbol("value"), String::New(snapshot.m_valueAsString.c_str()));
 			break;
 		}
 		case OpenZWave::ValueID::ValueType_Short: {
-			int16_t val;
-			OpenZWave::Manager::Get()->GetValueAsShort(value, &val);
-			valobj->Set(String::NewSymbol("value"), Integer::New(val));
+			valobj->Set(String::NewSymbol("value"), Integer::New(snapshot.m_valueAsShort));
 			break;
 		}
 		case OpenZWave::ValueID::ValueType_String: {
-			std::string val;
-			OpenZWave::Manager::Get()->GetValueAsString(value, &val);
-			valobj->Set(String::NewSymbol("value"), String::New(val.c_str()));
+			valobj->Set(String::NewSymbol("value"), String::New(snapshot.m_valueAsString.c_str()));
 			break;
 		}
 												   /*
@@ -597,8 +679,8 @@ namespace {
 		valobj->Set(String::NewSymbol("genre"), String::New(OpenZWave::Value::GetGenreNameFromEnum(value.GetGenre())));
 		valobj->Set(String::NewSymbol("instance"), Integer::New(value.GetInstance()));
 		valobj->Set(String::NewSymbol("index"), Integer::New(value.GetIndex()));
-		valobj->Set(String::NewSymbol("label"), String::New(OpenZWave::Manager::Get()->GetValueLabel(value).c_str()));
-		valobj->Set(String::NewSymbol("units"), String::New(OpenZWave::Manager::Get()->GetValueUnits(value).c_str()));
+		valobj->Set(String::NewSymbol("label"), String::New(OpenZWave::Manager::Get()->GetValueLabelRef(value).c_str()));
+		valobj->Set(String::NewSymbol("units"), String::New(OpenZWave::Manager::Get()->GetValueUnitsRef(value).c_str()));
 		valobj->Set(String::NewSymbol("read_only"), Boolean::New(OpenZWave::Manager::Get()->IsValueReadOnly(value))->ToBoolean());
 		valobj->Set(String::NewSymbol("write_only"), Boolean::New(OpenZWave::Manager::Get()->IsValueWriteOnly(value))->ToBoolean());
 		// XXX: verify_changes=
@@ -625,7 +707,7 @@ namespace {
 		case OpenZWave::ValueID::ValueType_Decimal: {
 			float val;
 			OpenZWave::Manager::Get()->SceneGetValueAsFloat(sceneId, value, &val);
-			valobj->Set(String::NewSymbol("value"), Integer::New(val));
+			valobj->Set(String::NewSymbol("value"), Number::New(val));
 			break;
 		}
 		case OpenZWave::ValueID::ValueType_Int: {
@@ -692,6 +774,8 @@ namespace {
 		OpenZWave::Options::Get()->AddOptionBool("SuppressValueRefresh", opts->Get(String::New("suppressrefresh"))->BooleanValue());
 		OpenZWave::Options::Get()->Lock();
 
+		zbatch = opts->Get(String::New("batchnotifications"))->BooleanValue();
+
 		return scope.Close(args.This());
 	}
 
@@ -700,6 +784,8 @@ namespace {
 
 		std::string path = (*String::Utf8Value(args[0]->ToString()));
 
+		zqueue.reserve(ZQUEUE_CAPACITY);
+		zdrain.reserve(ZQUEUE_CAPACITY);
 		uv_async_init(uv_default_loop(), &async, async_cb_handler);
 
 		context_obj = Persistent < Object > ::New(args.This());
@@ -739,56 +825,51 @@ namespace {
 		uint8_t index = args[3]->ToNumber()->Value();
 
 		NodeInfo *node;
-		std::list<OpenZWave::ValueID>::iterator vit;
+		OpenZWave::ValueID *value;
 
-		if ((node = get_node_info(nodeid))) {
-			for (vit = node->values.begin(); vit != node->values.end(); ++vit) {
-				if (((*vit).GetCommandClassId() == comclass) && ((*vit).GetInstance() == instance) && ((*vit).GetIndex() == index)) {
-
-					switch ((*vit).GetType()) {
-					case OpenZWave::ValueID::ValueType_Bool: {
-						bool val = args[4]->ToBoolean()->Value();
-						OpenZWave::Manager::Get()->SetValue(*vit, val);
-						break;
-					}
-					case OpenZWave::ValueID::ValueType_Byte: {
-						uint8_t val = args[4]->ToInteger()->Value();
-						OpenZWave::Manager::Get()->SetValue(*vit, val);
-						break;
-					}
-					case OpenZWave::ValueID::ValueType_Decimal: {
-						float val = args[4]->ToNumber()->NumberValue();
-						OpenZWave::Manager::Get()->SetValue(*vit, val);
-						break;
-					}
-					case OpenZWave::ValueID::ValueType_Int: {
-						int32_t val = args[4]->ToInteger()->Value();
-						OpenZWave::Manager::Get()->SetValue(*vit, val);
-						break;
-					}
-					case OpenZWave::ValueID::ValueType_List: {
-						std::string val = (*String::Utf8Value(args[4]->ToString()));
-						OpenZWave::Manager::Get()->SetValue(*vit, val);
-						break;
-					}
-					case OpenZWave::ValueID::ValueType_Short: {
-						int16_t val = args[4]->ToInteger()->Value();
-						OpenZWave::Manager::Get()->SetValue(*vit, val);
-						break;
-					}
-					case OpenZWave::ValueID::ValueType_String: {
-						std::string val = (*String::Utf8Value(args[4]->ToString()));
-						OpenZWave::Manager::Get()->SetValue(*vit, val);
-						break;
-					}
-					case OpenZWave::ValueID::ValueType_Schedule: {
-						break;
-					}
-					case OpenZWave::ValueID::ValueType_Button: {
-						break;
-					}
-					}
-				}
+		if ((node = get_node_info(nodeid)) && (value = get_value_info(node, comclass, instance, index))) {
+			switch (value->GetType()) {
+			case OpenZWave::ValueID::ValueType_Bool: {
+				bool val = args[4]->ToBoolean()->Value();
+				OpenZWave::Manager::Get()->SetValue(*value, val);
+				break;
+			}
+			case OpenZWave::ValueID::ValueType_Byte: {
+				uint8_t val = args[4]->ToInteger()->Value();
+				OpenZWave::Manager::Get()->SetValue(*value, val);
+				break;
+			}
+			case OpenZWave::ValueID::ValueType_Decimal: {
+				float val = args[4]->ToNumber()->NumberValue();
+				OpenZWave::Manager::Get()->SetValue(*value, val);
+				break;
+			}
+			case OpenZWave::ValueID::ValueType_Int: {
+				int32_t val = args[4]->ToInteger()->Value();
+				OpenZWave::Manager::Get()->SetValue(*value, val);
+				break;
+			}
+			case OpenZWave::ValueID::ValueType_List: {
+				std::string val = (*String::Utf8Value(args[4]->ToString()));
+				OpenZWave::Manager::Get()->SetValue(*value, val);
+				break;
+			}
+			case OpenZWave::ValueID::ValueType_Short: {
+				int16_t val = args[4]->ToInteger()->Value();
+				OpenZWave::Manager::Get()->SetValue(*value, val);
+				break;
+			}
+			case OpenZWave::ValueID::ValueType_String: {
+				std::string val = (*String::Utf8Value(args[4]->ToString()));
+				OpenZWave::Manager::Get()->SetValue(*value, val);
+				break;
+			}
+			case OpenZWave::ValueID::ValueType_Schedule: {
+				break;
+			}
+			case OpenZWave::ValueID::ValueType_Button: {
+				break;
+			}
 			}
 		}
 
@@ -824,23 +905,23 @@ namespace {
 	}
 
 	/*
-	* Enable/Disable polling on a COMMAND_CLASS basis.
+	* Enable/Disable polling on a COMMAND_CLASS basis.  An optional third
+	* argument polls the class at its own interval, in milliseconds.
 	*/
 	Handle<Value> OZW::EnablePoll(const Arguments& args) {
 		HandleScope scope;
 
 		uint8_t nodeid = args[0]->ToNumber()->Value();
 		uint8_t comclass = args[1]->ToNumber()->Value();
+		int32_t interval = args.Length() > 2 ? args[2]->ToInt32()->Value() : 0;
 		NodeInfo *node;
-		std::list<OpenZWave::ValueID>::iterator vit;
+		OpenZWave::ValueID *value;
 
-		if ((node = get_node_info(nodeid))) {
-			for (vit = node->values.begin(); vit != node->values.end(); ++vit) {
-				if ((*vit).GetCommandClassId() == comclass) {
-					OpenZWave::Manager::Get()->EnablePoll((*vit), 1);
-					break;
-				}
-			}
+		if ((node = get_node_info(nodeid)) && (value = get_class_value_info(node, comclass))) {
+			if (interval > 0)
+				OpenZWave::Manager::Get()->EnablePollInterval(*value, interval);
+			else
+				OpenZWave::Manager::Get()->EnablePoll(*value, 1);
 		}
 
 		return scope.Close(Undefined());
@@ -852,15 +933,10 @@ namespace {
 		uint8_t nodeid = args[0]->ToNumber()->Value();
 		uint8_t comclass = args[1]->ToNumber()->Value();
 		NodeInfo *node;
-		std::list<OpenZWave::ValueID>::iterator vit;
+		OpenZWave::ValueID *value;
 
-		if ((node = get_node_info(nodeid))) {
-			for (vit = node->values.begin(); vit != node->values.end(); ++vit) {
-				if ((*vit).GetCommandClassId() == comclass) {
-					OpenZWave::Manager::Get()->DisablePoll((*vit));
-					break;
-				}
-			}
+		if ((node = get_node_info(nodeid)) && (value = get_class_value_info(node, comclass))) {
+			OpenZWave::Manager::Get()->DisablePoll(*value);
 		}
 
 		return scope.Close(Undefined());
@@ -998,63 +1074,58 @@ namespace {
 		uint8_t index = args[4]->ToNumber()->Value();
 
 		NodeInfo *node;
-		std::list<OpenZWave::ValueID>::iterator vit;
-
-		if ((node = get_node_info(nodeid))) {
-			for (vit = node->values.begin(); vit != node->values.end(); ++vit) {
-				if (((*vit).GetCommandClassId() == comclass) && ((*vit).GetInstance() == instance) && ((*vit).GetIndex() == index)) {
-
-					switch ((*vit).GetType()) {
-					case OpenZWave::ValueID::ValueType_Bool: {
-						//bool val; OpenZWave::Manager::Get()->GetValueAsBool(*vit, &val);
-						bool val = args[5]->ToBoolean()->Value();
-						OpenZWave::Manager::Get()->AddSceneValue(sceneid, *vit, val);
-						break;
-					}
-					case OpenZWave::ValueID::ValueType_Byte: {
-						//uint8_t val; OpenZWave::Manager::Get()->GetValueAsByte(*vit, &val);
-						uint8_t val = args[5]->ToInteger()->Value();
-						OpenZWave::Manager::Get()->AddSceneValue(sceneid, *vit, val);
-						break;
-					}
-					case OpenZWave::ValueID::ValueType_Decimal: {
-						//float val; OpenZWave::Manager::Get()->GetValueAsFloat(*vit, &val);
-						float val = args[5]->ToNumber()->NumberValue();
-						OpenZWave::Manager::Get()->AddSceneValue(sceneid, *vit, val);
-						break;
-					}
-					case OpenZWave::ValueID::ValueType_Int: {
-						//int32_t val; OpenZWave::Manager::Get()->GetValueAsInt(*vit, &val);
-						int32_t val = args[5]->ToInteger()->Value();
-						OpenZWave::Manager::Get()->AddSceneValue(sceneid, *vit, val);
-						break;
-					}
-					case OpenZWave::ValueID::ValueType_List: {
-						//std::string val; OpenZWave::Manager::Get()->GetValueListSelection(*vit, &val);
-						std::string val = (*String::Utf8Value(args[5]->ToString()));
-						OpenZWave::Manager::Get()->AddSceneValue(sceneid, *vit, val);
-						break;
-					}
-					case OpenZWave::ValueID::ValueType_Short: {
-						//int16_t val; OpenZWave::Manager::Get()->GetValueAsShort(*vit, &val);
-						int16_t val = args[5]->ToInteger()->Value();
-						OpenZWave::Manager::Get()->AddSceneValue(sceneid, *vit, val);
-						break;
-					}
-					case OpenZWave::ValueID::ValueType_String: {
-						//std::string val; OpenZWave::Manager::Get()->GetValueAsString(*vit, &val);
-						std::string val = (*String::Utf8Value(args[5]->ToString()));
-						OpenZWave::Manager::Get()->AddSceneValue(sceneid, *vit, val);
-						break;
-					}
-					case OpenZWave::ValueID::ValueType_Schedule: {
-						break;
-					}
-					case OpenZWave::ValueID::ValueType_Button: {
-						break;
-					}
-					}
-				}
+		OpenZWave::ValueID *value;
+
+		if ((node = get_node_info(nodeid)) && (value = get_value_info(node, comclass, instance, index))) {
+			switch (value->GetType()) {
+			case OpenZWave::ValueID::ValueType_Bool: {
+				//bool val; OpenZWave::Manager::Get()->GetValueAsBool(*value, &val);
+				bool val = args[5]->ToBoolean()->Value();
+				OpenZWave::Manager::Get()->AddSceneValue(sceneid, *value, val);
+				break;
+			}
+			case OpenZWave::ValueID::ValueType_Byte: {
+				//uint8_t val; OpenZWave::Manager::Get()->GetValueAsByte(*value, &val);
+				uint8_t val = args[5]->ToInteger()->Value();
+				OpenZWave::Manager::Get()->AddSceneValue(sceneid, *value, val);
+				break;
+			}
+			case OpenZWave::ValueID::ValueType_Decimal: {
+				//float val; OpenZWave::Manager::Get()->GetValueAsFloat(*value, &val);
+				float val = args[5]->ToNumber()->NumberValue();
+				OpenZWave::Manager::Get()->AddSceneValue(sceneid, *value, val);
+				break;
+			}
+			case OpenZWave::ValueID::ValueType_Int: {
+				//int32_t val; OpenZWave::Manager::Get()->GetValueAsInt(*value, &val);
+				int32_t val = args[5]->ToInteger()->Value();
+				OpenZWave::Manager::Get()->AddSceneValue(sceneid, *value, val);
+				break;
+			}
+			case OpenZWave::ValueID::ValueType_List: {
+				//std::string val; OpenZWave::Manager::Get()->GetValueListSelection(*value, &val);
+				std::string val = (*String::Utf8Value(args[5]->ToString()));
+				OpenZWave::Manager::Get()->AddSceneValue(sceneid, *value, val);
+				break;
+			}
+			case OpenZWave::ValueID::ValueType_Short: {
+				//int16_t val; OpenZWave::Manager::Get()->GetValueAsShort(*value, &val);
+				int16_t val = args[5]->ToInteger()->Value();
+				OpenZWave::Manager::Get()->AddSceneValue(sceneid, *value, val);
+				break;
+			}
+			case OpenZWave::ValueID::ValueType_String: {
+				//std::string val; OpenZWave::Manager::Get()->GetValueAsString(*value, &val);
+				std::string val = (*String::Utf8Value(args[5]->ToString()));
+				OpenZWave::Manager::Get()->AddSceneValue(sceneid, *value, val);
+				break;
+			}
+			case OpenZWave::ValueID::ValueType_Schedule: {
+				break;
+			}
+			case OpenZWave::ValueID::ValueType_Button: {
+				break;
+			}
 			}
 		}
 